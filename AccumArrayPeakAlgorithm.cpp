@@ -15,6 +15,7 @@
 #include "TH1F.h"
 #include "TLine.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <sstream>
@@ -32,6 +33,8 @@ AccumArrayPeakAlgorithm::AccumArrayPeakAlgorithm( const std::string& algorithmNa
    m_sigmaFactor = 1;
    m_maxNumPeaks = 10;
    m_peakWidthSurfFrac = 0.1;
+   m_maxDirectFilterSize = 101;
+   m_filterTruncation = 1e-12;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -140,10 +143,38 @@ RealVector AccumArrayPeakAlgorithm::calculateSmoothedData( const Math::RegularAc
       ++nSamples;
    }
 
-   Math::SampledMovingAverage movAvg( Math::SampledMovingAverage::createGaussianFilter( nSamples, nSamples * m_sigmaFactor ) );
+   const RealVector& filter = truncateFilter( Math::SampledMovingAverage::createGaussianFilter( nSamples, nSamples * m_sigmaFactor ) );
+
+   /// Small filters are applied directly, large filters (i.e. large accumulation arrays) by FFT.
+   Math::SampledMovingAverage movAvg( filter );
+   movAvg.setFftCrossover( m_maxDirectFilterSize );
    return movAvg.calculate( data.getAllBinContents() );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// truncateFilter
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RealVector AccumArrayPeakAlgorithm::truncateFilter( const RealVector& filter ) const
+{
+   /// Drop the (symmetric) tails of the filter where the weights are negligible. The filter remains odd-sized and the
+   /// outermost samples that are kept are negligible too (the last sample is not used by the moving average).
+   const size_t nSamplesOneSide = ( filter.size() - 1 ) / 2;
+   const double minWeight = m_filterTruncation * Utils::getMaxValue( filter );
+
+   size_t nKeepOneSide = nSamplesOneSide;
+   while ( nKeepOneSide > 1 && filter[ nSamplesOneSide - ( nKeepOneSide - 1 ) ] < minWeight
+                            && filter[ nSamplesOneSide + ( nKeepOneSide - 1 ) ] < minWeight )
+   {
+      --nKeepOneSide;
+   }
+
+   if ( nKeepOneSide == nSamplesOneSide )
+   {
+      return filter;
+   }
+   return Utils::selectContiguous( filter, nSamplesOneSide - nKeepOneSide, 2 * nKeepOneSide + 1 );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// setDoMonitor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -21,6 +21,7 @@ class AccumArrayPeakAlgorithm : public AlgorithmBase
 
    private:
       RealVector calculateSmoothedData( const Math::RegularAccumArray& data ) const;
+      RealVector truncateFilter( const RealVector& filter ) const;
       RealVector subtractBaseline( const RealVector& smoothedData, const RealVector& originalData ) const;
 
       std::vector< Feature::Peak > findPeaks( const RealVector& baselineSubtractedData, const Math::RegularAccumArray& data ) const;
@@ -32,6 +33,8 @@ class AccumArrayPeakAlgorithm : public AlgorithmBase
       double         m_peakWidthSurfFrac;
       bool           m_doMonitor;
       size_t         m_maxNumPeaks;
+      size_t         m_maxDirectFilterSize;   //! Above this number of filter samples, smoothing is done by FFT.
+      double         m_filterTruncation;      //! Filter samples below this fraction of the maximum are dropped.
 };
 
 } /// FeatureAlgorithm
@@ -1,5 +1,6 @@
 #include "AdditiveSynthesizer.h"
 
+#include <cassert>
 #include <cmath>
 
 #include <iostream>
@@ -24,41 +25,39 @@ AdditiveSynthesizer::HarmonicInfo::HarmonicInfo( double phaseStep, double phase,
 /// constructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 AdditiveSynthesizer::AdditiveSynthesizer( const SamplingInfo& samplingInfo ) :
-   IGenerator( samplingInfo )
+   IGenerator( samplingInfo ),
+   m_bankFrequency( 0 ),
+   m_bankSamplingRate( 0 ),
+   m_bankPhase( 0 )
 {
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// generate
+/// render
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-RawPcmData::Ptr AdditiveSynthesizer::generate( size_t length )
+void AdditiveSynthesizer::render( double* buffer, size_t numSamples )
 {
-   RawPcmData* result = new RawPcmData( getSamplingInfo(), length );
-
-   const std::vector< HarmonicInfo >& harmonicsInfo = getHarmonicsInfo();
-   assert( harmonicsInfo.size() > 0 );
-
-   std::vector< double > phase( harmonicsInfo.size() );
-   for ( size_t iHarmonic = 0; iHarmonic < harmonicsInfo.size(); ++iHarmonic )
+   if ( m_oscillatorBank.getNumOscillators() == 0 || getFrequency() != m_bankFrequency ||
+        getSamplingInfo().getSamplingRate() != m_bankSamplingRate || getPhase() != m_bankPhase )
    {
-      phase[ iHarmonic ] = harmonicsInfo[ iHarmonic ].getPhase();
-   }
+      const std::vector< HarmonicInfo >& harmonicsInfo = getHarmonicsInfo();
+      assert( harmonicsInfo.size() > 0 );
 
-   for ( size_t iSample = 0; iSample < length; ++iSample )
-   {
-      double val = 0;
+      m_oscillatorBank.clear();
       for ( size_t iHarmonic = 0; iHarmonic < harmonicsInfo.size(); ++iHarmonic )
       {
-         phase[ iHarmonic ] += harmonicsInfo[ iHarmonic ].getPhaseStep();
-         val += harmonicsInfo[ iHarmonic ].getAmplitude() * sin( phase[ iHarmonic ] );
+         const HarmonicInfo& info = harmonicsInfo[ iHarmonic ];
+         m_oscillatorBank.addOscillator( info.getPhaseStep(), info.getPhase(), info.getAmplitude() );
       }
-      (*result)[ iSample ] = val * getCurrentSampleAmplitude();
-      nextSample();
+      m_bankFrequency = getFrequency();
+      m_bankSamplingRate = getSamplingInfo().getSamplingRate();
    }
 
-   setPhase( fmod( phase[ 0 ], 2 * M_PI ) );
+   m_oscillatorBank.render( buffer, numSamples );
+   applyEnvelope( buffer, numSamples );
 
-   return RawPcmData::Ptr( result );
+   m_bankPhase = m_oscillatorBank.getPhase( 0 );
+   setPhase( m_bankPhase );
 }
 
 } /// namespace Synthesizer
@@ -2,6 +2,7 @@
 #define ADDITIVESYNTHESIZER_H
 
 #include "IGenerator.h"
+#include "OscillatorBank.h"
 
 namespace Synthesizer
 {
@@ -18,9 +19,10 @@ class AdditiveSynthesizer : public IGenerator
        */
       AdditiveSynthesizer( const SamplingInfo& samplingInfo );
       /**
-       * Generate the data. Do not override this method.
+       * Render the data (@see IGenerator). Do not override this method.
+       * The oscillator bank is only rebuilt when the frequency or the phase has been changed since the last call.
        */
-      RawPcmData::Ptr generate( size_t length ) final;
+      void render( double* buffer, size_t numSamples ) final;
 
    protected:
       /**
@@ -57,6 +59,12 @@ class AdditiveSynthesizer : public IGenerator
        */
       virtual std::vector< HarmonicInfo > getHarmonicsInfo() const = 0;
 
+   private:
+      OscillatorBank    m_oscillatorBank;       //! Oscillators of the harmonics, carried over between render calls.
+      double            m_bankFrequency;        //! Frequency for which the oscillator bank was built.
+      double            m_bankSamplingRate;     //! Sampling rate for which the oscillator bank was built.
+      double            m_bankPhase;            //! Phase of the fundamental after the last render call.
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1,9 +1,21 @@
 #include "AdsrEnvelope.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace Synthesizer {
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Segment constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+AdsrEnvelope::Segment::Segment( size_t end, Type type, double origin, double level, double slope ) :
+   m_end( end ),
+   m_type( type ),
+   m_origin( origin ),
+   m_level( level ),
+   m_slope( slope )
+{}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// constructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -89,7 +101,8 @@ void AdsrEnvelope::setSustain( double sustain )
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void AdsrEnvelope::setSustainLevel( double sustainLevel )
 {
-   m_sustain = sustainLevel;
+   m_sustainLevel = sustainLevel;
+   updateDerivedQuantities();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -98,6 +111,7 @@ void AdsrEnvelope::setSustainLevel( double sustainLevel )
 void AdsrEnvelope::setRelease( double release )
 {
    m_release = release;
+   updateDerivedQuantities();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -107,6 +121,41 @@ void AdsrEnvelope::updateDerivedQuantities()
 {
    m_decayEnd = m_attack + m_decay;
    m_sustainEnd = m_decayEnd + m_sustain;
+
+   /// Segment boundaries are the first integer sample index not in the segment, consistent with getEnvelope.
+   const size_t infinity = static_cast< size_t >( -1 );
+   m_segments.clear();
+   size_t end = 0;
+   if ( m_attack > 1 )
+   {
+      end = static_cast< size_t >( ceil( m_attack ) );
+      m_segments.push_back( Segment( end, Segment::Linear, 0, 0, 1 / m_attack ) );
+   }
+   if ( m_decay > 1 && m_decayEnd > end )
+   {
+      end = static_cast< size_t >( ceil( m_decayEnd ) );
+      m_segments.push_back( Segment( end, Segment::Linear, m_attack, 1, ( m_sustainLevel - 1 ) / m_decay ) );
+   }
+   if ( m_sustain < 0 )
+   {
+      m_segments.push_back( Segment( infinity, Segment::Constant, 0, m_sustainLevel, 0 ) );
+   }
+   else
+   {
+      if ( m_sustainEnd > end )
+      {
+         end = static_cast< size_t >( ceil( m_sustainEnd ) );
+         m_segments.push_back( Segment( end, Segment::Constant, 0, m_sustainLevel, 0 ) );
+      }
+      m_segments.push_back( Segment( infinity, Segment::Exponential, m_sustainEnd, m_sustainLevel, 0 ) );
+   }
+
+   /// The exponential ramp is applied in chunks, with one multiplication per chunk to advance it.
+   for ( size_t i = 0; i < s_rampChunkSize; ++i )
+   {
+      m_releaseRamp[ i ] = m_release > 0 ? exp( -( i / m_release ) ) : 0;
+   }
+   m_releaseStep = m_release > 0 ? exp( -( s_rampChunkSize / m_release ) ) : 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -137,4 +186,73 @@ double AdsrEnvelope::getEnvelope( size_t iSample ) const
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// fillEnvelope
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AdsrEnvelope::fillEnvelope( size_t firstSample, size_t numSamples, double* result ) const
+{
+   std::fill( result, result + numSamples, 1.0 );
+   applyEnvelope( firstSample, numSamples, 1, result );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// applyEnvelope
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void AdsrEnvelope::applyEnvelope( size_t firstSample, size_t numSamples, double gain, double* buffer ) const
+{
+   const size_t endSample = firstSample + numSamples;
+   size_t iSegment = 0;
+   while ( m_segments[ iSegment ].m_end <= firstSample )
+   {
+      ++iSegment;
+   }
+
+   for ( size_t iSample = firstSample; iSample < endSample; ++iSegment )
+   {
+      const Segment& segment = m_segments[ iSegment ];
+      double* segmentBuffer = buffer + ( iSample - firstSample );
+      const size_t n = std::min( segment.m_end, endSample ) - iSample;
+
+      if ( segment.m_type == Segment::Constant )
+      {
+         /// A constant segment at unit gain costs nothing.
+         const double level = gain * segment.m_level;
+         if ( level != 1 )
+         {
+            for ( size_t i = 0; i < n; ++i )
+            {
+               segmentBuffer[ i ] *= level;
+            }
+         }
+      }
+      else if ( segment.m_type == Segment::Linear )
+      {
+         const double start = gain * ( segment.m_level + segment.m_slope * ( iSample - segment.m_origin ) );
+         const double slope = gain * segment.m_slope;
+         for ( size_t i = 0; i < n; ++i )
+         {
+            segmentBuffer[ i ] *= start + slope * i;
+         }
+      }
+      else
+      {
+         double level = m_release > 0 ? gain * segment.m_level * exp( -( ( iSample - segment.m_origin ) / m_release ) ) : 0;
+         size_t i = 0;
+         for ( ; i + s_rampChunkSize <= n; i += s_rampChunkSize )
+         {
+            for ( size_t j = 0; j < s_rampChunkSize; ++j )
+            {
+               segmentBuffer[ i + j ] *= level * m_releaseRamp[ j ];
+            }
+            level *= m_releaseStep;
+         }
+         for ( size_t j = 0; i + j < n; ++j )
+         {
+            segmentBuffer[ i + j ] *= level * m_releaseRamp[ j ];
+         }
+      }
+      iSample += n;
+   }
+}
+
 } /// namespace Synthesizer
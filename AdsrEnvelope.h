@@ -4,6 +4,7 @@
 #include "ISynthEnvelope.h"
 
 #include <stddef.h>
+#include <vector>
 
 namespace Synthesizer {
 
@@ -11,6 +12,9 @@ namespace Synthesizer {
  * @class AdsrEnvelope
  * @brief Class describing an Attack, Decay, Sustain, Release envelope.
  * @see constructor for details
+ *
+ * The envelope is stored as a list of segments (linear ramps, a constant and an exponential tail) whose boundaries
+ * are computed when the parameters change, so that applyEnvelope only has to apply a few ramps per block.
  */
 class AdsrEnvelope : public ISynthEnvelope
 {
@@ -48,6 +52,35 @@ class AdsrEnvelope : public ISynthEnvelope
        * @param sample: the sample index. The sample index starts at zero for a newly struck tone.
        */
       double getEnvelope( size_t sample ) const;
+      /**
+       * Block versions of getEnvelope, evaluated per segment (@see ISynthEnvelope).
+       */
+      void fillEnvelope( size_t firstSample, size_t numSamples, double* result ) const;
+      void applyEnvelope( size_t firstSample, size_t numSamples, double gain, double* buffer ) const;
+
+   private:
+      /**
+       * @class Segment
+       * @brief Part of the envelope with a single functional form.
+       */
+      class Segment
+      {
+         public:
+            enum Type
+            {
+               Constant,      //! m_level
+               Linear,        //! m_level + m_slope * ( iSample - m_origin )
+               Exponential    //! m_level * exp( -( iSample - m_origin ) / m_release )
+            };
+
+            Segment( size_t end, Type type, double origin, double level, double slope );
+
+            size_t      m_end;      //! Sample after the last sample of the segment.
+            Type        m_type;     //! Functional form.
+            double      m_origin;   //! Sample at which the segment reaches m_level.
+            double      m_level;    //! Level at m_origin.
+            double      m_slope;    //! Slope of a linear segment.
+      };
 
    private:
       /**
@@ -65,6 +98,12 @@ class AdsrEnvelope : public ISynthEnvelope
 
       double         m_decayEnd;       //! the number of samples from start of note until sustain sets in
       double         m_sustainEnd;     //! the number of samples from start of note until release sets in
+
+      static const size_t     s_rampChunkSize = 8;                 //! number of samples per step of the release ramp
+
+      std::vector< Segment >  m_segments;                         //! the segments in order, the last one is infinite
+      double                  m_releaseRamp[ s_rampChunkSize ];   //! the release factor after 0 .. s_rampChunkSize - 1 samples
+      double                  m_releaseStep;                      //! the release factor after s_rampChunkSize samples
 };
 
 } /// namespce Synthesizer
@@ -0,0 +1,57 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/// Anonymous namespace
+namespace
+{
+   std::atomic< size_t > numAllocations( 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumAllocations
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t AllocationCounter::getNumAllocations()
+{
+   return numAllocations.load( std::memory_order_relaxed );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// operator new
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * Replacement of the global operator new that counts the allocations. Like the default, it calls the installed
+ * new-handler until the allocation succeeds, and throws std::bad_alloc if there is none. The default array and nothrow
+ * forms call it.
+ */
+void* operator new( std::size_t size )
+{
+   numAllocations.fetch_add( 1, std::memory_order_relaxed );
+   if ( size == 0 )
+   {
+      size = 1;
+   }
+   while ( true )
+   {
+      if ( void* memory = std::malloc( size ) )
+      {
+         return memory;
+      }
+      std::new_handler handler = std::get_new_handler();
+      if ( !handler )
+      {
+         throw std::bad_alloc();
+      }
+      handler();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// operator delete
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void operator delete( void* memory ) noexcept
+{
+   std::free( memory );
+}
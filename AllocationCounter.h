@@ -0,0 +1,20 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+
+/**
+ * @class AllocationCounter
+ * @brief Counts the calls of the global operator new, which AllocationCounter.cpp replaces for the whole program.
+ * Only linked into builds with CONFIG+=count_allocations, for the allocation counts of the DevSuite benchmarks.
+ */
+class AllocationCounter
+{
+   public:
+      /**
+       * Get the number of calls of the global operator new so far.
+       */
+      static size_t getNumAllocations();
+};
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,85 @@
+#ifndef AUTODIFFFITFUNCTION_H
+#define AUTODIFFFITFUNCTION_H
+
+#include "Dual.h"
+#include "FitFunctionBase.h"
+
+namespace Math
+{
+
+/**
+ * @class AutoDiffFitFunction
+ * @brief Base class for fit functions with a fixed number of parameters whose parameter gradient is calculated with
+ * forward-mode automatic differentiation.
+ *
+ * The Derived class implements the function once, as a template on the number type:
+ *
+ *    template < class T > T evaluate( double x, const T* parameters ) const;
+ *
+ * It is instantiated with double for operator() and with Dual< NumParameters > for evalWithParameterGradient, which
+ * gives the value and all parameter derivatives in one pass. Elementary functions should be called unqualified (exp,
+ * not std::exp), so that the Dual overloads are found.
+ */
+template < class Derived, size_t NumParameters >
+class AutoDiffFitFunction : public FitFunctionBase
+{
+   public:
+      /**
+       * Constructor.
+       */
+      AutoDiffFitFunction() :
+         FitFunctionBase( NumParameters )
+      {}
+
+      /**
+       * Defined in @see FitFunctionBase.
+       */
+      double operator()( double x ) const
+      {
+         return derived().evaluate( x, getParameters().data() );
+      }
+      /**
+       * Defined in @see FitFunctionBase.
+       */
+      bool hasParameterGradient() const
+      {
+         return true;
+      }
+      /**
+       * Defined in @see FitFunctionBase.
+       */
+      double evalWithParameterGradient( double x, double* parGradient ) const
+      {
+         Dual< NumParameters > parameters[ NumParameters ];
+         for ( size_t i = 0; i < NumParameters; ++i )
+         {
+            parameters[ i ] = Dual< NumParameters >::variable( par( i ), i );
+         }
+         const Dual< NumParameters > result = derived().evaluate( x, static_cast< const Dual< NumParameters >* >( parameters ) );
+         for ( size_t i = 0; i < NumParameters; ++i )
+         {
+            parGradient[ i ] = result.getDerivative( i );
+         }
+         return result.getValue();
+      }
+      /**
+       * Defined in @see IRealFunction.
+       */
+      IRealFunction* clone() const
+      {
+         return new Derived( derived() );
+      }
+
+   private:
+      /**
+       * Get the derived object.
+       */
+      const Derived& derived() const
+      {
+         return static_cast< const Derived& >( *this );
+      }
+};
+
+} /// namespace Math
+
+#endif // AUTODIFFFITFUNCTION_H
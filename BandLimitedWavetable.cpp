@@ -0,0 +1,145 @@
+#include "BandLimitedWavetable.h"
+
+#include "FftwAlgorithm.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <memory>
+
+namespace Synthesizer
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+BandLimitedWavetable::BandLimitedWavetable( const RealVector& harmonicAmplitudes )
+{
+   assert( harmonicAmplitudes.size() > 0 );
+
+   /// Levels are at most a semitone apart: the harmonics that a level lacks with respect to the Nyquist frequency lie in
+   /// the top semitone below it. Below 17 harmonics a semitone is less than one harmonic, so every count gets a level.
+   const double semitone = pow( 2, 1 / 12. );
+   std::unique_ptr< WaveAnalysis::FftwAlgorithm > fftw;
+   size_t numHarmonics = 1;
+   while ( true )
+   {
+      /// Power of two table size, so that wrapping is a bit mask.
+      size_t tableSize = getMinTableSize();
+      while ( tableSize < 16 * numHarmonics )
+      {
+         tableSize *= 2;
+      }
+      if ( !fftw || fftw->getFourierSize() != tableSize )
+      {
+         fftw.reset( new WaveAnalysis::FftwAlgorithm( tableSize ) );
+      }
+
+      /// The unnormalised inverse transform of X_h = -i A_h / 2 is sum_h A_h sin( 2 pi h j / N ).
+      Complex* fourierData = fftw->getFourierDataWorkingArray();
+      std::fill( fourierData, fourierData + fftw->getSpectrumDimension(), Complex( 0, 0 ) );
+      for ( size_t iHarmonic = 1; iHarmonic <= numHarmonics; ++iHarmonic )
+      {
+         fourierData[ iHarmonic ] = Complex( 0, -0.5 * harmonicAmplitudes[ iHarmonic - 1 ] );
+      }
+      fftw->reverseTransform();
+
+      const double* timeData = fftw->getTimeDataWorkingArray();
+      RealVector table( tableSize + 3 );
+      std::copy( timeData, timeData + tableSize, table.begin() + 1 );
+      table[ 0 ] = timeData[ tableSize - 1 ];
+      table[ tableSize + 1 ] = timeData[ 0 ];
+      table[ tableSize + 2 ] = timeData[ 1 ];
+
+      m_tables.push_back( table );
+      m_numHarmonics.push_back( numHarmonics );
+
+      if ( numHarmonics >= harmonicAmplitudes.size() )
+      {
+         break;
+      }
+      numHarmonics = std::max( numHarmonics + 1, static_cast< size_t >( numHarmonics * semitone ) );
+      numHarmonics = std::min( numHarmonics, harmonicAmplitudes.size() );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumLevels
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t BandLimitedWavetable::getNumLevels() const
+{
+   return m_tables.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumHarmonics
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t BandLimitedWavetable::getNumHarmonics( size_t iLevel ) const
+{
+   return m_numHarmonics[ iLevel ];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// selectLevel
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t BandLimitedWavetable::selectLevel( double phaseStep ) const
+{
+   /// Harmonic h is below the Nyquist frequency if h * phaseStep < pi; take the last level with only such harmonics.
+   const std::vector< size_t >::const_iterator itFirstAliased = std::lower_bound( m_numHarmonics.begin(), m_numHarmonics.end(), M_PI / phaseStep );
+   if ( itFirstAliased == m_numHarmonics.begin() )
+   {
+      return getNumLevels();
+   }
+   return itFirstAliased - m_numHarmonics.begin() - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// render
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void BandLimitedWavetable::render( double phase, double phaseStep, double* result, size_t numSamples ) const
+{
+   const size_t iLevel = selectLevel( phaseStep );
+   if ( iLevel >= getNumLevels() )
+   {
+      std::fill( result, result + numSamples, 0.0 );
+      return;
+   }
+
+   const RealVector& table = m_tables[ iLevel ];
+   const size_t tableSize = table.size() - 3;
+   const size_t mask = tableSize - 1;
+   const double* values = table.data();
+
+   /// Positions in units of table samples; the table size is a power of two, so wrapping is a bit mask.
+   const double scale = tableSize / ( 2 * M_PI );
+   double startPos = fmod( phase * scale, static_cast< double >( tableSize ) );
+   if ( startPos < 0 )
+   {
+      startPos += tableSize;
+   }
+   const double step = phaseStep * scale;
+
+   for ( size_t iSample = 0; iSample < numSamples; ++iSample )
+   {
+      const double pos = startPos + ( iSample + 1 ) * step;
+      const size_t iPos = static_cast< size_t >( pos );
+      const double frac = pos - iPos;
+      const double* p = values + ( iPos & mask );
+
+      /// Cubic Hermite (Catmull-Rom) interpolation between p[ 1 ] and p[ 2 ].
+      const double c1 = 0.5 * ( p[ 2 ] - p[ 0 ] );
+      const double c2 = p[ 0 ] - 2.5 * p[ 1 ] + 2 * p[ 2 ] - 0.5 * p[ 3 ];
+      const double c3 = 0.5 * ( p[ 3 ] - p[ 0 ] ) + 1.5 * ( p[ 1 ] - p[ 2 ] );
+      result[ iSample ] = ( ( c3 * frac + c2 ) * frac + c1 ) * frac + p[ 1 ];
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getMinTableSize
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t BandLimitedWavetable::getMinTableSize()
+{
+   return 2048;
+}
+
+} /// namespace Synthesizer
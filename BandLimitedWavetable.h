@@ -0,0 +1,71 @@
+#ifndef BANDLIMITEDWAVETABLE_H
+#define BANDLIMITEDWAVETABLE_H
+
+#include "RealVector.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Synthesizer
+{
+
+/**
+ * @class BandLimitedWavetable
+ * @brief Mip-mapped wavetable of a periodic waveform, with band-limited tables at most a semitone apart.
+ *
+ * The waveform is given by the amplitudes of its harmonics: w( phase ) = sum_h A_h * sin( h * phase ). Each level of the
+ * mip-map contains the harmonics h = 1 .. H_k and is filled once at construction with an inverse FFT. Up to 17
+ * harmonics, where a semitone is less than one harmonic, every count has its own level; above that, H_k grows by at
+ * most a factor 2^(1/12) per level. When rendering,
+ * the level with the most harmonics that all lie below the Nyquist frequency is selected, so the output is free of
+ * aliasing, and the table is read with cubic interpolation. The cost per sample is therefore independent of the
+ * frequency and of the number of harmonics. Because of the semitone spacing, at most the harmonics in the top semitone
+ * below the Nyquist frequency are missing (an octave spacing would drop up to half of them).
+ *
+ * The tables have at least 16 samples per period of their highest harmonic (and at least getMinTableSize() samples),
+ * which keeps the interpolation error below 1e-3 of the amplitude of the fundamental.
+ */
+class BandLimitedWavetable
+{
+   public:
+      /**
+       * Build the tables for the waveform with @param harmonicAmplitudes, where element h - 1 is the amplitude of
+       * harmonic h. The number of harmonics sets the highest level (and thereby the lowest frequency at which the
+       * waveform has all harmonics up to the Nyquist frequency).
+       */
+      BandLimitedWavetable( const RealVector& harmonicAmplitudes );
+
+      /**
+       * Get the number of levels in the mip-map.
+       */
+      size_t getNumLevels() const;
+      /**
+       * Get the number of harmonics in level @param iLevel.
+       */
+      size_t getNumHarmonics( size_t iLevel ) const;
+      /**
+       * Get the level to use for a fundamental with @param phaseStep per sample. Returns getNumLevels() if even the
+       * fundamental is at or above the Nyquist frequency.
+       */
+      size_t selectLevel( double phaseStep ) const;
+
+      /**
+       * Write @param numSamples samples of the waveform to @param result. Sample i has phase
+       * @param phase + ( i + 1 ) * @param phaseStep (@see OscillatorBank). To keep the phase accurate, @param numSamples
+       * should be limited to a few hundred; longer signals should be rendered in blocks.
+       */
+      void render( double phase, double phaseStep, double* result, size_t numSamples ) const;
+
+      /**
+       * Get the minimum number of samples in a table.
+       */
+      static size_t getMinTableSize();
+
+   private:
+      std::vector< RealVector >     m_tables;       //! Table per level, with one guard sample before and two after.
+      std::vector< size_t >         m_numHarmonics; //! Number of harmonics per level.
+};
+
+} /// namespace Synthesizer
+
+#endif // BANDLIMITEDWAVETABLE_H
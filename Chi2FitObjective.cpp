@@ -1,5 +1,8 @@
 #include "Chi2FitObjective.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace Math
 {
 
@@ -32,6 +35,62 @@ double Chi2FitObjective::evaluate( const RealVector& x ) const
    return chi2;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// evaluateBatch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RealVector Chi2FitObjective::evaluateBatch( const std::vector< RealVector >& xs ) const
+{
+   const size_t numPoints = m_xData.size();
+   RealVector funcValues( numPoints );
+
+   RealVector result( xs.size() );
+   for ( size_t i = 0; i < xs.size(); ++i )
+   {
+      m_func->setParameters( xs[ i ] );
+      for ( size_t iPoint = 0; iPoint < numPoints; ++iPoint )
+      {
+         funcValues[ iPoint ] = (*m_func)( m_xData[ iPoint ] );
+      }
+
+      double chi2 = 0;
+      for ( size_t iPoint = 0; iPoint < numPoints; ++iPoint )
+      {
+         double diff = funcValues[ iPoint ] - m_yData[ iPoint ];
+         chi2 += ( diff * diff ) / m_ySigma2[ iPoint ];
+      }
+      result[ i ] = chi2;
+   }
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calculateGradient
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RealVector Chi2FitObjective::calculateGradient( const RealVector& x, double delta ) const
+{
+   if ( !m_func->hasParameterGradient() )
+   {
+      return IObjectiveFunction::calculateGradient( x, delta );
+   }
+
+   m_func->setParameters( x );
+   const size_t numParameters = x.size();
+   m_parGradient.resize( numParameters );
+
+   /// d chi2 / dp = sum 2 * ( f(x) - y ) / sigma^2 * df(x)/dp
+   RealVector result( numParameters, 0 );
+   for ( size_t iPoint = 0; iPoint < m_xData.size(); ++iPoint )
+   {
+      double diff = m_func->evalWithParameterGradient( m_xData[ iPoint ], m_parGradient.data() ) - m_yData[ iPoint ];
+      double weight = 2 * diff / m_ySigma2[ iPoint ];
+      for ( size_t iPar = 0; iPar < numParameters; ++iPar )
+      {
+         result[ iPar ] += weight * m_parGradient[ iPar ];
+      }
+   }
+   return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// getNumParameters
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -40,4 +99,75 @@ size_t Chi2FitObjective::getNumParameters() const
    return m_func->getNumParameters();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// hasParameterGradient
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool Chi2FitObjective::hasParameterGradient() const
+{
+   return m_func->hasParameterGradient();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumPoints
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t Chi2FitObjective::getNumPoints() const
+{
+   return m_xData.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calculateResiduals
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void Chi2FitObjective::calculateResiduals( const RealVector& x, RealVector& residuals ) const
+{
+   m_func->setParameters( x );
+
+   residuals.resize( m_xData.size() );
+   for ( size_t iPoint = 0; iPoint < m_xData.size(); ++iPoint )
+   {
+      residuals[ iPoint ] = ( (*m_func)( m_xData[ iPoint ] ) - m_yData[ iPoint ] ) / sqrt( m_ySigma2[ iPoint ] );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calculateJacobian
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void Chi2FitObjective::calculateJacobian( const RealVector& x, const RealVector& residuals, RealVector& jacobian, double delta ) const
+{
+   assert( residuals.size() == m_xData.size() );
+   const size_t numParameters = x.size();
+   jacobian.resize( m_xData.size() * numParameters );
+
+   if ( m_func->hasParameterGradient() )
+   {
+      m_func->setParameters( x );
+      for ( size_t iPoint = 0; iPoint < m_xData.size(); ++iPoint )
+      {
+         double* row = &jacobian[ iPoint * numParameters ];
+         m_func->evalWithParameterGradient( m_xData[ iPoint ], row );
+         double invSigma = 1 / sqrt( m_ySigma2[ iPoint ] );
+         for ( size_t iPar = 0; iPar < numParameters; ++iPar )
+         {
+            row[ iPar ] *= invSigma;
+         }
+      }
+      return;
+   }
+
+   /// Forward differences: one column of the Jacobian per pass over the data.
+   m_parameters = x;
+   for ( size_t iPar = 0; iPar < numParameters; ++iPar )
+   {
+      double step = delta * std::max( 1.0, fabs( x[ iPar ] ) );
+      m_parameters[ iPar ] = x[ iPar ] + step;
+      m_func->setParameters( m_parameters );
+      for ( size_t iPoint = 0; iPoint < m_xData.size(); ++iPoint )
+      {
+         double shifted = ( (*m_func)( m_xData[ iPoint ] ) - m_yData[ iPoint ] ) / sqrt( m_ySigma2[ iPoint ] );
+         jacobian[ iPoint * numParameters + iPar ] = ( shifted - residuals[ iPoint ] ) / step;
+      }
+      m_parameters[ iPar ] = x[ iPar ];
+   }
+}
+
 } /// namespace Math
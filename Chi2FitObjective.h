@@ -29,17 +29,55 @@ class Chi2FitObjective : public IObjectiveFunction
        * Evaluate chi2 as function of the parameters of the fit function given in the constructor.
        */
       double evaluate( const RealVector& x ) const;
+      /**
+       * Evaluate chi2 for every parameter vector in @param xs. The function values are calculated first, so that the chi2
+       * sum is a loop over contiguous arrays; the workspace for these is local to the call. The evaluations share the fit
+       * function, so they are always sequential.
+       */
+      RealVector evaluateBatch( const std::vector< RealVector >& xs ) const;
 
       /**
        * Get the number of parameters of the fit function.
        */
       size_t getNumParameters() const;
 
+      /**
+       * Calculate the gradient of chi2 with respect to the parameters @param x. If the fit function has a parameter
+       * gradient (@see FitFunctionBase::hasParameterGradient), the gradient is exact and costs one pass over the data;
+       * otherwise it is approximated with finite differences with step @param delta.
+       */
+      RealVector calculateGradient( const RealVector& x, double delta = 1e-6 ) const;
+
+   public:
+      /**
+       * Check whether the fit function has an exact parameter gradient, so that calculateGradient and calculateJacobian
+       * are exact and take one pass over the data (@see FitFunctionBase::hasParameterGradient).
+       */
+      bool hasParameterGradient() const;
+      /**
+       * Get the number of data points, i.e. the number of residuals.
+       */
+      size_t getNumPoints() const;
+      /**
+       * Calculate the normalised residuals r_i = ( f(x_i) - y_i ) / sigma_i for the parameters @param x, so that chi2 is
+       * the sum of the r_i squared. @param residuals is resized to getNumPoints().
+       */
+      void calculateResiduals( const RealVector& x, RealVector& residuals ) const;
+      /**
+       * Calculate the Jacobian of the residuals with respect to the parameters @param x, stored row-major in @param
+       * jacobian: element ( i, j ) = dr_i/dp_j is at i * getNumParameters() + j. With an exact parameter gradient of the
+       * fit function this is one pass over the data, otherwise a forward difference with relative step @param delta,
+       * with one pass over the data per parameter on top of the given @param residuals at @param x.
+       */
+      void calculateJacobian( const RealVector& x, const RealVector& residuals, RealVector& jacobian, double delta = 1e-7 ) const;
+
    private:
       const RealVector&        m_xData;         //! x values of data set.
       const RealVector&        m_yData;         //! y values of data set.
       const RealVector&        m_ySigma2;       //! y variance squared of data set.
       mutable FitFunctionBase*    m_func;          //! function to be fitted.
+      mutable RealVector       m_parGradient;   //! Parameter gradient of the function, workspace of calculateGradient.
+      mutable RealVector       m_parameters;    //! Shifted parameters, workspace of calculateJacobian.
 };
 
 } /// namespace Math
@@ -19,10 +19,24 @@ void DevSuite::execute()
 
    // devFundamentalFreqFinder();
    // devTimeStretcher();
+   // devPhaseVocoderBenchmark();
+   // devTimeStretcherSynthesisBenchmark();
 
    // devImprovedPeakAlgorithm();
    devSidelobeRejection();
 
+   // devKernelPdfBenchmark();
+   // devOscillatorBankBenchmark();
+   // devWavetableBenchmark();
+   // devPolyphonicSynthesizerBenchmark();
+   // devRealTimeRenderer();
+
+   // devMlpBatchBenchmark();
+   // devFrozenMlpBenchmark();
+   // devRealVectorBenchmark();
+   // devLinearInterpolatorBenchmark();
+   // devSampledMovingAverageBenchmark();
+
    return;
 }
 
@@ -35,12 +49,23 @@ void DevSuite::execute()
 #include "SpectralReassignmentTransform.h"
 #include "SrSpecPeakAlgorithm.h"
 #include "RandomNumberGenerator.h"
+#include "SampledMovingAverage.h"
 #include "ApproximateGcdAlgorithm.h"
+#include "PitchSalienceAlgorithm.h"
+#include "FrozenMlp.h"
+#include "MultiLayerPerceptron.h"
+#include "PhaseVocoder.h"
+#include "PolyphonicSynthesizer.h"
+#include "RealTimeRenderer.h"
+#include "StftAlgorithm.h"
 #include "TimeStretcher.h"
+#include "FourierConfig.h"
 #include "WaveFile.h"
 #include "SineGenerator.h"
 #include "PredefinedRealFunctions.h"
 #include "KernelPdf.h"
+#include "OscillatorBank.h"
+#include "SawtoothGenerator.h"
 #include "GaussPdf.h"
 #include "LinearInterpolator.h"
 #include "WindowLocation.h"
@@ -48,6 +73,46 @@ void DevSuite::execute()
 #include "NaivePeaks.h"
 #include "Peak.h"
 
+#include <chrono>
+#include <numeric>
+#include <sstream>
+
+#ifdef COUNT_ALLOCATIONS
+#include "AllocationCounter.h"
+#endif
+
+/// Anonymous namespace
+namespace
+{
+   /**
+    * Get the number of global allocations so far, or 0 if the program is not built with CONFIG+=count_allocations.
+    */
+   size_t getNumAllocations()
+   {
+#ifdef COUNT_ALLOCATIONS
+      return AllocationCounter::getNumAllocations();
+#else
+      return 0;
+#endif
+   }
+
+   /**
+    * Describe the allocations per iteration between two counts, or nothing without allocation counting.
+    */
+   std::string describeAllocations( size_t numAllocationsBefore, size_t numAllocationsAfter, size_t numIterations )
+   {
+      std::ostringstream description;
+#ifdef COUNT_ALLOCATIONS
+      description << " and " << static_cast< double >( numAllocationsAfter - numAllocationsBefore ) / numIterations << " allocations";
+#else
+      ( void )numAllocationsBefore;
+      ( void )numAllocationsAfter;
+      ( void )numIterations;
+#endif
+      return description.str();
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// devIterateSrPeaks
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -203,6 +268,40 @@ void DevSuite::devFundamentalFreqFinder()
 
    msg << Msg::Info << "Basefrequency = " << result.gcd << Msg::EndReq;
 
+   /// Pitch salience on all spectra of a random melody.
+   std::vector< Music::Note > trueMelody;
+   RawPcmData::Ptr data = TestDataSupply::generateRandomMelody( &trueMelody );
+
+   size_t fourierSize = 4096;
+   WaveAnalysis::StftAlgorithm stftAlg( data->getSamplingInfo(), fourierSize, WaveAnalysis::HanningWindowFuncDef(), fourierSize, 4 );
+   WaveAnalysis::StftData::Ptr stftData = stftAlg.execute( *data );
+
+   FeatureAlgorithm::PitchSalienceAlgorithm salienceAlg( stftData->getConfig() );
+
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   std::vector< FeatureAlgorithm::PitchSalienceAlgorithm::CandidateList > candidates = salienceAlg.execute( *stftData );
+   double seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+   msg << Msg::Info << "Pitch salience of " << candidates.size() << " spectra took " << seconds << " s, i.e. "
+       << seconds / ( data->size() / data->getSamplingInfo().getSamplingRate() ) << " s per second of audio." << Msg::EndReq;
+
+   for ( size_t i = 0; i < trueMelody.size(); ++i )
+   {
+      msg << Msg::Info << "True note " << i << ": frequency = " << trueMelody[ i ].getFrequency() << Msg::EndReq;
+   }
+
+   RealVector hops;
+   RealVector bestFrequencies;
+   for ( size_t iHop = 0; iHop < candidates.size(); ++iHop )
+   {
+      if ( !candidates[ iHop ].empty() )
+      {
+         hops.push_back( iHop );
+         bestFrequencies.push_back( candidates[ iHop ][ 0 ].getFrequency() );
+      }
+   }
+   gPlotFactory().createPlot( "devFundamentalFreqFinder/Most salient candidate" );
+   gPlotFactory().createScatter( hops, bestFrequencies );
 }
 
 
@@ -379,3 +478,646 @@ void DevSuite::devTimeStretcher()
    // WaveFile::write( "OriginalBeforeStretch.wav", waveData );
    // WaveFile::write( "StretchedMusic.wav", waveDataStretched );
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devPhaseVocoderBenchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devPhaseVocoderBenchmark()
+{
+   Logger msg( "devPhaseVocoderBenchmark" );
+   msg << Msg::Info << "Running devPhaseVocoderBenchmark..." << Msg::EndReq;
+
+   /// Concurrent streams, each stretching a chord in blocks of 256 samples.
+   SamplingInfo samplingInfo( 44100 );
+   const size_t numStreams = 16;
+   const size_t numSamples = 44100 * 5;
+   const size_t blockSize = 256;
+   RealVector input( numSamples );
+   for ( size_t i = 0; i < numSamples; ++i )
+   {
+      input[ i ] = 0.3 * ( sin( 2 * M_PI * 220 * i / 44100 ) + sin( 2 * M_PI * 277.2 * i / 44100 ) + sin( 2 * M_PI * 329.6 * i / 44100 ) );
+   }
+
+   for ( double stretchFactor = 0.75; stretchFactor < 2.1; stretchFactor *= 2 )
+   {
+      std::vector< Music::PhaseVocoder* > streams;
+      for ( size_t iStream = 0; iStream < numStreams; ++iStream )
+      {
+         streams.push_back( new Music::PhaseVocoder( stretchFactor, samplingInfo ) );
+      }
+
+      RealVector output( 4 * blockSize );
+      auto t0 = std::chrono::high_resolution_clock::now();
+      for ( size_t iFirst = 0; iFirst + blockSize <= numSamples; iFirst += blockSize )
+      {
+         for ( size_t iStream = 0; iStream < numStreams; ++iStream )
+         {
+            streams[ iStream ]->write( &input[ iFirst ], blockSize );
+            while ( streams[ iStream ]->read( &output[ 0 ], output.size() ) > 0 ) {}
+         }
+      }
+      auto t1 = std::chrono::high_resolution_clock::now();
+      double seconds = std::chrono::duration< double >( t1 - t0 ).count();
+
+      msg << Msg::Info << numStreams << " streams, stretch factor " << stretchFactor << ": " << seconds << " s for "
+          << numSamples / 44100.0 << " s of input, real-time factor " << numSamples / 44100.0 / seconds
+          << ", latency " << streams[ 0 ]->getLatency() * 1e3 << " ms" << Msg::EndReq;
+
+      Utils::cleanupVector( streams );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devTimeStretcherSynthesisBenchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devTimeStretcherSynthesisBenchmark()
+{
+   Logger msg( "devTimeStretcherSynthesisBenchmark" );
+   msg << Msg::Info << "Running devTimeStretcherSynthesisBenchmark..." << Msg::EndReq;
+
+   SamplingInfo samplingInfo( 44100 );
+   WaveAnalysis::FourierConfig fourierConfig( samplingInfo, 2048 );
+   const size_t numSamples = 44100 * 10;
+   const double stretchFactor = 1.5;
+
+   typedef std::chrono::steady_clock Clock;
+
+   /// Random partials that sound for one to three seconds.
+   for ( size_t numPeaks = 50; numPeaks <= 800; numPeaks *= 4 )
+   {
+      RandomNumberGenerator rng( 1 );
+      std::vector< Feature::SrSpecPeak* > peaks;
+      std::vector< Feature::SustainedPeak* > sustainedPeaks;
+      for ( size_t iPeak = 0; iPeak < numPeaks; ++iPeak )
+      {
+         const size_t startSample = rng.uniform( 0, numSamples - 3 * 44100 );
+         const size_t endSample = startSample + rng.uniform( 44100, 3 * 44100 );
+         peaks.push_back( new Feature::SrSpecPeak( 50 * exp( rng.uniform( 0, 5 ) ), rng.uniform( 100, 1000 ), 0, startSample, endSample ) );
+         sustainedPeaks.push_back( new Feature::SustainedPeak( peaks.back() ) );
+         sustainedPeaks.back()->finishBuilding();
+      }
+
+      Music::TimeStretcher sineStretcher( stretchFactor, Music::TimeStretcher::SineSynthesis );
+      Music::TimeStretcher fftStretcher( stretchFactor, Music::TimeStretcher::InverseFftSynthesis );
+
+      Clock::time_point t0 = Clock::now();
+      RawPcmData sineResult = sineStretcher.generateFromSustainedPeaks( sustainedPeaks, fourierConfig, samplingInfo, numSamples );
+      Clock::time_point t1 = Clock::now();
+      RawPcmData fftResult = fftStretcher.generateFromSustainedPeaks( sustainedPeaks, fourierConfig, samplingInfo, numSamples );
+      Clock::time_point t2 = Clock::now();
+
+      Utils::cleanupVector( sustainedPeaks );
+      Utils::cleanupVector( peaks );
+
+      const double timeSine = std::chrono::duration< double >( t1 - t0 ).count();
+      const double timeFft = std::chrono::duration< double >( t2 - t1 ).count();
+      msg << Msg::Info << numPeaks << " peaks, " << fftResult.size() << " samples: sine synthesis " << timeSine
+          << " s, inverse FFT synthesis " << timeFft << " s (speed-up " << timeSine / timeFft << ")" << Msg::EndReq;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devKernelPdfBenchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devKernelPdfBenchmark()
+{
+   Logger msg( "devKernelPdfBenchmark" );
+   msg << Msg::Info << "Running devKernelPdfBenchmark..." << Msg::EndReq;
+
+   const size_t nSamples = 100000;
+   const size_t nQueries = 10000;
+
+   RandomNumberGenerator rng( 1 );
+   RealVector sampling( nSamples );
+   for ( size_t i = 0; i < nSamples; ++i )
+   {
+      sampling[ i ] = rng.gauss( 0, 100 );
+   }
+   const RealVector& xEval = Utils::createRangeReal( -500, 500, nQueries );
+
+   Math::KernelPdf kernPdf( Math::IPdf::CPtr( new Math::GaussPdf( 0, 1 ) ), sampling );
+
+   typedef std::chrono::steady_clock Clock;
+
+   Clock::time_point t0 = Clock::now();
+   RealVector densityPointWise( nQueries );
+   RealVector integralPointWise( nQueries );
+   for ( size_t i = 0; i < nQueries; ++i )
+   {
+      densityPointWise[ i ] = kernPdf.getDensity( xEval[ i ] );
+      integralPointWise[ i ] = kernPdf.getIntegral( xEval[ i ] );
+   }
+   Clock::time_point t1 = Clock::now();
+   const RealVector& densityMany = kernPdf.getDensityMany( xEval );
+   const RealVector& integralMany = kernPdf.getIntegralMany( xEval );
+   Clock::time_point t2 = Clock::now();
+
+   double maxDiffDensity = 0;
+   double maxDiffIntegral = 0;
+   for ( size_t i = 0; i < nQueries; ++i )
+   {
+      maxDiffDensity = std::max( maxDiffDensity, fabs( densityMany[ i ] - densityPointWise[ i ] ) );
+      maxDiffIntegral = std::max( maxDiffIntegral, fabs( integralMany[ i ] - integralPointWise[ i ] ) );
+   }
+
+   const double timePointWise = std::chrono::duration< double >( t1 - t0 ).count();
+   const double timeMany = std::chrono::duration< double >( t2 - t1 ).count();
+
+   msg << Msg::Info << nSamples << " samples x " << nQueries << " queries (density + integral):" << Msg::EndReq;
+   msg << Msg::Info << "Point-wise evaluation: " << timePointWise << " s" << Msg::EndReq;
+   msg << Msg::Info << "Batch evaluation:      " << timeMany << " s (speed-up " << timePointWise / timeMany << ")" << Msg::EndReq;
+   msg << Msg::Info << "Max. difference density = " << maxDiffDensity << ", integral = " << maxDiffIntegral << Msg::EndReq;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devOscillatorBankBenchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devOscillatorBankBenchmark()
+{
+   Logger msg( "devOscillatorBankBenchmark" );
+   msg << Msg::Info << "Running devOscillatorBankBenchmark..." << Msg::EndReq;
+
+   const SamplingInfo samplingInfo( 44100 );
+   const double frequency = 500;
+   const size_t numSamples = 60 * 44100;
+
+   typedef std::chrono::steady_clock Clock;
+
+   /// Reference: one sin call per harmonic per sample.
+   Clock::time_point t0 = Clock::now();
+   size_t numHarmonics = samplingInfo.getNyquistFrequency() / frequency - 1;
+   RealVector reference( numSamples );
+   for ( size_t iSample = 0; iSample < numSamples; ++iSample )
+   {
+      double val = 0;
+      for ( size_t iHarmonic = 1; iHarmonic <= numHarmonics; ++iHarmonic )
+      {
+         double phase = ( iSample + 1 ) * samplingInfo.getPhaseStepPerSample( frequency * iHarmonic );
+         val += 2 / M_PI / iHarmonic * ( ( iHarmonic % 2 == 0 ) ? -1 : 1 ) * sin( phase );
+      }
+      reference[ iSample ] = val;
+   }
+   Clock::time_point t1 = Clock::now();
+   Synthesizer::OscillatorBank bank;
+   for ( size_t iHarmonic = 1; iHarmonic <= numHarmonics; ++iHarmonic )
+   {
+      bank.addOscillator( samplingInfo.getPhaseStepPerSample( frequency * iHarmonic ), 0, 2 / M_PI / iHarmonic * ( ( iHarmonic % 2 == 0 ) ? -1 : 1 ) );
+   }
+   RealVector data( numSamples );
+   bank.render( &data[ 0 ], numSamples );
+   Clock::time_point t2 = Clock::now();
+
+   double maxDiff = 0;
+   for ( size_t iSample = 0; iSample < numSamples; ++iSample )
+   {
+      maxDiff = std::max( maxDiff, fabs( data[ iSample ] - reference[ iSample ] ) );
+   }
+
+   const double timeReference = std::chrono::duration< double >( t1 - t0 ).count();
+   const double timeBank = std::chrono::duration< double >( t2 - t1 ).count();
+
+   msg << Msg::Info << numHarmonics << " harmonics x " << numSamples << " samples:" << Msg::EndReq;
+   msg << Msg::Info << "Sin per sample: " << timeReference << " s" << Msg::EndReq;
+   msg << Msg::Info << "Oscillator bank: " << timeBank << " s (speed-up " << timeReference / timeBank << ")" << Msg::EndReq;
+   msg << Msg::Info << "Max. difference = " << maxDiff << Msg::EndReq;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devWavetableBenchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devWavetableBenchmark()
+{
+   Logger msg( "devWavetableBenchmark" );
+   msg << Msg::Info << "Running devWavetableBenchmark..." << Msg::EndReq;
+
+   const SamplingInfo samplingInfo( 44100 );
+   const size_t numSamples = 10 * 44100;
+
+   typedef std::chrono::steady_clock Clock;
+
+   std::vector< double > frequencies = { 50, 500, 5000 };
+   for ( size_t iFreq = 0; iFreq < frequencies.size(); ++iFreq )
+   {
+      const double frequency = frequencies[ iFreq ];
+
+      /// Reference: sum of all harmonics below the Nyquist frequency, with a sin per harmonic and sample.
+      Clock::time_point t0 = Clock::now();
+      RealVector reference( numSamples );
+      size_t numHarmonics = 0;
+      for ( size_t iHarmonic = 1; iHarmonic * frequency < samplingInfo.getNyquistFrequency(); ++iHarmonic )
+      {
+         const double phaseStep = samplingInfo.getPhaseStepPerSample( frequency * iHarmonic );
+         const double amplitude = 2 / M_PI / iHarmonic * ( ( iHarmonic % 2 == 0 ) ? -1 : 1 );
+         for ( size_t iSample = 0; iSample < numSamples; ++iSample )
+         {
+            reference[ iSample ] += amplitude * sin( ( iSample + 1 ) * phaseStep );
+         }
+         numHarmonics = iHarmonic;
+      }
+      Clock::time_point t1 = Clock::now();
+
+      Synthesizer::SawtoothGenerator generator( samplingInfo );
+      generator.setFrequency( frequency );
+      RawPcmData::Ptr data = generator.generate( numSamples );
+      Clock::time_point t2 = Clock::now();
+
+      const double timeReference = std::chrono::duration< double >( t1 - t0 ).count();
+      const double timeWavetable = std::chrono::duration< double >( t2 - t1 ).count();
+      msg << Msg::Info << frequency << " Hz: sum of " << numHarmonics << " harmonics " << timeReference
+          << " s, wavetable " << timeWavetable << " s (speed-up " << timeReference / timeWavetable << ")" << Msg::EndReq;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devPolyphonicSynthesizerBenchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devPolyphonicSynthesizerBenchmark()
+{
+   Logger msg( "devPolyphonicSynthesizerBenchmark" );
+   msg << Msg::Info << "Running devPolyphonicSynthesizerBenchmark..." << Msg::EndReq;
+
+   const SamplingInfo samplingInfo( 44100 );
+   const size_t numVoices = 32;
+   const size_t numChords = 200;
+   const size_t chordLength = 22050;
+
+   typedef std::chrono::steady_clock Clock;
+
+   for ( size_t numThreads = 1; numThreads <= 8; numThreads *= 2 )
+   {
+      Synthesizer::PolyphonicSynthesizer synth( samplingInfo, numThreads );
+      for ( size_t iVoice = 0; iVoice < numVoices; ++iVoice )
+      {
+         synth.addVoice( new Synthesizer::SawtoothGenerator( samplingInfo ) );
+      }
+
+      /// Overlapping chords of 16 notes.
+      RandomNumberGenerator rng( 1 );
+      for ( size_t iChord = 0; iChord < numChords; ++iChord )
+      {
+         for ( size_t iNote = 0; iNote < 16; ++iNote )
+         {
+            synth.addNote( 100 * exp( rng.uniform( 0, 3 ) ), 0.01, iChord * chordLength / 2, chordLength );
+         }
+      }
+
+      Clock::time_point t0 = Clock::now();
+      RawPcmData::Ptr data = synth.generate();
+      Clock::time_point t1 = Clock::now();
+      msg << Msg::Info << numThreads << " thread(s): " << data->size() << " samples in " << std::chrono::duration< double >( t1 - t0 ).count()
+          << " s, " << synth.getNumStolenNotes() << " stolen notes" << Msg::EndReq;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devRealTimeRenderer
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devRealTimeRenderer()
+{
+   Logger msg( "devRealTimeRenderer" );
+   msg << Msg::Info << "Running devRealTimeRenderer..." << Msg::EndReq;
+
+   const SamplingInfo samplingInfo( 44100 );
+   const size_t numSeconds = 10;
+
+   /// Increasing polyphony to find the load at which the deadlines are missed.
+   for ( size_t numVoices = 16; numVoices <= 256; numVoices *= 2 )
+   {
+      Synthesizer::PolyphonicSynthesizer synth( samplingInfo );
+      for ( size_t iVoice = 0; iVoice < numVoices; ++iVoice )
+      {
+         synth.addVoice( new Synthesizer::SawtoothGenerator( samplingInfo ) );
+      }
+      RandomNumberGenerator rng( 1 );
+      for ( size_t iVoice = 0; iVoice < numVoices; ++iVoice )
+      {
+         synth.addNote( 100 * exp( rng.uniform( 0, 3 ) ), 0.01, 0, numSeconds * 44100 );
+      }
+
+      for ( size_t blockSize = 64; blockSize <= 1024; blockSize *= 4 )
+      {
+         Synthesizer::NullAudioSink sink;
+         Synthesizer::RealTimeRenderer< Synthesizer::PolyphonicSynthesizer > renderer( synth, sink, samplingInfo.getSamplingRate(), blockSize, 4 );
+         Synthesizer::RenderStatistics stats = renderer.run( numSeconds * 44100 / blockSize / 3 );
+         msg << Msg::Info << numVoices << " voices, block size " << blockSize << ": render time p50 = " << stats.getRenderTimePercentile( 50 ) * 1e6
+             << " us, p99 = " << stats.getRenderTimePercentile( 99 ) * 1e6 << " us, p99.9 = " << stats.getRenderTimePercentile( 99.9 ) * 1e6
+             << " us (deadline " << stats.getBlockPeriod() * 1e6 << " us), " << stats.getNumDeadlineMisses() << " misses, "
+             << stats.getNumUnderruns() << " underruns, latency " << stats.getLatency() * 1e3 << " ms" << Msg::EndReq;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devMlpBatchBenchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devMlpBatchBenchmark()
+{
+   Logger msg( "devMlpBatchBenchmark" );
+   msg << Msg::Info << "Running devMlpBatchBenchmark..." << Msg::EndReq;
+
+   /// Error and gradient of a training set, per sample and in mini-batches of different sizes.
+   std::vector< size_t > hiddenLayers;
+   hiddenLayers.push_back( 32 );
+   hiddenLayers.push_back( 32 );
+   Mva::MultiLayerPerceptron mlp( 8, 2, hiddenLayers );
+   mlp.randomiseWeights( Interval( -0.5, 0.5 ), 1 );
+
+   const size_t numSamples = 64 * 1000;
+   RandomNumberGenerator rng( 1 );
+   std::vector< RealVector > inputs( numSamples, RealVector( 8 ) );
+   std::vector< RealVector > targets( numSamples, RealVector( 2 ) );
+   for ( size_t iSample = 0; iSample < numSamples; ++iSample )
+   {
+      for ( size_t i = 0; i < inputs[ iSample ].size(); ++i )
+      {
+         inputs[ iSample ][ i ] = rng.uniform( -1, 1 );
+      }
+      targets[ iSample ][ 0 ] = rng.uniform( -1, 1 );
+      targets[ iSample ][ 1 ] = rng.uniform( -1, 1 );
+   }
+
+   typedef std::chrono::steady_clock Clock;
+
+   /// Per sample: one forward and backward propagation per sample, gradients summed by the caller.
+   Clock::time_point t0 = Clock::now();
+   RealVector gradientPerSample( mlp.getNumWeights(), 0 );
+   double errorPerSample = 0;
+   for ( size_t iSample = 0; iSample < numSamples; ++iSample )
+   {
+      double error = 0;
+      addScaled( gradientPerSample, 1, mlp.calcErrorAndGradient( inputs[ iSample ], targets[ iSample ], error ) );
+      errorPerSample += error;
+   }
+   Clock::time_point t1 = Clock::now();
+   const double timePerSample = std::chrono::duration< double, std::nano >( t1 - t0 ).count() / numSamples;
+   msg << Msg::Info << "Per sample: " << timePerSample << " ns per sample." << Msg::EndReq;
+
+   for ( size_t batchSize = 4; batchSize <= 64; batchSize *= 4 )
+   {
+      std::vector< size_t > sampleIndices( batchSize );
+      RealVector sampleErrors;
+      RealVector gradientBatch( mlp.getNumWeights(), 0 );
+      double errorBatch = 0;
+      Clock::time_point t2 = Clock::now();
+      for ( size_t iFirst = 0; iFirst < numSamples; iFirst += batchSize )
+      {
+         for ( size_t i = 0; i < batchSize; ++i )
+         {
+            sampleIndices[ i ] = iFirst + i;
+         }
+         addScaled( gradientBatch, 1, mlp.calcBatchErrorAndGradient( inputs, targets, sampleIndices, sampleErrors ) );
+         errorBatch += std::accumulate( sampleErrors.begin(), sampleErrors.end(), 0.0 );
+      }
+      Clock::time_point t3 = Clock::now();
+
+      double maxGradientDiff = 0;
+      for ( size_t i = 0; i < gradientBatch.size(); ++i )
+      {
+         maxGradientDiff = std::max( maxGradientDiff, fabs( gradientBatch[ i ] - gradientPerSample[ i ] ) );
+      }
+      const double timeBatch = std::chrono::duration< double, std::nano >( t3 - t2 ).count() / numSamples;
+      msg << Msg::Info << "Mini-batches of " << batchSize << ": " << timeBatch << " ns per sample (speed-up " << timePerSample / timeBatch
+          << "), error difference " << errorBatch - errorPerSample << ", max. gradient difference " << maxGradientDiff << Msg::EndReq;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devFrozenMlpBenchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devFrozenMlpBenchmark()
+{
+   Logger msg( "devFrozenMlpBenchmark" );
+   msg << Msg::Info << "Running devFrozenMlpBenchmark..." << Msg::EndReq;
+
+   /// Small net as used for classification of peak features.
+   std::vector< size_t > hiddenLayers;
+   hiddenLayers.push_back( 16 );
+   hiddenLayers.push_back( 8 );
+   Mva::MultiLayerPerceptron mlp( 4, 1, hiddenLayers );
+   mlp.randomiseWeights( Interval( -1, 1 ), 1 );
+   const Mva::FrozenMlp< double > frozen( mlp );
+   const Mva::FrozenMlp< float > frozenFloat( mlp );
+
+   const size_t numSamples = 1000000;
+   RealVector inputs( 4 * numSamples );
+   for ( size_t i = 0; i < inputs.size(); ++i )
+   {
+      inputs[ i ] = sin( 0.37 * i );
+   }
+   RealVector outputs( numSamples );
+
+   auto t0 = std::chrono::high_resolution_clock::now();
+   RealVector input( 4 );
+   for ( size_t i = 0; i < numSamples; ++i )
+   {
+      std::copy( inputs.begin() + 4 * i, inputs.begin() + 4 * i + 4, input.begin() );
+      outputs[ i ] = mlp.evaluate( input )[ 0 ];
+   }
+   auto t1 = std::chrono::high_resolution_clock::now();
+   frozen.evaluateBatch( inputs.data(), numSamples, outputs.data() );
+   auto t2 = std::chrono::high_resolution_clock::now();
+   frozenFloat.evaluateBatch( inputs.data(), numSamples, outputs.data() );
+   auto t3 = std::chrono::high_resolution_clock::now();
+
+   msg << Msg::Info << "MultiLayerPerceptron::evaluate: " << std::chrono::duration< double, std::nano >( t1 - t0 ).count() / numSamples << " ns per sample." << Msg::EndReq;
+   msg << Msg::Info << "FrozenMlp< double >::evaluateBatch: " << std::chrono::duration< double, std::nano >( t2 - t1 ).count() / numSamples << " ns per sample." << Msg::EndReq;
+   msg << Msg::Info << "FrozenMlp< float >::evaluateBatch: " << std::chrono::duration< double, std::nano >( t3 - t2 ).count() / numSamples << " ns per sample." << Msg::EndReq;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devRealVectorBenchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devRealVectorBenchmark()
+{
+   Logger msg( "devRealVectorBenchmark" );
+   msg << Msg::Info << "Running devRealVectorBenchmark..." << Msg::EndReq;
+
+   /// Particle swarm style update v = w * v + c1 * ( p - x ) + c2 * ( g - x ) and x = x + v, with vectors of the size
+   /// of a typical fit.
+   const size_t numParameters = 64;
+   const size_t numIterations = 200000;
+   const double w = 0.5;
+   const double c1 = 0.3;
+   const double c2 = 0.2;
+   RealVector x( numParameters, 1 );
+   RealVector v( numParameters, 0.1 );
+   const RealVector p( numParameters, 2 );
+   const RealVector g( numParameters, 3 );
+
+   /// Every intermediate result bound to a name, so that every operator allocates (as before the overloads for
+   /// temporaries): 8 allocations per iteration.
+   const size_t numAllocations0 = getNumAllocations();
+   auto t0 = std::chrono::steady_clock::now();
+   for ( size_t i = 0; i < numIterations; ++i )
+   {
+      const RealVector& a = w * v;
+      const RealVector& b = p - x;
+      const RealVector& c = c1 * b;
+      const RealVector& d = g - x;
+      const RealVector& e = c2 * d;
+      const RealVector& f = a + c;
+      v = f + e;
+      const RealVector& y = x + v;
+      x = y;
+   }
+   auto t1 = std::chrono::steady_clock::now();
+   const size_t numAllocations1 = getNumAllocations();
+
+   /// The same as one expression: the temporaries are reused, 4 allocations per iteration.
+   x.assign( numParameters, 1 );
+   v.assign( numParameters, 0.1 );
+   for ( size_t i = 0; i < numIterations; ++i )
+   {
+      v = w * v + c1 * ( p - x ) + c2 * ( g - x );
+      x = x + v;
+   }
+   auto t2 = std::chrono::steady_clock::now();
+   const size_t numAllocations2 = getNumAllocations();
+
+   /// In-place kernels: no allocations.
+   x.assign( numParameters, 1 );
+   v.assign( numParameters, 0.1 );
+   for ( size_t i = 0; i < numIterations; ++i )
+   {
+      v *= w;
+      addScaled( v, c1, p );
+      addScaled( v, c2, g );
+      addScaled( v, -c1 - c2, x );
+      x += v;
+   }
+   auto t3 = std::chrono::steady_clock::now();
+   const size_t numAllocations3 = getNumAllocations();
+
+   msg << Msg::Info << "Named intermediates: " << std::chrono::duration< double, std::nano >( t1 - t0 ).count() / numIterations << " ns"
+       << describeAllocations( numAllocations0, numAllocations1, numIterations ) << " per update." << Msg::EndReq;
+   msg << Msg::Info << "Single expression: " << std::chrono::duration< double, std::nano >( t2 - t1 ).count() / numIterations << " ns"
+       << describeAllocations( numAllocations1, numAllocations2, numIterations ) << " per update." << Msg::EndReq;
+   msg << Msg::Info << "In-place kernels: " << std::chrono::duration< double, std::nano >( t3 - t2 ).count() / numIterations << " ns"
+       << describeAllocations( numAllocations2, numAllocations3, numIterations ) << " per update." << Msg::EndReq;
+
+   /// Gradient descent step x = x - gamma * grad, the same three ways.
+   const double gamma = 1e-3;
+   const RealVector& grad = g;
+   const size_t numAllocations4 = getNumAllocations();
+   auto t4 = std::chrono::steady_clock::now();
+   for ( size_t i = 0; i < numIterations; ++i )
+   {
+      const RealVector& step = gamma * grad;
+      x = x - step;
+   }
+   auto t5 = std::chrono::steady_clock::now();
+   const size_t numAllocations5 = getNumAllocations();
+   for ( size_t i = 0; i < numIterations; ++i )
+   {
+      x = x - gamma * grad;
+   }
+   auto t6 = std::chrono::steady_clock::now();
+   const size_t numAllocations6 = getNumAllocations();
+   for ( size_t i = 0; i < numIterations; ++i )
+   {
+      addScaled( x, -gamma, grad );
+   }
+   auto t7 = std::chrono::steady_clock::now();
+   const size_t numAllocations7 = getNumAllocations();
+
+   msg << Msg::Info << "Gradient step, named intermediates: " << std::chrono::duration< double, std::nano >( t5 - t4 ).count() / numIterations << " ns"
+       << describeAllocations( numAllocations4, numAllocations5, numIterations ) << " per step." << Msg::EndReq;
+   msg << Msg::Info << "Gradient step, single expression: " << std::chrono::duration< double, std::nano >( t6 - t5 ).count() / numIterations << " ns"
+       << describeAllocations( numAllocations5, numAllocations6, numIterations ) << " per step." << Msg::EndReq;
+   msg << Msg::Info << "Gradient step, addScaled: " << std::chrono::duration< double, std::nano >( t7 - t6 ).count() / numIterations << " ns"
+       << describeAllocations( numAllocations6, numAllocations7, numIterations ) << " per step." << Msg::EndReq;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devLinearInterpolatorBenchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devLinearInterpolatorBenchmark()
+{
+   Logger msg( "devLinearInterpolatorBenchmark" );
+   msg << Msg::Info << "Running devLinearInterpolatorBenchmark..." << Msg::EndReq;
+
+   /// A baseline through irregular points and a uniform one, evaluated on a dense sorted grid as in the monitor plots.
+   RandomNumberGenerator rng( 1 );
+   const size_t numPoints = 500;
+   RealVector xIrregular( numPoints );
+   RealVector xUniform( numPoints );
+   RealVector y( numPoints );
+   for ( size_t i = 0; i < numPoints; ++i )
+   {
+      xIrregular[ i ] = rng.uniform( 0, 22050 );
+      xUniform[ i ] = 22050.0 * i / ( numPoints - 1 );
+      y[ i ] = rng.uniform( 0, 1 );
+   }
+   const Math::LinearInterpolator irregular( xIrregular, y );
+   const Math::LinearInterpolator uniform( xUniform, y );
+   const RealVector& xEval = Utils::createRangeReal( 0, 22050, 4096 );
+
+   const size_t numRepetitions = 1000;
+   const Math::LinearInterpolator* interpolators[] = { &irregular, &uniform };
+   const char* names[] = { "Irregular", "Uniform" };
+   for ( size_t iInterp = 0; iInterp < 2; ++iInterp )
+   {
+      double sum = 0;
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for ( size_t iRep = 0; iRep < numRepetitions; ++iRep )
+      {
+         for ( size_t i = 0; i < xEval.size(); ++i )
+         {
+            sum += ( *interpolators[ iInterp ] )( xEval[ i ] );
+         }
+      }
+      double singleNs = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count() / ( numRepetitions * xEval.size() );
+
+      start = std::chrono::steady_clock::now();
+      for ( size_t iRep = 0; iRep < numRepetitions; ++iRep )
+      {
+         sum -= interpolators[ iInterp ]->evalMany( xEval ).back();
+      }
+      double batchNs = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count() / ( numRepetitions * xEval.size() );
+
+      msg << Msg::Info << names[ iInterp ] << ": " << singleNs << " ns per point with operator(), " << batchNs << " ns per point with evalMany (checksum " << sum << ")." << Msg::EndReq;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// devSampledMovingAverageBenchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void DevSuite::devSampledMovingAverageBenchmark()
+{
+   Logger msg( "devSampledMovingAverageBenchmark" );
+   msg << Msg::Info << "Running devSampledMovingAverageBenchmark..." << Msg::EndReq;
+
+   typedef Math::SampledMovingAverage SMA;
+   RandomNumberGenerator rng( 1 );
+   RealVector data( 20000 );
+   for ( size_t i = 0; i < data.size(); ++i )
+   {
+      data[ i ] = rng.uniform( 0, 1 );
+   }
+   RealVector result( data.size() );
+
+   /// Gaussian filters of increasing width with every backend, in place on a caller buffer after a warm-up call.
+   const size_t filterSizes[] = { 21, 51, 101, 201, 501, 1001 };
+   const SMA::Backend backends[] = { SMA::Direct, SMA::Fft, SMA::RecursiveGaussian, SMA::RunningSum };
+   const char* backendNames[] = { "Direct", "Fft", "RecursiveGaussian", "RunningSum (box)" };
+   const size_t numRepetitions = 20;
+   for ( size_t iSize = 0; iSize < sizeof( filterSizes ) / sizeof( size_t ); ++iSize )
+   {
+      const size_t nWeights = filterSizes[ iSize ];
+      for ( size_t iBackend = 0; iBackend < 4; ++iBackend )
+      {
+         const RealVector& weights = backends[ iBackend ] == SMA::RunningSum ? RealVector( nWeights, 1 ) : SMA::createGaussianFilter( nWeights, nWeights * nWeights / 18. );
+         SMA movAvg( weights, backends[ iBackend ] );
+         movAvg.calculate( data, result );
+
+         std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+         for ( size_t iRep = 0; iRep < numRepetitions; ++iRep )
+         {
+            result = data;
+            movAvg.calculate( result, result );
+         }
+         double us = std::chrono::duration< double, std::micro >( std::chrono::steady_clock::now() - start ).count() / numRepetitions;
+         msg << Msg::Info << nWeights << " weights, " << backendNames[ iBackend ] << ": " << us << " us." << Msg::EndReq;
+      }
+   }
+}
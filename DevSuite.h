@@ -11,8 +11,20 @@ class DevSuite
       static void devPeakSustainAlgorithm();
       static void devFundamentalFreqFinder();
       static void devTimeStretcher();
+      static void devPhaseVocoderBenchmark();
+      static void devTimeStretcherSynthesisBenchmark();
       static void devImprovedPeakAlgorithm();
       static void devSidelobeRejection();
+      static void devKernelPdfBenchmark();
+      static void devOscillatorBankBenchmark();
+      static void devWavetableBenchmark();
+      static void devPolyphonicSynthesizerBenchmark();
+      static void devRealTimeRenderer();
+      static void devMlpBatchBenchmark();
+      static void devFrozenMlpBenchmark();
+      static void devRealVectorBenchmark();
+      static void devLinearInterpolatorBenchmark();
+      static void devSampledMovingAverageBenchmark();
 };
 
 #endif // DEVSUITE_H
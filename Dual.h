@@ -0,0 +1,149 @@
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace Math
+{
+
+/**
+ * @class Dual
+ * @brief Dual number for forward-mode automatic differentiation with respect to N variables.
+ *
+ * A Dual holds a value and its derivatives (tangents) with respect to N independent variables. Arithmetic and the
+ * elementary functions below apply the chain rule, so evaluating a function on Duals gives its value and exact gradient
+ * in one pass. The independent variables are created with variable( value, index ), constants with Dual( value ).
+ *
+ * The number of tangents is a template parameter, so that a Dual lives on the stack and the tangent loops have a fixed
+ * length the compiler can unroll and vectorise.
+ */
+template < size_t N >
+class Dual
+{
+   public:
+      /**
+       * Create a constant with value @param value.
+       */
+      Dual( double value = 0 ) :
+         m_value( value )
+      {
+         m_tangent.fill( 0 );
+      }
+
+      /**
+       * Create independent variable @param index with value @param value.
+       */
+      static Dual variable( double value, size_t index )
+      {
+         Dual result( value );
+         result.m_tangent[ index ] = 1;
+         return result;
+      }
+
+      /**
+       * Get the value.
+       */
+      double getValue() const { return m_value; }
+      /**
+       * Get the derivative with respect to variable @param index.
+       */
+      double getDerivative( size_t index ) const { return m_tangent[ index ]; }
+
+      /**
+       * Create a Dual with value @param value whose tangent is the tangent of this Dual times @param derivative.
+       * Implements the chain rule for a function with derivative @param derivative at this value.
+       */
+      Dual chain( double value, double derivative ) const
+      {
+         Dual result( value );
+         for ( size_t i = 0; i < N; ++i )
+         {
+            result.m_tangent[ i ] = derivative * m_tangent[ i ];
+         }
+         return result;
+      }
+
+      Dual& operator+=( const Dual& other )
+      {
+         m_value += other.m_value;
+         for ( size_t i = 0; i < N; ++i )
+         {
+            m_tangent[ i ] += other.m_tangent[ i ];
+         }
+         return *this;
+      }
+
+      Dual& operator-=( const Dual& other )
+      {
+         m_value -= other.m_value;
+         for ( size_t i = 0; i < N; ++i )
+         {
+            m_tangent[ i ] -= other.m_tangent[ i ];
+         }
+         return *this;
+      }
+
+      Dual& operator*=( const Dual& other )
+      {
+         for ( size_t i = 0; i < N; ++i )
+         {
+            m_tangent[ i ] = m_tangent[ i ] * other.m_value + m_value * other.m_tangent[ i ];
+         }
+         m_value *= other.m_value;
+         return *this;
+      }
+
+      Dual& operator/=( const Dual& other )
+      {
+         const double inverse = 1 / other.m_value;
+         m_value *= inverse;
+         for ( size_t i = 0; i < N; ++i )
+         {
+            m_tangent[ i ] = ( m_tangent[ i ] - m_value * other.m_tangent[ i ] ) * inverse;
+         }
+         return *this;
+      }
+
+      Dual operator-() const
+      {
+         return chain( -m_value, -1 );
+      }
+
+   /**
+    * Arithmetic operators and elementary functions. They are non-template friends, which are only found by argument
+    * dependent lookup for Dual operands, so they do not hide other operators and functions in namespace Math (e.g. the
+    * RealVector operators or exp( double )).
+    */
+   public:
+      friend Dual operator+( Dual a, const Dual& b ) { return a += b; }
+      friend Dual operator-( Dual a, const Dual& b ) { return a -= b; }
+      friend Dual operator*( Dual a, const Dual& b ) { return a *= b; }
+      friend Dual operator/( Dual a, const Dual& b ) { return a /= b; }
+
+      friend Dual operator+( const Dual& a, double b ) { return a.chain( a.m_value + b, 1 ); }
+      friend Dual operator+( double a, const Dual& b ) { return b.chain( a + b.m_value, 1 ); }
+      friend Dual operator-( const Dual& a, double b ) { return a.chain( a.m_value - b, 1 ); }
+      friend Dual operator-( double a, const Dual& b ) { return b.chain( a - b.m_value, -1 ); }
+      friend Dual operator*( const Dual& a, double b ) { return a.chain( a.m_value * b, b ); }
+      friend Dual operator*( double a, const Dual& b ) { return b.chain( a * b.m_value, a ); }
+      friend Dual operator/( const Dual& a, double b ) { return a.chain( a.m_value / b, 1 / b ); }
+      friend Dual operator/( double a, const Dual& b ) { return b.chain( a / b.m_value, -a / ( b.m_value * b.m_value ) ); }
+
+      friend Dual exp( const Dual& a ) { const double e = std::exp( a.m_value ); return a.chain( e, e ); }
+      friend Dual log( const Dual& a ) { return a.chain( std::log( a.m_value ), 1 / a.m_value ); }
+      friend Dual sqrt( const Dual& a ) { const double s = std::sqrt( a.m_value ); return a.chain( s, 0.5 / s ); }
+      friend Dual sin( const Dual& a ) { return a.chain( std::sin( a.m_value ), std::cos( a.m_value ) ); }
+      friend Dual cos( const Dual& a ) { return a.chain( std::cos( a.m_value ), -std::sin( a.m_value ) ); }
+      friend Dual tanh( const Dual& a ) { const double t = std::tanh( a.m_value ); return a.chain( t, 1 - t * t ); }
+      friend Dual pow( const Dual& a, double p ) { return a.chain( std::pow( a.m_value, p ), p * std::pow( a.m_value, p - 1 ) ); }
+
+   private:
+      double                     m_value;    //! Value.
+      std::array< double, N >    m_tangent;  //! Derivatives with respect to the independent variables.
+};
+
+} /// namespace Math
+
+#endif // DUAL_H
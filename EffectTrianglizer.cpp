@@ -2,6 +2,8 @@
 
 #include "Logger.h"
 
+#include <algorithm>
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// Apply trianglizer effect to source
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -96,6 +98,9 @@ RawPcmData::Ptr EffectTrianglizer::apply( const RawPcmData& source )
       y0 = y1;
    }
 
+   /// The last sample is the last peak itself
+   (*result)[ source.size() - 1 ] = peakHeightList.back();
+
    /// Report finished
    msg << Msg::Info << "Data generation done." << Msg::EndReq;
 
@@ -103,3 +108,177 @@ RawPcmData::Ptr EffectTrianglizer::apply( const RawPcmData& source )
    return RawPcmData::Ptr( result );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+EffectTrianglizer::EffectTrianglizer( size_t numChannels ) :
+   m_channels( numChannels ),
+   m_numFramesRead( 0 )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumChannels
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t EffectTrianglizer::getNumChannels() const
+{
+   return m_channels.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// write
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void EffectTrianglizer::write( const double* input, size_t numFrames )
+{
+   const size_t numChannels = m_channels.size();
+   for ( size_t iChannel = 0; iChannel < numChannels; ++iChannel )
+   {
+      Channel& channel = m_channels[ iChannel ];
+      for ( size_t iFrame = 0; iFrame < numFrames; ++iFrame )
+      {
+         channel.write( input[ iFrame * numChannels + iChannel ] );
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// finish
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void EffectTrianglizer::finish()
+{
+   for ( size_t iChannel = 0; iChannel < m_channels.size(); ++iChannel )
+   {
+      m_channels[ iChannel ].finish();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumAvailable
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t EffectTrianglizer::getNumAvailable() const
+{
+   if ( m_channels.empty() )
+   {
+      return 0;
+   }
+
+   /// Frames are complete once all channels have found their next peak.
+   size_t numDetermined = m_channels[ 0 ].getNumDetermined();
+   for ( size_t iChannel = 1; iChannel < m_channels.size(); ++iChannel )
+   {
+      numDetermined = std::min( numDetermined, m_channels[ iChannel ].getNumDetermined() );
+   }
+   return numDetermined - m_numFramesRead;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// read
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t EffectTrianglizer::read( double* output, size_t maxFrames )
+{
+   const size_t numFrames = std::min( maxFrames, getNumAvailable() );
+   for ( size_t iChannel = 0; iChannel < m_channels.size(); ++iChannel )
+   {
+      m_channels[ iChannel ].read( output + iChannel, m_channels.size(), numFrames );
+   }
+   m_numFramesRead += numFrames;
+   return numFrames;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Channel constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/**
+ * The first peak is positioned at 0 with height 0, as in apply.
+ */
+EffectTrianglizer::Channel::Channel() :
+   m_numInput( 0 ),
+   m_lastVal( 0 ),
+   m_lastDeriv( 0 ),
+   m_numDetermined( 0 ),
+   m_numOutput( 0 ),
+   m_segmentEnd( 0 ),
+   m_segmentHeight( 0 ),
+   m_value( 0 ),
+   m_step( 0 )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Channel::write
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void EffectTrianglizer::Channel::write( double sample )
+{
+   if ( m_numInput > 1 )
+   {
+      /// Same peak condition as in apply: the derivatives left and right of the last sample have opposite sign.
+      double rightDeriv = sample - m_lastVal;
+      if ( rightDeriv * m_lastDeriv < 0 )
+      {
+         addPeak( m_numInput - 1, m_lastVal );
+      }
+      m_lastDeriv = rightDeriv;
+   }
+   else if ( m_numInput == 1 )
+   {
+      m_lastDeriv = sample - m_lastVal;
+   }
+   m_lastVal = sample;
+   ++m_numInput;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Channel::finish
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void EffectTrianglizer::Channel::finish()
+{
+   if ( m_numInput > 0 )
+   {
+      /// The last sample is a peak; the extra peak after it closes the segment that holds the last sample.
+      addPeak( m_numInput - 1, m_lastVal );
+      addPeak( m_numInput, m_lastVal );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Channel::addPeak
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void EffectTrianglizer::Channel::addPeak( size_t position, double height )
+{
+   m_peakPos.push_back( position );
+   m_peakHeight.push_back( height );
+   m_numDetermined = position;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Channel::read
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void EffectTrianglizer::Channel::read( double* output, size_t stride, size_t numSamples )
+{
+   for ( size_t i = 0; i < numSamples; ++i )
+   {
+      /// Start the segment up to the next peak, with the same arithmetic as apply.
+      while ( m_numOutput == m_segmentEnd )
+      {
+         double y0 = m_segmentHeight;
+         double y1 = m_peakHeight.front();
+         int nSamples = m_peakPos.front() - m_segmentEnd;
+         m_step = static_cast<double>(y1 - y0)/( nSamples - 1);
+         m_value = y0;
+         m_segmentEnd = m_peakPos.front();
+         m_segmentHeight = y1;
+         m_peakPos.pop_front();
+         m_peakHeight.pop_front();
+      }
+
+      output[ i * stride ] = m_value;
+      m_value += m_step;
+      ++m_numOutput;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Channel::getNumDetermined
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t EffectTrianglizer::Channel::getNumDetermined() const
+{
+   return m_numDetermined;
+}
@@ -3,9 +3,17 @@
 
 #include "RawPcmData.h"
 
+#include <deque>
+#include <vector>
+
 /**
  * @class EffectTrianglizer
  * An effect linearly extrapolates between every extremal value in the source data
+ *
+ * Besides the offline apply, an EffectTrianglizer object applies the effect to a stream of interleaved multi-channel
+ * frames: write blocks of input and read the output as far as it is known. The output between two extrema is only known
+ * once the second extremum has been found, so the output lags behind the input. No samples are stored: each channel
+ * only keeps the extrema that have been found but not yet read. The output is that of apply, up to rounding.
  */
 class EffectTrianglizer
 {
@@ -14,6 +22,86 @@ class EffectTrianglizer
        * Apply the effect to the source data
        */
       static RawPcmData::Ptr apply( const RawPcmData& source );
+
+   public:
+      /**
+       * Create a streaming trianglizer for @param numChannels interleaved channels.
+       */
+      EffectTrianglizer( size_t numChannels = 1 );
+
+      /**
+       * Get the number of channels.
+       */
+      size_t getNumChannels() const;
+      /**
+       * Process @param numFrames frames of interleaved samples in @param input.
+       */
+      void write( const double* input, size_t numFrames );
+      /**
+       * Mark the end of the input; the remaining output becomes available.
+       */
+      void finish();
+      /**
+       * Get the number of frames that can be read.
+       */
+      size_t getNumAvailable() const;
+      /**
+       * Write at most @param maxFrames frames of interleaved output to @param output. Returns the number of frames.
+       */
+      size_t read( double* output, size_t maxFrames );
+
+   private:
+      /**
+       * @class Channel
+       * @brief Streaming peak detection and interpolation state of one channel.
+       */
+      class Channel
+      {
+         public:
+            Channel();
+
+            /**
+             * Process the next input sample.
+             */
+            void write( double sample );
+            /**
+             * Add the last sample as a peak.
+             */
+            void finish();
+            /**
+             * Write the next @param numSamples output samples to @param output with @param stride.
+             */
+            void read( double* output, size_t stride, size_t numSamples );
+
+            /**
+             * Get the number of output samples that are known.
+             */
+            size_t getNumDetermined() const;
+
+         private:
+            /**
+             * Add a peak at @param position with @param height.
+             */
+            void addPeak( size_t position, double height );
+
+         private:
+            size_t                  m_numInput;       //! Number of input samples processed.
+            double                  m_lastVal;        //! Last input sample.
+            double                  m_lastDeriv;      //! Difference between the last two input samples.
+            std::deque< size_t >    m_peakPos;        //! Positions of the peaks that have not been interpolated yet.
+            std::deque< double >    m_peakHeight;     //! Heights of those peaks.
+            size_t                  m_numDetermined;  //! Position of the last peak, up to which the output is known.
+
+            size_t                  m_numOutput;      //! Number of output samples written.
+            size_t                  m_segmentEnd;     //! End of the current interpolation segment.
+            double                  m_segmentHeight;  //! Height of the peak that ends the current segment.
+            double                  m_value;          //! Next output value.
+            double                  m_step;           //! Interpolation step per sample.
+      };
+
+   private:
+      std::vector< Channel >  m_channels;          //! State per channel.
+      size_t                  m_numFramesRead;     //! Number of output frames read.
 };
 
 #endif // EFFECTTRIANGLIZER_H
@@ -0,0 +1,103 @@
+#include "FftConvolution.h"
+
+#include "FftwAlgorithm.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Math
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+FftConvolution::FftConvolution( const RealVector& kernel, size_t maxDataSize ) :
+   m_kernelSize( kernel.size() ),
+   m_maxDataSize( maxDataSize ),
+   m_fftw( new WaveAnalysis::FftwAlgorithm( calcFourierSize( maxDataSize + kernel.size() - 1 ) ) )
+{
+   assert( ( m_kernelSize % 2 ) == 1 );
+
+   /// Transform the zero padded kernel and absorb the 1/N normalisation of the reverse transform in the spectrum.
+   double* timeData = m_fftw->getTimeDataWorkingArray();
+   const size_t fourierSize = m_fftw->getFourierSize();
+   std::copy( kernel.begin(), kernel.end(), timeData );
+   std::fill( timeData + m_kernelSize, timeData + fourierSize, 0.0 );
+   m_fftw->transform();
+
+   const Complex* spectrum = m_fftw->getFourierDataWorkingArray();
+   const double norm = 1.0 / fourierSize;
+   m_kernelSpectrum.resize( m_fftw->getSpectrumDimension() );
+   for ( size_t i = 0; i < m_kernelSpectrum.size(); ++i )
+   {
+      m_kernelSpectrum[ i ] = spectrum[ i ] * norm;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// destructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+FftConvolution::~FftConvolution()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calculate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RealVector FftConvolution::calculate( const RealVector& dataSet )
+{
+   RealVector result;
+   calculate( dataSet, result );
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calculate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void FftConvolution::calculate( const RealVector& dataSet, RealVector& result )
+{
+   assert( dataSet.size() <= m_maxDataSize );
+
+   const size_t nData = dataSet.size();
+   const size_t fourierSize = m_fftw->getFourierSize();
+
+   /// Zero padding ensures that the circular convolution equals the linear convolution.
+   double* timeData = m_fftw->getTimeDataWorkingArray();
+   std::copy( dataSet.begin(), dataSet.end(), timeData );
+   std::fill( timeData + nData, timeData + fourierSize, 0.0 );
+   m_fftw->transform();
+
+   Complex* spectrum = m_fftw->getFourierDataWorkingArray();
+   for ( size_t i = 0; i < m_kernelSpectrum.size(); ++i )
+   {
+      spectrum[ i ] *= m_kernelSpectrum[ i ];
+   }
+   m_fftw->reverseTransform();
+
+   /// The linear convolution is shifted by half the kernel size with respect to the data.
+   const size_t offset = ( m_kernelSize - 1 ) / 2;
+   result.resize( nData );
+   std::copy( timeData + offset, timeData + offset + nData, result.begin() );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getFourierSize
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t FftConvolution::getFourierSize() const
+{
+   return m_fftw->getFourierSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calcFourierSize
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t FftConvolution::calcFourierSize( size_t minSize )
+{
+   size_t fourierSize = 1;
+   while ( fourierSize < minSize )
+   {
+      fourierSize *= 2;
+   }
+   return fourierSize;
+}
+
+} /// namespace Math
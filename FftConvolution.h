@@ -0,0 +1,72 @@
+#ifndef FFTCONVOLUTION_H
+#define FFTCONVOLUTION_H
+
+#include "RealVector.h"
+#include "Typedefs.h"
+
+#include <memory>
+
+namespace WaveAnalysis
+{
+class FftwAlgorithm;
+}
+
+namespace Math
+{
+
+/**
+ * @class FftConvolution
+ * @brief Linear (i.e. non-circular) convolution of sampled data with a fixed, sampled kernel using FFTW.
+ *
+ * The kernel has an odd number of samples and its middle sample is the origin. The result of calculate has the same
+ * size as the input: result[ i ] = sum_k kernel[ k ] * data[ i + h - k ], where h = ( kernel.size() - 1 ) / 2 and
+ * samples outside the data set are taken to be zero. This is the same convention as SampledMovingAverage, except that
+ * the result is not renormalised at the edges of the data set.
+ *
+ * The cost is O( M log M ) with M the Fourier size (data size + kernel size rounded up to a power of two), compared to
+ * O( N x K ) for a direct convolution. The kernel spectrum is calculated once at construction, so an instance should be
+ * reused when many data sets of the same size are convolved with the same kernel.
+ */
+class FftConvolution
+{
+   public:
+      /**
+       * Create a convolution of @param kernel with data sets of (at most) @param maxDataSize samples.
+       * The number of kernel samples should be odd.
+       */
+      FftConvolution( const RealVector& kernel, size_t maxDataSize );
+      /**
+       * Destructor.
+       */
+      ~FftConvolution();
+
+      /**
+       * Convolve @param dataSet with the kernel. @param dataSet should not be larger than the maxDataSize given at construction.
+       */
+      RealVector calculate( const RealVector& dataSet );
+      /**
+       * Convolve @param dataSet with the kernel and write the result into @param result. @param result is resized to
+       * the size of @param dataSet and may be the same object as @param dataSet.
+       */
+      void calculate( const RealVector& dataSet, RealVector& result );
+
+      /**
+       * Get the number of samples of the Fourier transform that is used internally.
+       */
+      size_t getFourierSize() const;
+
+      /**
+       * Get the smallest power of two that is larger or equal to @param minSize.
+       */
+      static size_t calcFourierSize( size_t minSize );
+
+   private:
+      size_t                                          m_kernelSize;       //! Number of samples in the kernel.
+      size_t                                          m_maxDataSize;      //! Maximum number of samples in the data.
+      std::unique_ptr< WaveAnalysis::FftwAlgorithm >  m_fftw;             //! Fourier transform and working buffers.
+      ComplexVector                                   m_kernelSpectrum;   //! Fourier transform of the kernel (incl. 1/N).
+};
+
+} /// namespace Math
+
+#endif // FFTCONVOLUTION_H
@@ -32,6 +32,31 @@ double FitFunctionBase::par( size_t parIndex ) const
    return m_parameters[ parIndex ];
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getParameters
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const RealVector& FitFunctionBase::getParameters() const
+{
+   return m_parameters;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// hasParameterGradient
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool FitFunctionBase::hasParameterGradient() const
+{
+   return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// evalWithParameterGradient
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double FitFunctionBase::evalWithParameterGradient( double x, double* /* parGradient */ ) const
+{
+   assert( false && "evalWithParameterGradient is not implemented, check hasParameterGradient" );
+   return ( *this )( x );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// setParameters
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,10 @@ namespace Math
 /**
  * @class FitFunctionBase
  * @brief Base class for a parametric functions that can be used for fitting.
+ *
+ * Functions that can calculate their exact derivatives with respect to the parameters override hasParameterGradient
+ * and evalWithParameterGradient, either analytically or with automatic differentiation (@see AutoDiffFitFunction).
+ * Fit objectives use them instead of finite differences.
  */
 class FitFunctionBase : public IRealFunction
 {
@@ -48,6 +52,20 @@ class FitFunctionBase : public IRealFunction
        * Get parameter @param parIndex.
        */
       double par( size_t parIndex ) const;
+      /**
+       * Get all parameters.
+       */
+      const RealVector& getParameters() const;
+
+      /**
+       * Check whether evalWithParameterGradient is implemented.
+       */
+      virtual bool hasParameterGradient() const;
+      /**
+       * Evaluate the function at @param x and write its derivatives with respect to the getNumParameters() parameters
+       * to @param parGradient. Only implemented if hasParameterGradient.
+       */
+      virtual double evalWithParameterGradient( double x, double* parGradient ) const;
 
    private:
       RealVector     m_parameters;     //! The parameters of the fit function.
@@ -1,6 +1,7 @@
 #include "FocalTones.h"
 
 #include "Exceptions.h"
+#include "GroundToneLikelihood.h"
 #include "Logger.h"
 #include "Peak.h"
 #include "Tone.h"
@@ -11,106 +12,11 @@
 #include "RootUtilities.h"
 #include "TGraph2D.h"
 
-#include "IObjectiveFunction.h"
-
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <set>
 
-namespace
-{
-
-class GroundToneLikelihood : public Math::IObjectiveFunction
-{
-   public:
-      GroundToneLikelihood( const std::vector< RealVector >& groundToneCandidates,
-                            const std::vector< RealVector >& groundToneUncertainty );
-
-      double evaluate( const RealVector& x ) const;
-      size_t getNumParameters() const;
-
-      void setTemperature( double temperature );
-      void setChi2Cutoff( double chi2Cuttoff );
-
-   private:
-      double calcWeight( double chi2Term ) const;
-      void updateCutoffTerm();
-
-   private:
-      const std::vector< RealVector >& m_groundToneCandidates;
-      const std::vector< RealVector >& m_groundToneUncertainty;
-      double                           m_temperature;
-      double                           m_chi2Cutoff;
-      double                           m_cutoffTerm;
-};
-
-GroundToneLikelihood::GroundToneLikelihood( const std::vector< RealVector >& groundToneCandidates,
-                                            const std::vector< RealVector >& groundToneUncertainty ) :
-   m_groundToneCandidates( groundToneCandidates ),
-   m_groundToneUncertainty( groundToneUncertainty ),
-   m_temperature( 1 ),
-   m_chi2Cutoff( 7 )
-{
-   assert( m_groundToneUncertainty.size() == m_groundToneCandidates.size() );
-   updateCutoffTerm();
-}
-
-double GroundToneLikelihood::evaluate( const RealVector& x ) const
-{
-   double t = x[0];
-
-   assert( m_groundToneCandidates.size() > 0 );
-   double sumWeights = 0;
-
-   for ( size_t iHarmonic = 0; iHarmonic < m_groundToneCandidates.size(); ++iHarmonic )
-   {
-      for ( size_t iPeak = 0; iPeak < m_groundToneCandidates[iHarmonic].size(); ++iPeak )
-      {
-         double relDiff = ( t - m_groundToneCandidates[iHarmonic][ iPeak ] ) / m_groundToneUncertainty[iHarmonic][iPeak];
-         double chi2Term = relDiff * relDiff;
-         double weight = calcWeight( chi2Term );
-         sumWeights += weight;
-      }
-   }
-   return sumWeights;
-}
-
-size_t GroundToneLikelihood::getNumParameters() const
-{
-   return 1;
-}
-
-double GroundToneLikelihood::calcWeight( double chi2Term ) const
-{
-   double argTerm = -chi2Term / m_temperature;
-   if ( argTerm < -50 )
-   {
-      return 0;
-   }
-   double expTerm = exp( argTerm );
-   return expTerm / ( expTerm + m_cutoffTerm );
-}
-
-void GroundToneLikelihood::setTemperature( double temperature )
-{
-   m_temperature = temperature;
-   updateCutoffTerm();
-}
-
-void GroundToneLikelihood::setChi2Cutoff( double chi2Cutoff )
-{
-   m_chi2Cutoff = chi2Cutoff;
-   updateCutoffTerm();
-}
-
-void GroundToneLikelihood::updateCutoffTerm()
-{
-   double argCutoff = -m_chi2Cutoff / m_temperature;
-   m_cutoffTerm = exp( argCutoff );
-}
-
-} /// anonymous namespace
-
 namespace FeatureAlgorithm
 {
 
@@ -157,22 +63,22 @@ void FocalTones::execute()
    double minGroundTone = std::numeric_limits<double>::max();
    double maxGroundTone = -std::numeric_limits<double>::max();
 
-   std::vector< RealVector > groundToneCandidates( nHarmonicMax, RealVector( m_freqPeaks.size() ) );
-   std::vector< RealVector > groundToneUncertainty( nHarmonicMax, RealVector( m_freqPeaks.size() ) );
+   /// Flat arrays, the candidate of peak iPeak for harmonic iHarmonic is at ( iHarmonic - 1 ) * numPeaks + iPeak.
+   const size_t numPeaks = m_freqPeaks.size();
+   RealVector groundToneCandidates( nHarmonicMax * numPeaks );
+   RealVector groundToneUncertainty( nHarmonicMax * numPeaks );
    for ( size_t iHarmonic = 1; iHarmonic <= nHarmonicMax; ++iHarmonic )
    {
       double factor = 1.0 / iHarmonic;
-      RealVector& allPeaks = groundToneCandidates[ iHarmonic - 1 ];
-      RealVector& uncertaintyVec = groundToneUncertainty[ iHarmonic - 1 ];
-      for ( size_t iPeak = 0; iPeak < m_freqPeaks.size(); ++iPeak )
+      for ( size_t iPeak = 0; iPeak < numPeaks; ++iPeak )
       {
          double val = factor * m_freqPeaks[iPeak]->getPosition();
-         allPeaks[iPeak] = val;
-         uncertaintyVec[ iPeak ] = factor;
+         groundToneCandidates[ ( iHarmonic - 1 ) * numPeaks + iPeak ] = val;
+         groundToneUncertainty[ ( iHarmonic - 1 ) * numPeaks + iPeak ] = factor;
 
          /// TODO: development
          graphX.push_back( iHarmonic );
-         graphY.push_back( allPeaks[iPeak] );
+         graphY.push_back( val );
          graphXErr.push_back( 0 );
          graphYErr.push_back( factor );
 
@@ -193,24 +99,19 @@ void FocalTones::execute()
    lhf.setTemperature( 1 );
    lhf.setChi2Cutoff( cutoff );
 
+   /// Evaluate the likelihood at all candidates in one sorted batch.
+   RealVector gtX( groundToneCandidates );
+   std::sort( gtX.begin(), gtX.end() );
+   RealVector lhEval = lhf.evaluateMany( gtX );
+
    double weight = -1;
-   std::vector< double > lhEval;
-   std::vector< double > gtX;
    double freq = 0;
-
-   for ( size_t iHarmonic = 0; iHarmonic < groundToneCandidates.size(); ++iHarmonic )
+   for ( size_t iCand = 0; iCand < gtX.size(); ++iCand )
    {
-      for ( size_t iCand = 0; iCand < groundToneCandidates[iHarmonic].size(); ++iCand )
+      if ( lhEval[ iCand ] > weight )
       {
-         double x = groundToneCandidates[iHarmonic][iCand];
-         double val = lhf.evaluate( RealVector( 1, x ) );
-         if ( val > weight )
-         {
-            weight = val;
-            freq = x;
-         }
-         gtX.push_back( x );
-         lhEval.push_back( val );
+         weight = lhEval[ iCand ];
+         freq = gtX[ iCand ];
       }
    }
 
@@ -224,16 +125,13 @@ void FocalTones::execute()
    m_tones.push_back( new Feature::Tone( freq, RealVector() ) );
 
    std::set< size_t > freqPeaksToRemove;
-   for ( size_t iHarmonic = 0; iHarmonic < groundToneCandidates.size(); ++iHarmonic )
+   for ( size_t iCand = 0; iCand < groundToneCandidates.size(); ++iCand )
    {
-      for ( size_t iCand = 0; iCand < groundToneCandidates[iHarmonic].size(); ++iCand )
+      double val = groundToneCandidates[iCand];
+      double err = groundToneUncertainty[iCand];
+      if ( ( val - freq ) / err < cutoff )
       {
-         double val = groundToneCandidates[iHarmonic][iCand];
-         double err = groundToneUncertainty[iHarmonic][iCand];
-         if ( ( val - freq ) / err < cutoff )
-         {
-            freqPeaksToRemove.insert( iCand );
-         }
+         freqPeaksToRemove.insert( iCand % numPeaks );
       }
    }
 
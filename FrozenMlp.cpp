@@ -0,0 +1,178 @@
+#include "FrozenMlp.h"
+
+#include "MultiLayerPerceptron.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Mva
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template < typename Scalar >
+FrozenMlp< Scalar >::FrozenMlp( const MultiLayerPerceptron& mlp ) :
+   m_layerSizes( mlp.getLayerSizes() ),
+   m_maxLayerSize( *std::max_element( m_layerSizes.begin(), m_layerSizes.end() ) )
+{
+   /// The MLP stores the bias weights as the last row of the weight matrix of each layer.
+   const RealVector weights = mlp.getWeights();
+   size_t iWeight = 0;
+   for ( size_t iLayer = 0; iLayer + 1 < m_layerSizes.size(); ++iLayer )
+   {
+      const size_t numSource = m_layerSizes[ iLayer ];
+      const size_t numDest = m_layerSizes[ iLayer + 1 ];
+      m_weightOffsets.push_back( m_weights.size() );
+      m_biasOffsets.push_back( m_biases.size() );
+      m_weights.insert( m_weights.end(), weights.begin() + iWeight, weights.begin() + iWeight + numSource * numDest );
+      iWeight += numSource * numDest;
+      if ( mlp.hasBiasNodes() )
+      {
+         m_biases.insert( m_biases.end(), weights.begin() + iWeight, weights.begin() + iWeight + numDest );
+         iWeight += numDest;
+      }
+      else
+      {
+         m_biases.insert( m_biases.end(), numDest, Scalar( 0 ) );
+      }
+   }
+   assert( iWeight == weights.size() );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumInputs
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template < typename Scalar >
+size_t FrozenMlp< Scalar >::getNumInputs() const
+{
+   return m_layerSizes.front();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumOutputs
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template < typename Scalar >
+size_t FrozenMlp< Scalar >::getNumOutputs() const
+{
+   return m_layerSizes.back();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// evaluate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template < typename Scalar >
+RealVector FrozenMlp< Scalar >::evaluate( const RealVector& input ) const
+{
+   assert( input.size() == getNumInputs() );
+   RealVector output( getNumOutputs() );
+   evaluateBatch( input.data(), 1, output.data() );
+   return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// evaluate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template < typename Scalar >
+void FrozenMlp< Scalar >::evaluate( const double* input, double* output ) const
+{
+   evaluateBatch( input, 1, output );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// evaluateBatch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template < typename Scalar >
+void FrozenMlp< Scalar >::evaluateBatch( const double* inputs, size_t numSamples, double* outputs ) const
+{
+   /// Two buffers of a block of rows each; on the stack if they fit, so that small nets do not allocate.
+   const size_t blockSize = std::min( s_blockSize, numSamples );
+   const size_t workspaceSize = 2 * blockSize * m_maxLayerSize;
+   Scalar stackWorkspace[ s_stackWorkspaceSize ];
+   std::vector< Scalar > heapWorkspace;
+   Scalar* workspace = stackWorkspace;
+   if ( workspaceSize > s_stackWorkspaceSize )
+   {
+      heapWorkspace.resize( workspaceSize );
+      workspace = heapWorkspace.data();
+   }
+
+   const size_t numInputs = getNumInputs();
+   const size_t numOutputs = getNumOutputs();
+   for ( size_t iFirst = 0; iFirst < numSamples; iFirst += blockSize )
+   {
+      const size_t numRows = std::min( blockSize, numSamples - iFirst );
+      for ( size_t iRow = 0; iRow < numRows; ++iRow )
+      {
+         const double* input = inputs + ( iFirst + iRow ) * numInputs;
+         std::copy( input, input + numInputs, workspace + iRow * m_maxLayerSize );
+      }
+
+      const Scalar* result = propagate( workspace, workspace + blockSize * m_maxLayerSize, numRows );
+
+      for ( size_t iRow = 0; iRow < numRows; ++iRow )
+      {
+         const Scalar* output = result + iRow * m_maxLayerSize;
+         std::copy( output, output + numOutputs, outputs + ( iFirst + iRow ) * numOutputs );
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// propagate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template < typename Scalar >
+Scalar* FrozenMlp< Scalar >::propagate( Scalar* x, Scalar* y, size_t numRows ) const
+{
+   const size_t numWeightLayers = m_weightOffsets.size();
+   for ( size_t iLayer = 0; iLayer < numWeightLayers; ++iLayer )
+   {
+      const size_t numSource = m_layerSizes[ iLayer ];
+      const size_t numDest = m_layerSizes[ iLayer + 1 ];
+      const Scalar* weights = &m_weights[ m_weightOffsets[ iLayer ] ];
+      const Scalar* biases = &m_biases[ m_biasOffsets[ iLayer ] ];
+
+      /// y = b + x W for all rows; each weight row is used for the whole block before moving on.
+      for ( size_t iRow = 0; iRow < numRows; ++iRow )
+      {
+         std::copy( biases, biases + numDest, y + iRow * m_maxLayerSize );
+      }
+      for ( size_t iSource = 0; iSource < numSource; ++iSource )
+      {
+         const Scalar* weightRow = weights + iSource * numDest;
+         for ( size_t iRow = 0; iRow < numRows; ++iRow )
+         {
+            const Scalar xValue = x[ iRow * m_maxLayerSize + iSource ];
+            Scalar* dest = y + iRow * m_maxLayerSize;
+            for ( size_t iDest = 0; iDest < numDest; ++iDest )
+            {
+               dest[ iDest ] += xValue * weightRow[ iDest ];
+            }
+         }
+      }
+
+      /// Activation function on the hidden layers.
+      if ( iLayer + 1 < numWeightLayers )
+      {
+         for ( size_t iRow = 0; iRow < numRows; ++iRow )
+         {
+            Scalar* dest = y + iRow * m_maxLayerSize;
+            for ( size_t iDest = 0; iDest < numDest; ++iDest )
+            {
+               dest[ iDest ] = std::tanh( dest[ iDest ] );
+            }
+         }
+      }
+      std::swap( x, y );
+   }
+   return x;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Explicit instantiations
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template class FrozenMlp< double >;
+template class FrozenMlp< float >;
+
+} /// namespace Mva
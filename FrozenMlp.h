@@ -0,0 +1,81 @@
+#ifndef FROZENMLP_H
+#define FROZENMLP_H
+
+#include "RealVector.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Mva
+{
+
+/// Forward declares
+class MultiLayerPerceptron;
+
+/**
+ * @class FrozenMlp
+ * @brief Immutable snapshot of a trained MultiLayerPerceptron for fast evaluation.
+ *
+ * The weights are stored as Scalar (double or float). Every layer keeps its bias weights apart and uses them as the
+ * initial value of the weighted sums, so there are no bias nodes to fill and no extra pass to add the bias; the
+ * activation function is applied in place. A network without bias nodes has zero biases, so no layer needs a branch
+ * for them. Samples are evaluated in blocks, and the weight matrix of a layer is traversed once per block.
+ *
+ * All evaluation methods are const and only use local workspace (on the stack for small nets), so many threads can share
+ * one instance. Changes to the source MLP after the construction are not reflected.
+ */
+template < typename Scalar >
+class FrozenMlp
+{
+   public:
+      /**
+       * Take a snapshot of the weights and structure of @param mlp.
+       */
+      FrozenMlp( const MultiLayerPerceptron& mlp );
+
+      /**
+       * Get the number of input nodes.
+       */
+      size_t getNumInputs() const;
+      /**
+       * Get the number of output nodes.
+       */
+      size_t getNumOutputs() const;
+
+      /**
+       * Evaluate the network for @param input and @return the output.
+       */
+      RealVector evaluate( const RealVector& input ) const;
+      /**
+       * Evaluate the network for the getNumInputs() values at @param input and write the getNumOutputs() values to
+       * @param output.
+       */
+      void evaluate( const double* input, double* output ) const;
+      /**
+       * Evaluate @param numSamples samples stored row-major at @param inputs (getNumInputs() values per sample) and
+       * write the responses row-major to @param outputs (getNumOutputs() values per sample).
+       */
+      void evaluateBatch( const double* inputs, size_t numSamples, double* outputs ) const;
+
+   private:
+      /**
+       * Propagate the @param numRows rows in @param x (with row size m_maxLayerSize) through all layers, using
+       * @param y as second buffer. @return the buffer that holds the output.
+       */
+      Scalar* propagate( Scalar* x, Scalar* y, size_t numRows ) const;
+
+   private:
+      static const size_t s_blockSize = 16;           //! Number of samples that are propagated at once.
+      static const size_t s_stackWorkspaceSize = 4096; //! Number of Scalars that fit in the workspace on the stack.
+
+      std::vector< size_t >   m_layerSizes;     //! Number of nodes per layer, without bias nodes.
+      size_t                  m_maxLayerSize;   //! Largest number of nodes in a layer.
+      std::vector< size_t >   m_weightOffsets;  //! Offset of the weight matrix of every layer in m_weights.
+      std::vector< size_t >   m_biasOffsets;    //! Offset of the bias weights of every layer in m_biases.
+      std::vector< Scalar >   m_weights;        //! Weights without bias weights. Indexing: layer, source node, dest node.
+      std::vector< Scalar >   m_biases;         //! Bias weights. Indexing: layer, dest node.
+};
+
+} /// namespace Mva
+
+#endif // FROZENMLP_H
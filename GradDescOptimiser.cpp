@@ -51,7 +51,7 @@ RealVector GradDescOptimiser::solve()
       // double oldObjective = currentObjective;
       const RealVector& grad = m_func.calculateGradient( m_input );
 
-      m_input = m_input - gamma*grad;
+      addScaled( m_input, -gamma, grad );
 
       currentObjective = m_func.evaluate( m_input );
       gradLength = grad*grad;
@@ -0,0 +1,134 @@
+#include "GroundToneLikelihood.h"
+
+#include "SortCache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace FeatureAlgorithm
+{
+
+const double GroundToneLikelihood::s_rejectionArg = 40;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+GroundToneLikelihood::GroundToneLikelihood( const RealVector& groundToneCandidates,
+                                            const RealVector& groundToneUncertainty ) :
+   m_maxUncertainty( 0 ),
+   m_temperature( 1 ),
+   m_chi2Cutoff( 7 )
+{
+   assert( groundToneUncertainty.size() == groundToneCandidates.size() );
+
+   SortCache sortCache( groundToneCandidates );
+   m_candidates = sortCache.applyTo( groundToneCandidates );
+   m_invUncertainty = sortCache.applyTo( groundToneUncertainty );
+   for ( size_t i = 0; i < m_invUncertainty.size(); ++i )
+   {
+      m_maxUncertainty = std::max( m_maxUncertainty, m_invUncertainty[ i ] );
+      m_invUncertainty[ i ] = 1 / m_invUncertainty[ i ];
+   }
+   updateCutoffTerm();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// evaluate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double GroundToneLikelihood::evaluate( const RealVector& x ) const
+{
+   double t = x[0];
+
+   assert( m_candidates.size() > 0 );
+
+   size_t iBegin = std::lower_bound( m_candidates.begin(), m_candidates.end(), t - m_maxDistance ) - m_candidates.begin();
+   size_t iEnd = std::upper_bound( m_candidates.begin() + iBegin, m_candidates.end(), t + m_maxDistance ) - m_candidates.begin();
+   return sumWeights( t, iBegin, iEnd );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// evaluateMany
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RealVector GroundToneLikelihood::evaluateMany( const RealVector& sortedX ) const
+{
+   assert( m_candidates.size() > 0 );
+
+   RealVector result( sortedX.size() );
+
+   /// The window of candidates within reach only moves forward for sorted x.
+   size_t iBegin = 0;
+   size_t iEnd = 0;
+   for ( size_t iX = 0; iX < sortedX.size(); ++iX )
+   {
+      double t = sortedX[ iX ];
+      while ( iBegin < m_candidates.size() && m_candidates[ iBegin ] < t - m_maxDistance )
+      {
+         ++iBegin;
+      }
+      iEnd = std::max( iBegin, iEnd );
+      while ( iEnd < m_candidates.size() && m_candidates[ iEnd ] <= t + m_maxDistance )
+      {
+         ++iEnd;
+      }
+      result[ iX ] = sumWeights( t, iBegin, iEnd );
+   }
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumParameters
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t GroundToneLikelihood::getNumParameters() const
+{
+   return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// sumWeights
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double GroundToneLikelihood::sumWeights( double t, size_t iBegin, size_t iEnd ) const
+{
+   /// Branch free loop over flat arrays that can be vectorised by the compiler.
+   const double* candidates = m_candidates.data();
+   const double* invUncertainty = m_invUncertainty.data();
+   double sum = 0;
+   for ( size_t i = iBegin; i < iEnd; ++i )
+   {
+      double relDiff = ( t - candidates[ i ] ) * invUncertainty[ i ];
+      double chi2Term = std::min( relDiff * relDiff, m_maxChi2 );
+      double weight = 1 / ( 1 + exp( ( chi2Term - m_chi2Cutoff ) * m_invTemperature ) );
+      sum += chi2Term < m_maxChi2 ? weight : 0;
+   }
+   return sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// setTemperature
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void GroundToneLikelihood::setTemperature( double temperature )
+{
+   m_temperature = temperature;
+   updateCutoffTerm();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// setChi2Cutoff
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void GroundToneLikelihood::setChi2Cutoff( double chi2Cutoff )
+{
+   m_chi2Cutoff = chi2Cutoff;
+   updateCutoffTerm();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// updateCutoffTerm
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void GroundToneLikelihood::updateCutoffTerm()
+{
+   m_invTemperature = 1 / m_temperature;
+   m_maxChi2 = m_chi2Cutoff + s_rejectionArg * m_temperature;
+   m_maxDistance = sqrt( m_maxChi2 ) * m_maxUncertainty;
+}
+
+} /// namespace FeatureAlgorithm
@@ -0,0 +1,69 @@
+#ifndef GROUNDTONELIKELIHOOD_H
+#define GROUNDTONELIKELIHOOD_H
+
+#include "IObjectiveFunction.h"
+#include "RealVector.h"
+
+namespace FeatureAlgorithm
+{
+
+/**
+ * @class GroundToneLikelihood
+ * @brief Likelihood of a ground tone at x[0], used by FocalTones.
+ *
+ * The likelihood is the sum over all candidates of a logistic weight 1 / ( 1 + exp( ( chi2 - chi2Cutoff ) / temperature ) ),
+ * with chi2 = ( ( x - candidate ) / uncertainty )^2. The candidates are stored sorted in flat arrays, so that only the
+ * candidates within reach of x are visited. Candidates with a weight below exp( -s_rejectionArg ) are neglected.
+ */
+class GroundToneLikelihood : public Math::IObjectiveFunction
+{
+   public:
+      /**
+       * Create a GroundToneLikelihood for @param groundToneCandidates with @param groundToneUncertainty.
+       */
+      GroundToneLikelihood( const RealVector& groundToneCandidates,
+                            const RealVector& groundToneUncertainty );
+
+      /**
+       * Evaluate the likelihood at x[0].
+       */
+      double evaluate( const RealVector& x ) const;
+      /**
+       * The likelihood has one parameter.
+       */
+      size_t getNumParameters() const;
+
+      /**
+       * Evaluate the likelihood at all points in @param sortedX, which should be sorted in ascending order.
+       */
+      RealVector evaluateMany( const RealVector& sortedX ) const;
+
+      /**
+       * Set the temperature of the logistic weight.
+       */
+      void setTemperature( double temperature );
+      /**
+       * Set the chi2 value at which the logistic weight is one half.
+       */
+      void setChi2Cutoff( double chi2Cuttoff );
+
+   private:
+      double sumWeights( double t, size_t iBegin, size_t iEnd ) const;
+      void updateCutoffTerm();
+
+   private:
+      RealVector                       m_candidates;       //! Sorted ground tone candidates.
+      RealVector                       m_invUncertainty;   //! Inverse uncertainties, sorted along with the candidates.
+      double                           m_maxUncertainty;
+      double                           m_temperature;
+      double                           m_chi2Cutoff;
+      double                           m_invTemperature;
+      double                           m_maxChi2;          //! Candidates with larger chi2 are rejected.
+      double                           m_maxDistance;      //! Maximum distance of a non-rejected candidate.
+
+      static const double              s_rejectionArg;
+};
+
+} /// namespace FeatureAlgorithm
+
+#endif // GROUNDTONELIKELIHOOD_H
@@ -16,9 +16,8 @@ GroundtoneHypothesisBuilder::GroundtoneHypothesisBuilder( const WaveAnalysis::Sr
 
 RealVector GroundtoneHypothesisBuilder::execute( size_t numIterations )
 {
-   RealVector result;
-
-   Math::RegularAccumArray hist = m_spec.rebinToFourierLattice();
+   /// Only the accumulated contents are used, so there is no need to store all the entries.
+   Math::RegularAccumArray hist = m_spec.rebinToFourierLattice( Math::IAccumArray::ContentsOnly );
 
    const RealVector& magnitudes = m_spec.getMagnitude();
    for ( size_t iIter = 1; iIter < numIterations; ++iIter )
@@ -31,7 +30,7 @@ RealVector GroundtoneHypothesisBuilder::execute( size_t numIterations )
       }
    }
 
-   return result;
+   return hist.getAllBinContents();
 }
 
 } /// namespace FeatureAlgorithm
@@ -12,11 +12,14 @@ namespace Math
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// constructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-IAccumArray::Bin::Bin( double minX, double maxX ) :
+IAccumArray::Bin::Bin( double minX, double maxX, BinMode binMode ) :
    m_contents( 0 ),
+   m_sumWeightedX( 0 ),
+   m_sumWeightedX2( 0 ),
    m_elements( 0 ),
    m_minX( minX ),
-   m_maxX( maxX )
+   m_maxX( maxX ),
+   m_binMode( binMode )
 {
    assert( m_maxX > m_minX );
 }
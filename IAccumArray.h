@@ -16,6 +16,10 @@ namespace Math
  * Contents are the integrated, weighted counts.
  * Entries are the values that were added to the bin including weights stored as a TwoTuple.
  *
+ * Storing the entries makes the memory usage grow with the number of accumulated values. If the entries are never
+ * inspected, bins can be created in a lightweight mode (@see BinMode) that only keeps the sums (and optionally the
+ * first and second moments of the accumulated values).
+ *
  * Notes:
  * - Bins should not overlap, other than that, the bins can have any (min, max) as long as max > min.
  * - A point either falls in a regular bin, in an underflow bin, x < getMinX(), an overflow bin, x > getMaxX(). For exotic
@@ -24,6 +28,17 @@ namespace Math
  */
 class IAccumArray
 {
+   public:
+      /**
+       * What a bin keeps track of when values are accumulated.
+       */
+      enum BinMode
+      {
+         StoreEntries = 0,       //! Contents, moments and all the entries.
+         ContentsOnly,           //! Only the contents.
+         ContentsAndMoments      //! Contents and the weighted sums of x and x^2.
+      };
+
    public:
       /**
        * @class Bin
@@ -32,9 +47,9 @@ class IAccumArray
       {
          public:
             /**
-             * Construct an empty bin with (minX, maxX).
+             * Construct an empty bin with (minX, maxX). @param binMode determines whether entries and moments are stored.
              */
-            Bin( double minX, double maxX );
+            Bin( double minX, double maxX, BinMode binMode = StoreEntries );
 
          public:
             /**
@@ -60,10 +75,22 @@ class IAccumArray
              */
             double getContents() const;
             /**
-             * Get the bin entries as a TwoTuple.
+             * Get the bin entries as a TwoTuple. The entries are empty if the bin does not store entries.
              */
             const TwoTuple& getEntries() const;
             TwoTuple& getEntries();
+            /**
+             * Get the weighted mean of the accumulated values. Requires that moments are stored (i.e. not ContentsOnly).
+             */
+            double getMean() const;
+            /**
+             * Get the weighted variance of the accumulated values. Requires that moments are stored.
+             */
+            double getVariance() const;
+            /**
+             * Get the bin mode.
+             */
+            BinMode getBinMode() const;
 
 
             /**
@@ -82,9 +109,12 @@ class IAccumArray
 
          private:
             double         m_contents;          //! Weighted counts (contents).
+            double         m_sumWeightedX;      //! Sum of weight * x (moments).
+            double         m_sumWeightedX2;     //! Sum of weight * x^2 (moments).
             TwoTuple       m_elements;          //! Entries.
             double         m_minX;              //! Min of bin range.
             double         m_maxX;              //! Max of bin range.
+            BinMode        m_binMode;           //! Whether entries and moments are stored.
       };
 
    public:
@@ -207,7 +237,16 @@ inline void IAccumArray::Bin::add( double x, double value )
    assert( x >= m_minX );
    assert( x < m_maxX );
    m_contents += value;
-   m_elements.add( x, value );
+   if ( m_binMode == ContentsOnly )
+   {
+      return;
+   }
+   m_sumWeightedX += value * x;
+   m_sumWeightedX2 += value * x * x;
+   if ( m_binMode == StoreEntries )
+   {
+      m_elements.add( x, value );
+   }
 }
 
 inline const TwoTuple& IAccumArray::Bin::getEntries() const
@@ -226,10 +265,30 @@ inline void IAccumArray::Bin::set( double value )
    add( 0.5 * ( getMinX() + getMaxX() ), value );
 }
 
+inline double IAccumArray::Bin::getMean() const
+{
+   assert( m_binMode != ContentsOnly );
+   return m_sumWeightedX / m_contents;
+}
+
+inline double IAccumArray::Bin::getVariance() const
+{
+   assert( m_binMode != ContentsOnly );
+   double mean = getMean();
+   return m_sumWeightedX2 / m_contents - mean * mean;
+}
+
+inline IAccumArray::BinMode IAccumArray::Bin::getBinMode() const
+{
+   return m_binMode;
+}
+
 inline void IAccumArray::Bin::clearEntries()
 {
    m_elements = TwoTuple();
    m_contents = 0;
+   m_sumWeightedX = 0;
+   m_sumWeightedX2 = 0;
 }
 
 } /// namespace Math
@@ -0,0 +1,91 @@
+#include "IAudioSink.h"
+
+#include "MultiChannelRawPcmData.h"
+#include "WaveFile.h"
+
+namespace Synthesizer {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// IAudioSink methods
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// destructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+IAudioSink::~IAudioSink()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// finish
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void IAudioSink::finish()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// NullAudioSink methods
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+NullAudioSink::NullAudioSink() :
+   m_numSamples( 0 )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// write
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void NullAudioSink::write( const double* /*data*/, size_t numSamples )
+{
+   m_numSamples += numSamples;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumSamples
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t NullAudioSink::getNumSamples() const
+{
+   return m_numSamples;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// WaveFileAudioSink methods
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+WaveFileAudioSink::WaveFileAudioSink( const std::string& fileName, const SamplingInfo& samplingInfo ) :
+   m_fileName( fileName ),
+   m_data( samplingInfo )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// write
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void WaveFileAudioSink::write( const double* data, size_t numSamples )
+{
+   m_data.insert( m_data.end(), data, data + numSamples );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// finish
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void WaveFileAudioSink::finish()
+{
+   if ( !m_fileName.empty() )
+   {
+      MultiChannelRawPcmData waveData( new RawPcmData( m_data ) );
+      WaveFile::write( m_fileName, waveData );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getData
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const RawPcmData& WaveFileAudioSink::getData() const
+{
+   return m_data;
+}
+
+} /// namespace Synthesizer
@@ -0,0 +1,78 @@
+#ifndef IAUDIOSINK_H
+#define IAUDIOSINK_H
+
+#include "RawPcmData.h"
+
+#include <string>
+
+namespace Synthesizer {
+
+/**
+ * @class IAudioSink
+ * @brief Interface for the destination of samples rendered in real time (@see RealTimeRenderer).
+ */
+class IAudioSink
+{
+   public:
+      /**
+       * Virtual destructor
+       */
+      virtual ~IAudioSink();
+      /**
+       * Consume @param numSamples samples from @param data. Called from the real-time thread, so it should not block.
+       */
+      virtual void write( const double* data, size_t numSamples ) = 0;
+      /**
+       * Called after the last block has been written.
+       */
+      virtual void finish();
+};
+
+/**
+ * @class NullAudioSink
+ * @brief Sink that discards the samples, to measure the rendering on its own.
+ */
+class NullAudioSink : public IAudioSink
+{
+   public:
+      NullAudioSink();
+      void write( const double* data, size_t numSamples );
+
+      /**
+       * Get the number of samples written to the sink.
+       */
+      size_t getNumSamples() const;
+
+   private:
+      size_t      m_numSamples;     //! Number of samples written.
+};
+
+/**
+ * @class WaveFileAudioSink
+ * @brief Sink that collects the samples and writes them to a (mono) wave file when finished.
+ * The samples are kept in memory, so that writing does not involve file access.
+ */
+class WaveFileAudioSink : public IAudioSink
+{
+   public:
+      /**
+       * Create sink that writes to @param fileName with @param samplingInfo. The file name can be empty, in which case
+       * the samples are only collected.
+       */
+      WaveFileAudioSink( const std::string& fileName, const SamplingInfo& samplingInfo );
+      void write( const double* data, size_t numSamples );
+      void finish();
+
+      /**
+       * Get the samples written to the sink.
+       */
+      const RawPcmData& getData() const;
+
+   private:
+      std::string    m_fileName;    //! Name of the wave file.
+      RawPcmData     m_data;        //! Collected samples.
+};
+
+} /// namespace Synthesizer
+
+#endif // IAUDIOSINK_H
@@ -1,5 +1,6 @@
 #include "IGenerator.h"
 
+#include <algorithm>
 #include <math.h>
 
 namespace Synthesizer
@@ -25,6 +26,19 @@ IGenerator::~IGenerator()
    delete m_envelope;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// generate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RawPcmData::Ptr IGenerator::generate( size_t length )
+{
+   RawPcmData* result = new RawPcmData( getSamplingInfo(), length );
+   if ( length > 0 )
+   {
+      render( &(*result)[ 0 ], length );
+   }
+   return RawPcmData::Ptr( result );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// Generate sequence of notes
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -46,13 +60,41 @@ RawPcmData::Ptr IGenerator::generate( const std::vector< Music::Note >& notes, d
       double frequency = note.getFrequency();
       setFrequency( frequency );
       resetEnvelopePhase();
-      RawPcmData::Ptr oneNoteData = generate( numSamples );
-      result->mixAdd( *oneNoteData, currentOffset );
+      if ( numSamples > 0 )
+      {
+         render( &(*result)[ currentOffset ], numSamples );
+      }
       currentOffset += numSamples;
    }
    return RawPcmData::Ptr( result );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// renderAdd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void IGenerator::renderAdd( double* buffer, size_t numSamples )
+{
+   double block[ s_blockSize ];
+   for ( size_t iFirst = 0; iFirst < numSamples; iFirst += s_blockSize )
+   {
+      const size_t blockSize = std::min( s_blockSize, numSamples - iFirst );
+      render( block, blockSize );
+      for ( size_t i = 0; i < blockSize; ++i )
+      {
+         buffer[ iFirst + i ] += block[ i ];
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// applyEnvelope
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void IGenerator::applyEnvelope( double* buffer, size_t numSamples )
+{
+   m_envelope->applyEnvelope( m_envelopePhase, numSamples, m_amplitude, buffer );
+   m_envelopePhase += numSamples;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// getEnvelope
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -94,4 +136,9 @@ double IGenerator::getModPhase() const
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Block size
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const size_t IGenerator::s_blockSize;
+
 } /// namespace Synthesizer
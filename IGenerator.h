@@ -26,10 +26,20 @@ class IGenerator
       virtual ~IGenerator();
 
       /**
-       * Generate produces generated sound data. It is expected to also update the phase at the end.
+       * Generate produces generated sound data of @param length samples (@see render).
+       */
+      RawPcmData::Ptr generate( size_t length );
+
+      /**
+       * Render the next @param numSamples samples into @param buffer, overwriting its contents. It is expected to
+       * update the phase and the envelope phase, so that subsequent calls produce a continuous signal.
        * This function should be overridden by derived classes
        */
-      virtual RawPcmData::Ptr generate( size_t length ) = 0;
+      virtual void render( double* buffer, size_t numSamples ) = 0;
+      /**
+       * Render the next @param numSamples samples and add them to @param buffer (@see render).
+       */
+      void renderAdd( double* buffer, size_t numSamples );
 
       /**
        * Generate a sequence of notes (TODO: test)
@@ -102,6 +112,16 @@ class IGenerator
       const SamplingInfo& getSamplingInfo() const;
       SamplingInfo& getSamplingInfo();
 
+   protected:
+      /**
+       * Multiply @param buffer with the amplitude and the envelope and advance the envelope phase by @param numSamples.
+       * The envelope is applied to the whole range at once (@see ISynthEnvelope::applyEnvelope).
+       */
+      void applyEnvelope( double* buffer, size_t numSamples );
+
+   protected:
+      static const size_t s_blockSize = 256;   //! Number of samples per block for envelopes and mixing.
+
    protected:
       ISynthEnvelope*  m_envelope;
       SamplingInfo     m_samplingInfo;
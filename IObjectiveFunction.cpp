@@ -1,14 +1,83 @@
 #include "IObjectiveFunction.h"
 
+#include "WorkerPool.h"
+
+#include <algorithm>
+
 namespace Math
 {
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+IObjectiveFunction::IObjectiveFunction()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Copy-constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+IObjectiveFunction::IObjectiveFunction( const IObjectiveFunction& other )
+{
+   *this = other;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// operator=
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+IObjectiveFunction& IObjectiveFunction::operator=( const IObjectiveFunction& other )
+{
+   /// WorkerPool::run is not reentrant, so copies must not share the pool.
+   if ( this != &other )
+   {
+      setNumThreads( other.m_workerPool ? other.m_workerPool->getNumThreads() : 1 );
+   }
+   return *this;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// Destructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 IObjectiveFunction::~IObjectiveFunction()
 {}
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// evaluateBatch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RealVector IObjectiveFunction::evaluateBatch( const std::vector< RealVector >& xs ) const
+{
+   RealVector result( xs.size() );
+   if ( m_workerPool )
+   {
+      m_workerPool->run( xs.size(), [ this, &xs, &result ]( size_t i )
+      {
+         result[ i ] = evaluate( xs[ i ] );
+      } );
+   }
+   else
+   {
+      for ( size_t i = 0; i < xs.size(); ++i )
+      {
+         result[ i ] = evaluate( xs[ i ] );
+      }
+   }
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// setNumThreads
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void IObjectiveFunction::setNumThreads( size_t numThreads )
+{
+   if ( numThreads > 1 )
+   {
+      m_workerPool.reset( new WorkerPool( numThreads ) );
+   }
+   else
+   {
+      m_workerPool.reset();
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// calculateGradient
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -17,13 +86,23 @@ RealVector IObjectiveFunction::calculateGradient( const RealVector& x, double de
    RealVector result( x.size() );
 
    double objValAtX = evaluate( x );
-   RealVector xPrime( x );
 
-   for ( size_t i = 0; i < x.size(); ++i )
+   /// The shifted points are evaluated as batches of limited size, so that the memory does not grow with x.size()^2.
+   const size_t maxBatchSize = 64;
+   std::vector< RealVector > xPrimes;
+   for ( size_t iFirst = 0; iFirst < x.size(); iFirst += maxBatchSize )
    {
-      xPrime[i] += delta;
-      result[i] = ( evaluate( xPrime ) - objValAtX ) / delta;
-      xPrime[i] -= delta;
+      const size_t batchSize = std::min( maxBatchSize, x.size() - iFirst );
+      xPrimes.assign( batchSize, x );
+      for ( size_t i = 0; i < batchSize; ++i )
+      {
+         xPrimes[ i ][ iFirst + i ] += delta;
+      }
+      const RealVector& objValsAtXPrime = evaluateBatch( xPrimes );
+      for ( size_t i = 0; i < batchSize; ++i )
+      {
+         result[ iFirst + i ] = ( objValsAtXPrime[ i ] - objValAtX ) / delta;
+      }
    }
 
    return result;
@@ -3,6 +3,11 @@
 
 #include "RealVector.h"
 
+#include <memory>
+
+/// Forward declares
+class WorkerPool;
+
 namespace Math
 {
 
@@ -12,10 +17,27 @@ namespace Math
  *
  * Approximated gradients are supplied via the calculateGradient method
  * Specialisations should override the pure virtual evaluate and getNumParameters methods
+ *
+ * Optimisers that need many independent evaluations pass them to evaluateBatch at once. By default it calls evaluate for
+ * every point, on a pool of threads if setNumThreads was called; this is only allowed for specialisations whose evaluate
+ * is thread-safe. Specialisations can override evaluateBatch with a faster implementation. The pool belongs to the
+ * instance: a copy gets its own pool with the same number of threads, so that copies can evaluate batches concurrently.
  */
 class IObjectiveFunction
 {
    public:
+      /**
+       * Constructor
+       */
+      IObjectiveFunction();
+      /**
+       * Copy-constructor, creates a separate pool of threads if @param other has one.
+       */
+      IObjectiveFunction( const IObjectiveFunction& other );
+      /**
+       * Assignment, creates a separate pool of threads if @param other has one.
+       */
+      IObjectiveFunction& operator=( const IObjectiveFunction& other );
       /**
        * Destructor
        */
@@ -30,6 +52,15 @@ class IObjectiveFunction
        * Return the dimensionality of @param x
        */
       virtual size_t getNumParameters() const = 0;
+      /**
+       * Evaluate the function for every point in @param xs and @return the values in the same order.
+       */
+      virtual RealVector evaluateBatch( const std::vector< RealVector >& xs ) const;
+
+      /**
+       * Let the default evaluateBatch evaluate on @param numThreads threads. Only for thread-safe evaluate methods.
+       */
+      void setNumThreads( size_t numThreads );
 
    public:
       /**
@@ -37,6 +68,8 @@ class IObjectiveFunction
        */
       virtual RealVector calculateGradient( const RealVector& x, double delta = 1e-6 ) const;
 
+   private:
+      std::unique_ptr< WorkerPool >    m_workerPool;     //! Threads for the default evaluateBatch, if any.
 };
 
 } /// namespace Math
@@ -36,9 +36,9 @@ class IRealFunction
       virtual IRealFunction* clone() const = 0;
 
       /**
-       * Eval function at points in @param argVec.
+       * Eval function at points in @param argVec. Specialisations can override it with a faster batch evaluation.
        */
-      RealVector evalMany( const RealVector& argVec ) const;
+      virtual RealVector evalMany( const RealVector& argVec ) const;
 };
 
 } /// namespace Math
@@ -1,5 +1,7 @@
 #include "ISynthEnvelope.h"
 
+#include <algorithm>
+
 namespace Synthesizer {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -12,6 +14,35 @@ namespace Synthesizer {
 ISynthEnvelope::~ISynthEnvelope()
 {}
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// fillEnvelope
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ISynthEnvelope::fillEnvelope( size_t firstSample, size_t numSamples, double* result ) const
+{
+   for ( size_t i = 0; i < numSamples; ++i )
+   {
+      result[ i ] = getEnvelope( firstSample + i );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// applyEnvelope
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void ISynthEnvelope::applyEnvelope( size_t firstSample, size_t numSamples, double gain, double* buffer ) const
+{
+   const size_t maxBlockSize = 256;
+   double envelope[ maxBlockSize ];
+   for ( size_t iFirst = 0; iFirst < numSamples; iFirst += maxBlockSize )
+   {
+      const size_t blockSize = std::min( maxBlockSize, numSamples - iFirst );
+      fillEnvelope( firstSample + iFirst, blockSize, envelope );
+      for ( size_t i = 0; i < blockSize; ++i )
+      {
+         buffer[ iFirst + i ] *= gain * envelope[ i ];
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// TrivialEnvelope methods
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -24,4 +55,26 @@ double TrivialEnvelope::getEnvelope( size_t /*iSample*/ ) const
    return 1;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// fillEnvelope
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TrivialEnvelope::fillEnvelope( size_t /*firstSample*/, size_t numSamples, double* result ) const
+{
+   std::fill( result, result + numSamples, 1.0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// applyEnvelope
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TrivialEnvelope::applyEnvelope( size_t /*firstSample*/, size_t numSamples, double gain, double* buffer ) const
+{
+   if ( gain != 1 )
+   {
+      for ( size_t i = 0; i < numSamples; ++i )
+      {
+         buffer[ i ] *= gain;
+      }
+   }
+}
+
 } /// namespace Synthesizer
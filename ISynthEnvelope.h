@@ -20,6 +20,17 @@ class ISynthEnvelope
        * Override this method to implement a synthesizer envelope
        */
       virtual double getEnvelope( size_t iSample ) const = 0;
+      /**
+       * Write the envelope for samples @param firstSample up to @param firstSample + @param numSamples to @param result.
+       * Override this method if the envelope can be evaluated more efficiently per block than per sample.
+       */
+      virtual void fillEnvelope( size_t firstSample, size_t numSamples, double* result ) const;
+      /**
+       * Multiply @param buffer with @param gain times the envelope for samples @param firstSample up to
+       * @param firstSample + @param numSamples. The default implementation uses fillEnvelope; override this method
+       * if the envelope can be applied directly, e.g. as ramps.
+       */
+      virtual void applyEnvelope( size_t firstSample, size_t numSamples, double gain, double* buffer ) const;
 };
 
 /**
@@ -30,6 +41,8 @@ class TrivialEnvelope : public ISynthEnvelope
 {
    public:
       double getEnvelope( size_t iSample ) const;
+      void fillEnvelope( size_t firstSample, size_t numSamples, double* result ) const;
+      void applyEnvelope( size_t firstSample, size_t numSamples, double gain, double* buffer ) const;
 };
 
 } /// namespace Synthesizer
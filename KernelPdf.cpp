@@ -1,20 +1,58 @@
 #include "KernelPdf.h"
 
+#include "GaussPdf.h"
+#include "SortCache.h"
+#include "UniformPdf.h"
+
 #include <cmath>
 
 #include <iostream>
 
+/// Anonymous namespace
+namespace
+{
+   /// Number of sigmas beyond which Gauss kernels are neglected in batch evaluation.
+   const double gaussSupportSigmas = 8;
+
+   /// Advance @param index in sorted vector @param v to the first element that is not smaller than @param value.
+   inline size_t advanceLowerBound( const RealVector& v, size_t index, double value )
+   {
+      while ( index < v.size() && v[ index ] < value )
+      {
+         ++index;
+      }
+      return index;
+   }
+
+   /// Advance @param index in sorted vector @param v to the first element that is larger than @param value.
+   inline size_t advanceUpperBound( const RealVector& v, size_t index, double value )
+   {
+      while ( index < v.size() && v[ index ] <= value )
+      {
+         ++index;
+      }
+      return index;
+   }
+}
+
 namespace Math
 {
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 KernelPdf::KernelPdf( IPdf::CPtr kernel, const RealVector& sampling ) :
    m_kernel( kernel.release() ),
    m_sampling( sampling ),
    m_weights( sampling.size(), 1.0 / m_sampling.size() )
 {
    assert( fabs( sum( m_weights ) - 1 ) < 1e-12 );
+   initialise();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 KernelPdf::KernelPdf( IPdf::CPtr kernel, const RealVector& sampling, const RealVector& weights ) :
    m_kernel( kernel.release() ),
    m_sampling( sampling ),
@@ -23,8 +61,49 @@ KernelPdf::KernelPdf( IPdf::CPtr kernel, const RealVector& sampling, const RealV
    assert( weights.size() == sampling.size() );
    double norm = 1.0 / sum( m_weights );
    scale( m_weights, norm );
+   initialise();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// initialise
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void KernelPdf::initialise()
+{
+   SortCache sortCache( m_sampling );
+   m_weights = sortCache.applyTo( m_weights );
+   m_sampling = sortCache.applyTo( m_sampling );
+
+   m_cumulWeights.assign( m_sampling.size() + 1, 0 );
+   m_cumulWeightedSamples.assign( m_sampling.size() + 1, 0 );
+   for ( size_t i = 0; i < m_sampling.size(); ++i )
+   {
+      m_cumulWeights[ i + 1 ] = m_cumulWeights[ i ] + m_weights[ i ];
+      m_cumulWeightedSamples[ i + 1 ] = m_cumulWeightedSamples[ i ] + m_weights[ i ] * m_sampling[ i ];
+   }
+
+   if ( const GaussPdf* gauss = dynamic_cast< const GaussPdf* >( m_kernel.get() ) )
+   {
+      m_kernelType = GaussKernel;
+      m_kernelMinX = gauss->getMu() - gaussSupportSigmas * gauss->getSigma();
+      m_kernelMaxX = gauss->getMu() + gaussSupportSigmas * gauss->getSigma();
+   }
+   else if ( dynamic_cast< const UniformPdf* >( m_kernel.get() ) )
+   {
+      m_kernelType = UniformKernel;
+      m_kernelMinX = m_kernel->getMinX();
+      m_kernelMaxX = m_kernel->getMaxX();
+   }
+   else
+   {
+      m_kernelType = GenericKernel;
+      m_kernelMinX = m_kernel->getMinX();
+      m_kernelMaxX = m_kernel->getMaxX();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getDensity
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 double KernelPdf::getDensity( double x ) const
 {
    double val = 0;
@@ -35,11 +114,17 @@ double KernelPdf::getDensity( double x ) const
    return val;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getProbability
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 double KernelPdf::getProbability( double x0, double x1 ) const
 {
    return getIntegral( x1 ) - getIntegral( x0 );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getIntegral
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 double KernelPdf::getIntegral( double x ) const
 {
    double integral = 0;
@@ -50,5 +135,211 @@ double KernelPdf::getIntegral( double x ) const
    return integral;
 }
 
-} /// namespace Math
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getDensityMany
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RealVector KernelPdf::getDensityMany( const RealVector& sortedX ) const
+{
+   RealVector result( sortedX.size() );
+   switch ( m_kernelType )
+   {
+      case GaussKernel:
+         getDensityManyGauss( sortedX, result );
+         break;
+      case UniformKernel:
+         getDensityManyUniform( sortedX, result );
+         break;
+      default:
+         getDensityManyGeneric( sortedX, result );
+   }
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getIntegralMany
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RealVector KernelPdf::getIntegralMany( const RealVector& sortedX ) const
+{
+   RealVector result( sortedX.size() );
+   switch ( m_kernelType )
+   {
+      case GaussKernel:
+         getIntegralManyGauss( sortedX, result );
+         break;
+      case UniformKernel:
+         getIntegralManyUniform( sortedX, result );
+         break;
+      default:
+         getIntegralManyGeneric( sortedX, result );
+   }
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getGaussSupportSigmas
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double KernelPdf::getGaussSupportSigmas()
+{
+   return gaussSupportSigmas;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getDensityManyGauss
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void KernelPdf::getDensityManyGauss( const RealVector& sortedX, RealVector& result ) const
+{
+   const GaussPdf& gauss = static_cast< const GaussPdf& >( *m_kernel );
+   const double mu = gauss.getMu();
+   const double argFac = -0.5 / ( gauss.getSigma() * gauss.getSigma() );
+   const double norm = 1 / sqrt( 2 * M_PI ) / gauss.getSigma();
+
+   const double* sampling = m_sampling.data();
+   const double* weights = m_weights.data();
+
+   size_t iFirst = 0;
+   size_t iLast = 0;
+   for ( size_t iX = 0; iX < sortedX.size(); ++iX )
+   {
+      assert( iX == 0 || sortedX[ iX ] >= sortedX[ iX - 1 ] );
+
+      /// Only samples within the effective support contribute.
+      const double x = sortedX[ iX ];
+      iFirst = advanceLowerBound( m_sampling, iFirst, x - m_kernelMaxX );
+      iLast = advanceUpperBound( m_sampling, iLast, x - m_kernelMinX );
 
+      double val = 0;
+      for ( size_t i = iFirst; i < iLast; ++i )
+      {
+         const double arg = x - sampling[ i ] - mu;
+         val += weights[ i ] * exp( argFac * arg * arg );
+      }
+      result[ iX ] = norm * val;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getIntegralManyGauss
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void KernelPdf::getIntegralManyGauss( const RealVector& sortedX, RealVector& result ) const
+{
+   const GaussPdf& gauss = static_cast< const GaussPdf& >( *m_kernel );
+   const double mu = gauss.getMu();
+   const double erfArgFac = 1.0 / ( sqrt( 2.0 ) * gauss.getSigma() );
+
+   const double* sampling = m_sampling.data();
+   const double* weights = m_weights.data();
+
+   size_t iFirst = 0;
+   size_t iLast = 0;
+   for ( size_t iX = 0; iX < sortedX.size(); ++iX )
+   {
+      assert( iX == 0 || sortedX[ iX ] >= sortedX[ iX - 1 ] );
+
+      /// Samples left of the effective support contribute their full weight, samples right of it nothing.
+      const double x = sortedX[ iX ];
+      iFirst = advanceLowerBound( m_sampling, iFirst, x - m_kernelMaxX );
+      iLast = advanceUpperBound( m_sampling, iLast, x - m_kernelMinX );
+
+      double val = 0;
+      for ( size_t i = iFirst; i < iLast; ++i )
+      {
+         val += weights[ i ] * erf( ( x - sampling[ i ] - mu ) * erfArgFac );
+      }
+      result[ iX ] = m_cumulWeights[ iFirst ] + 0.5 * ( m_cumulWeights[ iLast ] - m_cumulWeights[ iFirst ] ) + 0.5 * val;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getDensityManyUniform
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void KernelPdf::getDensityManyUniform( const RealVector& sortedX, RealVector& result ) const
+{
+   const double density = 1 / ( m_kernelMaxX - m_kernelMinX );
+
+   size_t iFirst = 0;
+   size_t iLast = 0;
+   for ( size_t iX = 0; iX < sortedX.size(); ++iX )
+   {
+      assert( iX == 0 || sortedX[ iX ] >= sortedX[ iX - 1 ] );
+
+      const double x = sortedX[ iX ];
+      iFirst = advanceLowerBound( m_sampling, iFirst, x - m_kernelMaxX );
+      iLast = advanceUpperBound( m_sampling, iLast, x - m_kernelMinX );
+
+      result[ iX ] = density * ( m_cumulWeights[ iLast ] - m_cumulWeights[ iFirst ] );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getIntegralManyUniform
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void KernelPdf::getIntegralManyUniform( const RealVector& sortedX, RealVector& result ) const
+{
+   const double density = 1 / ( m_kernelMaxX - m_kernelMinX );
+
+   size_t iFirst = 0;
+   size_t iLast = 0;
+   for ( size_t iX = 0; iX < sortedX.size(); ++iX )
+   {
+      assert( iX == 0 || sortedX[ iX ] >= sortedX[ iX - 1 ] );
+
+      /// Within the support the integral is linear in x - x_i, so the sum follows from the cumulative sums.
+      const double x = sortedX[ iX ];
+      iFirst = advanceLowerBound( m_sampling, iFirst, x - m_kernelMaxX );
+      iLast = advanceUpperBound( m_sampling, iLast, x - m_kernelMinX );
+
+      const double sumWeights = m_cumulWeights[ iLast ] - m_cumulWeights[ iFirst ];
+      const double sumWeightedSamples = m_cumulWeightedSamples[ iLast ] - m_cumulWeightedSamples[ iFirst ];
+      result[ iX ] = m_cumulWeights[ iFirst ] + density * ( ( x - m_kernelMinX ) * sumWeights - sumWeightedSamples );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getDensityManyGeneric
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void KernelPdf::getDensityManyGeneric( const RealVector& sortedX, RealVector& result ) const
+{
+   size_t iFirst = 0;
+   size_t iLast = 0;
+   for ( size_t iX = 0; iX < sortedX.size(); ++iX )
+   {
+      assert( iX == 0 || sortedX[ iX ] >= sortedX[ iX - 1 ] );
+
+      const double x = sortedX[ iX ];
+      iFirst = advanceLowerBound( m_sampling, iFirst, x - m_kernelMaxX );
+      iLast = advanceUpperBound( m_sampling, iLast, x - m_kernelMinX );
+
+      double val = 0;
+      for ( size_t i = iFirst; i < iLast; ++i )
+      {
+         val += m_weights[ i ] * m_kernel->getDensity( x - m_sampling[ i ] );
+      }
+      result[ iX ] = val;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getIntegralManyGeneric
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void KernelPdf::getIntegralManyGeneric( const RealVector& sortedX, RealVector& result ) const
+{
+   size_t iFirst = 0;
+   size_t iLast = 0;
+   for ( size_t iX = 0; iX < sortedX.size(); ++iX )
+   {
+      assert( iX == 0 || sortedX[ iX ] >= sortedX[ iX - 1 ] );
+
+      const double x = sortedX[ iX ];
+      iFirst = advanceLowerBound( m_sampling, iFirst, x - m_kernelMaxX );
+      iLast = advanceUpperBound( m_sampling, iLast, x - m_kernelMinX );
+
+      double val = m_cumulWeights[ iFirst ];
+      for ( size_t i = iFirst; i < iLast; ++i )
+      {
+         val += m_weights[ i ] * m_kernel->getIntegral( x - m_sampling[ i ] );
+      }
+      result[ iX ] = val;
+   }
+}
+
+} /// namespace Math
@@ -7,6 +7,22 @@
 namespace Math
 {
 
+/**
+ * @class KernelPdf
+ * @brief Kernel density estimate: weighted sum of a kernel PDF placed at each of the sample points.
+ *
+ * Besides the point-wise IPdf interface, the class provides batch evaluation on sorted grids of x values
+ * (@see getDensityMany and @see getIntegralMany). These exploit that the sample points are stored sorted and that the
+ * kernel has a finite (effective) support, so that only the samples within the support of a query point are visited.
+ * Gauss and uniform kernels are evaluated in tight loops without virtual calls that can be vectorised by the compiler;
+ * other kernels fall back to the IPdf interface within the bounds getMinX and getMaxX of the kernel.
+ *
+ * Error bound of the batch evaluation with a Gauss kernel (sigma): samples further away than
+ * getGaussSupportSigmas() * sigma = n * sigma are neglected. As the weights are normalised to unity, the absolute error
+ * on the density is at most exp( -n^2 / 2 ) / ( sqrt( 2 pi ) sigma ), i.e. exp( -n^2 / 2 ) = 1.3e-14 times the peak
+ * density of a single kernel for n = 8. The absolute error on the integral is at most 0.5 * erfc( n / sqrt( 2 ) ),
+ * which is 6.2e-16 for n = 8. Batch evaluation with a uniform kernel is exact up to rounding.
+ */
 class KernelPdf : public IPdf
 {
    public:
@@ -22,10 +38,65 @@ class KernelPdf : public IPdf
       double getProbability( double x0, double x1 ) const;
       double getIntegral( double x ) const;
 
+   /**
+    * Batch evaluation. The values in @param sortedX should be sorted in ascending order.
+    */
+   public:
+      /**
+       * Evaluate the density at all points @param sortedX.
+       */
+      RealVector getDensityMany( const RealVector& sortedX ) const;
+      /**
+       * Evaluate the integral from -inf at all points @param sortedX.
+       */
+      RealVector getIntegralMany( const RealVector& sortedX ) const;
+
+      /**
+       * Number of sigmas beyond which Gauss kernels are neglected in batch evaluation.
+       */
+      static double getGaussSupportSigmas();
+
+   private:
+      /**
+       * Sort sampling and weights by sample position and calculate the derived quantities for batch evaluation.
+       */
+      void initialise();
+
+      /**
+       * Kernel specific implementations of batch evaluation.
+       */
+      void getDensityManyGauss( const RealVector& sortedX, RealVector& result ) const;
+      void getIntegralManyGauss( const RealVector& sortedX, RealVector& result ) const;
+      void getDensityManyUniform( const RealVector& sortedX, RealVector& result ) const;
+      void getIntegralManyUniform( const RealVector& sortedX, RealVector& result ) const;
+      void getDensityManyGeneric( const RealVector& sortedX, RealVector& result ) const;
+      void getIntegralManyGeneric( const RealVector& sortedX, RealVector& result ) const;
+
+   private:
+      /**
+       * Kernel types that have a dedicated batch implementation.
+       */
+      enum KernelType
+      {
+         GenericKernel = 0,
+         GaussKernel,
+         UniformKernel
+      };
+
    private:
       IPdf::CPtr           m_kernel;
-      RealVector           m_sampling;
-      RealVector           m_weights;
+      RealVector           m_sampling;             //! Sample positions (sorted).
+      RealVector           m_weights;              //! Weights (normalised, sorted along with m_sampling).
+
+   /**
+    * Derived quantities for batch evaluation.
+    */
+   private:
+      KernelType           m_kernelType;           //! Type of the kernel.
+      double               m_kernelMinX;           //! Left bound of the (effective) kernel support.
+      double               m_kernelMaxX;           //! Right bound of the (effective) kernel support.
+      RealVector           m_cumulWeights;         //! Cumulative weights, m_cumulWeights[ i ] = sum_{j<i} w_j.
+      RealVector           m_cumulWeightedSamples; //! Cumulative weighted sampling, sum_{j<i} w_j * x_j.
 };
 
 } /// namespace Math
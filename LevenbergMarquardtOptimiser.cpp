@@ -0,0 +1,258 @@
+#include "LevenbergMarquardtOptimiser.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+/// Anonymous namespace
+namespace
+{
+   /// Damping above which a step is considered impossible; the gradient step is then below numerical precision.
+   const double maxDamping = 1e16;
+   /// Lower bound of the damping, so that it can grow back quickly after a rejected step.
+   const double minDamping = 1e-12;
+}
+
+namespace Math
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+LevenbergMarquardtOptimiser::LevenbergMarquardtOptimiser( const Chi2FitObjective& objFunc, const std::string& algorithmName, const AlgorithmBase* parent ) :
+   AlgorithmBase( algorithmName, parent ),
+   m_objFunc( objFunc ),
+   m_maxIterations( 100 ),
+   m_minGradModulus( 0 ),
+   m_minRelChi2Change( 1e-10 ),
+   m_initialDamping( 1e-3 ),
+   m_numIterations( 0 ),
+   m_numEvaluations( 0 ),
+   m_chi2( 0 )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// solve
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RealVector LevenbergMarquardtOptimiser::solve( RealVector startValue ) const
+{
+   RealVector& solutionHypothesis = startValue;
+   const size_t numParameters = solutionHypothesis.size();
+   const size_t numPoints = m_objFunc.getNumPoints();
+
+   RealVector residuals;
+   RealVector trialResiduals;
+   RealVector jacobian;
+   RealVector jtj( numParameters * numParameters );
+   RealVector jtr( numParameters );
+   RealVector dampedJtj( numParameters * numParameters );
+   RealVector step( numParameters );
+   RealVector trial( numParameters );
+
+   m_objFunc.calculateResiduals( solutionHypothesis, residuals );
+   m_chi2 = residuals * residuals;
+   m_numEvaluations = 1;
+   m_numIterations = 0;
+   double lambda = m_initialDamping;
+
+   while ( m_numIterations < m_maxIterations )
+   {
+      getLogger() << Msg::Debug << "Iteration " << m_numIterations << ", chi2 = " << m_chi2 << ", lambda = " << lambda << Msg::EndReq;
+
+      m_objFunc.calculateJacobian( solutionHypothesis, residuals, jacobian );
+      ++m_numIterations;
+      if ( !m_objFunc.hasParameterGradient() )
+      {
+         /// The finite difference Jacobian evaluates the residuals once per parameter.
+         m_numEvaluations += numParameters;
+      }
+
+      /// Normal equations: J^T J (lower triangle first) and J^T r.
+      std::fill( jtj.begin(), jtj.end(), 0 );
+      std::fill( jtr.begin(), jtr.end(), 0 );
+      for ( size_t iPoint = 0; iPoint < numPoints; ++iPoint )
+      {
+         const double* row = &jacobian[ iPoint * numParameters ];
+         for ( size_t i = 0; i < numParameters; ++i )
+         {
+            jtr[ i ] += row[ i ] * residuals[ iPoint ];
+            for ( size_t j = 0; j <= i; ++j )
+            {
+               jtj[ i * numParameters + j ] += row[ i ] * row[ j ];
+            }
+         }
+      }
+      for ( size_t i = 0; i < numParameters; ++i )
+      {
+         for ( size_t j = 0; j < i; ++j )
+         {
+            jtj[ j * numParameters + i ] = jtj[ i * numParameters + j ];
+         }
+      }
+
+      /// The chi2 gradient is 2 J^T r.
+      if ( 4 * ( jtr * jtr ) < m_minGradModulus )
+      {
+         getLogger() << Msg::Debug << "Gradient convergence criterion met." << Msg::EndReq;
+         break;
+      }
+
+      bool accepted = false;
+      double relChi2Change = 0;
+      while ( lambda <= maxDamping )
+      {
+         dampedJtj = jtj;
+         for ( size_t i = 0; i < numParameters; ++i )
+         {
+            dampedJtj[ i * numParameters + i ] += lambda * std::max( jtj[ i * numParameters + i ], minDamping );
+            step[ i ] = -jtr[ i ];
+         }
+
+         if ( solveCholesky( dampedJtj, step, numParameters ) )
+         {
+            trial = solutionHypothesis;
+            trial += step;
+            m_objFunc.calculateResiduals( trial, trialResiduals );
+            ++m_numEvaluations;
+            double trialChi2 = trialResiduals * trialResiduals;
+
+            getLogger() << Msg::Verbose << "lambda = " << lambda << ", trial chi2 = " << trialChi2 << Msg::EndReq;
+
+            if ( trialChi2 < m_chi2 )
+            {
+               relChi2Change = ( m_chi2 - trialChi2 ) / m_chi2;
+               solutionHypothesis.swap( trial );
+               residuals.swap( trialResiduals );
+               m_chi2 = trialChi2;
+               lambda = std::max( lambda / 10, minDamping );
+               accepted = true;
+               break;
+            }
+         }
+         lambda *= 10;
+      }
+
+      if ( !accepted )
+      {
+         getLogger() << Msg::Debug << "No step lowers chi2 any further." << Msg::EndReq;
+         break;
+      }
+      if ( relChi2Change < m_minRelChi2Change )
+      {
+         getLogger() << Msg::Debug << "Minimum relative chi2 change criterion met." << Msg::EndReq;
+         break;
+      }
+   }
+
+   getLogger() << Msg::Debug << "chi2 = " << m_chi2 << " after " << m_numIterations << " iterations and " << m_numEvaluations << " evaluations." << Msg::EndReq;
+   return solutionHypothesis;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// setMaxIterations
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void LevenbergMarquardtOptimiser::setMaxIterations( size_t maxIterations )
+{
+   m_maxIterations = maxIterations;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// setMinGradLength
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void LevenbergMarquardtOptimiser::setMinGradLength( double minGradLength )
+{
+   m_minGradModulus = minGradLength * minGradLength;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// setMinRelChi2Change
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void LevenbergMarquardtOptimiser::setMinRelChi2Change( double minRelChi2Change )
+{
+   m_minRelChi2Change = minRelChi2Change;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// setInitialDamping
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void LevenbergMarquardtOptimiser::setInitialDamping( double lambda )
+{
+   m_initialDamping = lambda;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumIterations
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t LevenbergMarquardtOptimiser::getNumIterations() const
+{
+   return m_numIterations;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumEvaluations
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t LevenbergMarquardtOptimiser::getNumEvaluations() const
+{
+   return m_numEvaluations;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getChi2
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double LevenbergMarquardtOptimiser::getChi2() const
+{
+   return m_chi2;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// solveCholesky
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool LevenbergMarquardtOptimiser::solveCholesky( RealVector& a, RealVector& b, size_t n )
+{
+   /// Decompose a = L L^T in place (lower triangle).
+   for ( size_t j = 0; j < n; ++j )
+   {
+      double diag = a[ j * n + j ];
+      for ( size_t k = 0; k < j; ++k )
+      {
+         diag -= a[ j * n + k ] * a[ j * n + k ];
+      }
+      if ( !( diag > 0 ) )
+      {
+         return false;
+      }
+      diag = sqrt( diag );
+      a[ j * n + j ] = diag;
+      for ( size_t i = j + 1; i < n; ++i )
+      {
+         double sum = a[ i * n + j ];
+         for ( size_t k = 0; k < j; ++k )
+         {
+            sum -= a[ i * n + k ] * a[ j * n + k ];
+         }
+         a[ i * n + j ] = sum / diag;
+      }
+   }
+
+   /// Forward substitution L y = b, then back substitution L^T x = y.
+   for ( size_t i = 0; i < n; ++i )
+   {
+      for ( size_t k = 0; k < i; ++k )
+      {
+         b[ i ] -= a[ i * n + k ] * b[ k ];
+      }
+      b[ i ] /= a[ i * n + i ];
+   }
+   for ( size_t i = n; i-- > 0; )
+   {
+      for ( size_t k = i + 1; k < n; ++k )
+      {
+         b[ i ] -= a[ k * n + i ] * b[ k ];
+      }
+      b[ i ] /= a[ i * n + i ];
+   }
+   return true;
+}
+
+} /// namespace Math
@@ -0,0 +1,88 @@
+#ifndef LEVENBERGMARQUARDTOPTIMISER_H
+#define LEVENBERGMARQUARDTOPTIMISER_H
+
+#include "AlgorithmBase.h"
+#include "Chi2FitObjective.h"
+
+namespace Math
+{
+
+/**
+ * @class LevenbergMarquardtOptimiser
+ * @brief Least-squares minimiser of the chi2 of a Chi2FitObjective with the Levenberg-Marquardt algorithm.
+ *
+ * Unlike the general gradient descent optimisers, it works on the residual vector and its Jacobian (@see
+ * Chi2FitObjective::calculateJacobian). Every iteration solves the damped normal equations
+ *
+ *    ( J^T J + lambda * diag( J^T J ) ) dp = -J^T r
+ *
+ * The damping lambda is decreased after a step that lowers chi2 (towards Gauss-Newton) and increased after a rejected
+ * step (towards scaled gradient descent), which follows the curved valleys of typical peak-shape fits in few steps.
+ */
+class LevenbergMarquardtOptimiser : public AlgorithmBase
+{
+   public:
+      /**
+       * Minimise @param objFunc (@see AlgorithmBase).
+       */
+      LevenbergMarquardtOptimiser( const Chi2FitObjective& objFunc, const std::string& algorithmName = "LevenbergMarquardtOptimiser", const AlgorithmBase* parent = 0 );
+
+      /**
+       * Solve the problem.
+       */
+      RealVector solve( RealVector startValue ) const;
+
+   public:
+      /**
+       * Set the maximum number of iterations.
+       */
+      void setMaxIterations( size_t maxIterations );
+      /**
+       * Sets the convergence criterion: minimum length of the chi2 gradient.
+       */
+      void setMinGradLength( double minGradLength );
+      /**
+       * Set the convergence criterion: minimum relative chi2 change of an accepted step.
+       */
+      void setMinRelChi2Change( double minRelChi2Change );
+      /**
+       * Set the damping of the first iteration.
+       */
+      void setInitialDamping( double lambda );
+
+   public:
+      /**
+       * Get the number of iterations (Jacobian evaluations) of the last solve.
+       */
+      size_t getNumIterations() const;
+      /**
+       * Get the number of residual (chi2) evaluations of the last solve. Without an exact parameter gradient of the fit
+       * function, this includes the evaluations for the finite difference Jacobian (one per parameter and iteration).
+       */
+      size_t getNumEvaluations() const;
+      /**
+       * Get the chi2 at the solution of the last solve.
+       */
+      double getChi2() const;
+
+   private:
+      /**
+       * Solve the symmetric positive definite system @param a x = @param b of size @param n (a row-major) with a
+       * Cholesky decomposition. The solution is written to @param b. @return false if @param a is not positive definite.
+       */
+      static bool solveCholesky( RealVector& a, RealVector& b, size_t n );
+
+   private:
+      const Chi2FitObjective&       m_objFunc;              //! The fit objective to be minimised.
+      size_t                        m_maxIterations;        //! The maximum number of iterations.
+      double                        m_minGradModulus;       //! The minimum gradient modulus.
+      double                        m_minRelChi2Change;     //! The minimum relative chi2 change.
+      double                        m_initialDamping;       //! The damping of the first iteration.
+      mutable size_t                m_numIterations;        //! Number of iterations of the last solve.
+      mutable size_t                m_numEvaluations;       //! Number of residual evaluations of the last solve, incl. the Jacobian.
+      mutable double                m_chi2;                 //! Chi2 at the solution of the last solve.
+};
+
+} /// namespace Math
+
+#endif // LEVENBERGMARQUARDTOPTIMISER_H
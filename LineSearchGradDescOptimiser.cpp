@@ -29,6 +29,7 @@ RealVector LineSearchGradDescOptimiser::solve( RealVector startValue ) const
 
    double objFuncValChange = std::numeric_limits< double >::max();
    double objFuncVal = m_objFunc.evaluate( solutionHypothesis );
+   RealVector x( solutionHypothesis.size() );
 
    for ( size_t iIter = 0; iIter < m_maxIterations; ++iIter )
    {
@@ -53,7 +54,9 @@ RealVector LineSearchGradDescOptimiser::solve( RealVector startValue ) const
       size_t nLineSearchIter = 0;
       while ( true )
       {
-         const RealVector& x = solutionHypothesis - gradient * alpha;
+         /// x = solutionHypothesis - alpha * gradient, in the storage of the previous trial point.
+         x = solutionHypothesis;
+         addScaled( x, -alpha, gradient );
          double lhs = m_objFunc.evaluate( x );
          double rhs = objFuncVal + m_c1 * alpha * gradientModulus;
 
@@ -61,7 +64,7 @@ RealVector LineSearchGradDescOptimiser::solve( RealVector startValue ) const
 
          if ( lhs <= rhs )
          {
-            solutionHypothesis = x;
+            solutionHypothesis.swap( x );
             break;
          }
 
@@ -2,6 +2,9 @@
 
 #include "SortCache.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace Math
 {
 
@@ -18,6 +21,29 @@ LinearInterpolator::LinearInterpolator( const RealVector& x, const RealVector& y
    m_y = sc.applyTo( y );
 
    m_xWidth = m_x.back() - m_x.front();
+
+   /// Precalculate the slopes, so that interpolation needs no division.
+   bool isUniform = m_x.size() > 1 && m_xWidth > 0;
+   const double step = m_x.size() > 1 ? m_xWidth / ( m_x.size() - 1 ) : 0;
+   m_slope.assign( m_x.size() > 1 ? m_x.size() - 1 : 0, 0 );
+   for ( size_t i = 0; i + 1 < m_x.size(); ++i )
+   {
+      double dX = m_x[ i + 1 ] - m_x[ i ];
+      if ( dX >= 1e-16 )
+      {
+         m_slope[ i ] = ( m_y[ i + 1 ] - m_y[ i ] ) / dX;
+      }
+      isUniform = isUniform && fabs( dX - step ) <= 1e-9 * step;
+   }
+   m_invStep = isUniform ? 1 / step : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// interpolateInInterval
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline double LinearInterpolator::interpolateInInterval( double x, size_t iInterval ) const
+{
+   return m_y[ iInterval ] + m_slope[ iInterval ] * ( x - m_x[ iInterval ] );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -34,8 +60,73 @@ double LinearInterpolator::operator()( double x ) const
       return m_y.back();
    }
 
-   size_t iInterval = findInterval( x );
-   return interpolate( x, m_x[ iInterval ], m_x[ iInterval + 1 ], m_y[ iInterval ], m_y[ iInterval + 1 ] );
+   if ( m_invStep > 0 )
+   {
+      return interpolateInInterval( x, std::min( static_cast< size_t >( ( x - m_x.front() ) * m_invStep ), m_x.size() - 2 ) );
+   }
+   return interpolateInInterval( x, findInterval( x ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// evalMany
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RealVector LinearInterpolator::evalMany( const RealVector& argVec ) const
+{
+   RealVector result( argVec.size() );
+   if ( m_x.size() < 2 )
+   {
+      std::fill( result.begin(), result.end(), m_y.front() );
+      return result;
+   }
+
+   const double xFront = m_x.front();
+   const double xBack = m_x.back();
+   const size_t lastInterval = m_x.size() - 2;
+
+   /// Uniform spacing: the interval follows from the position, no branches in the loop.
+   if ( m_invStep > 0 )
+   {
+      for ( size_t i = 0; i < argVec.size(); ++i )
+      {
+         double x = std::min( std::max( argVec[ i ], xFront ), xBack );
+         size_t iInterval = std::min( static_cast< size_t >( ( x - xFront ) * m_invStep ), lastInterval );
+         result[ i ] = interpolateInInterval( x, iInterval );
+      }
+      return result;
+   }
+
+   if ( !std::is_sorted( argVec.begin(), argVec.end() ) )
+   {
+      for ( size_t i = 0; i < argVec.size(); ++i )
+      {
+         result[ i ] = ( *this )( argVec[ i ] );
+      }
+      return result;
+   }
+
+   /// Sorted points: the interval only moves forward, so walk a cursor along with the points.
+   size_t iInterval = 0;
+   for ( size_t i = 0; i < argVec.size(); ++i )
+   {
+      double x = argVec[ i ];
+      if ( x <= xFront )
+      {
+         result[ i ] = m_y.front();
+      }
+      else if ( x >= xBack )
+      {
+         result[ i ] = m_y.back();
+      }
+      else
+      {
+         while ( m_x[ iInterval + 1 ] <= x )
+         {
+            ++iInterval;
+         }
+         result[ i ] = interpolateInInterval( x, iInterval );
+      }
+   }
+   return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -76,6 +167,14 @@ size_t LinearInterpolator::findInterval( double x ) const
    return intervalIndex;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// isUniform
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool LinearInterpolator::isUniform() const
+{
+   return m_invStep > 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// clone
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
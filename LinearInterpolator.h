@@ -9,6 +9,10 @@ namespace Math
 /**
  * @class LinearInterpolator
  * @brief Function that linearly interpolates between points in a data set.
+ *
+ * If the points are uniformly spaced, the interval of a point is calculated directly instead of searched. evalMany
+ * walks a cursor through the intervals if the evaluation points are sorted, so that evaluating n sorted points costs
+ * O(n + number of data points) instead of a search per point.
  */
 class LinearInterpolator : public IRealFunction
 {
@@ -22,11 +26,20 @@ class LinearInterpolator : public IRealFunction
        * @see IRealFunction
        */
       double operator()( double x ) const;
+      /**
+       * @see IRealFunction
+       */
+      RealVector evalMany( const RealVector& argVec ) const;
       /**
        * @see IRealFunction
        */
       IRealFunction* clone() const;
 
+      /**
+       * Check whether the data points are uniformly spaced, i.e. intervals are found in constant time.
+       */
+      bool isUniform() const;
+
       /**
        * Interpolate between points x0 and x1 at point x (x0 <= x <= x1).
        */
@@ -38,11 +51,17 @@ class LinearInterpolator : public IRealFunction
        * Find the interval in which @param x is contained.
        */
       virtual size_t findInterval( double x ) const;
+      /**
+       * Interpolate at @param x in interval @param iInterval, with the precalculated slope.
+       */
+      double interpolateInInterval( double x, size_t iInterval ) const;
 
    private:
-      RealVector        m_x;        //! Sorted input.
-      RealVector        m_y;        //! Output sorted along with m_x.
-      double            m_xWidth;   //! Interval size of m_x.
+      RealVector        m_x;           //! Sorted input.
+      RealVector        m_y;           //! Output sorted along with m_x.
+      RealVector        m_slope;       //! Slope of every interval, zero for intervals of zero width.
+      double            m_xWidth;      //! Interval size of m_x.
+      double            m_invStep;     //! Inverse distance between the points if uniformly spaced, zero otherwise.
 };
 
 } /// namespace Math
@@ -1,6 +1,7 @@
 #include "McmcOptimiser.h"
 
 #include "Logger.h"
+#include "WorkerPool.h"
 
 namespace Math
 {
@@ -18,23 +19,28 @@ McmcOptimiser::McmcOptimiser( const IObjectiveFunction& objFunc ) :
    m_stepDecrease( 0.9 ),
    m_effLow( 0.23 ),
    m_effHigh( 0.45 ),
-   m_random( 10 )
+   m_seed( 10 ),
+   m_random( m_seed ),
+   m_numThreads( 0 )
 {
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// destructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+McmcOptimiser::~McmcOptimiser()
+{}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// setStartValues
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void McmcOptimiser::setStartValues( const RealVectorEnsemble& startValues )
 {
    m_mcmcChains = startValues;
-   m_probOld.resize( m_mcmcChains.size() );
-   for ( size_t i = 0; i < m_mcmcChains.size(); ++i )
-   {
-      m_probOld[ i ] = m_objFunc.evaluate( m_mcmcChains[ i ] );
-   }
+   m_probOld = m_objFunc.evaluateBatch( m_mcmcChains );
    m_numAccepted.assign( m_mcmcChains.size(), 0 );
    setStepSize( 1 );
+   resetChainRandom();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -53,22 +59,72 @@ void McmcOptimiser::setNumIterations( size_t numIterations )
    m_numIterations = numIterations;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// setSeed
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void McmcOptimiser::setSeed( size_t seed )
+{
+   m_seed = seed;
+   m_random = RandomNumberGenerator( seed );
+   resetChainRandom();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// setNumThreads
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void McmcOptimiser::setNumThreads( size_t numThreads )
+{
+   m_numThreads = numThreads;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// solve
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 RealVectorEnsemble McmcOptimiser::solve()
 {
    RealVectorEnsemble solutions;
+   if ( m_numThreads > 0 )
+   {
+      /// Independent chains; every task only touches the state of its own chain.
+      if ( !m_workerPool || m_workerPool->getNumThreads() != m_numThreads )
+      {
+         m_workerPool.reset( new WorkerPool( m_numThreads ) );
+      }
+      std::vector< RealVectorEnsemble > chainSamples( m_mcmcChains.size() );
+      m_workerPool->run( m_mcmcChains.size(), [ this, &chainSamples ]( size_t iChain )
+      {
+         runChain( iChain, chainSamples[ iChain ] );
+      } );
+
+      /// Merge iteration by iteration, as in the lockstep mode.
+      const size_t numSamplesPerChain = chainSamples.empty() ? 0 : chainSamples[ 0 ].size();
+      solutions.reserve( numSamplesPerChain * chainSamples.size() );
+      for ( size_t iSample = 0; iSample < numSamplesPerChain; ++iSample )
+      {
+         for ( size_t iChain = 0; iChain < chainSamples.size(); ++iChain )
+         {
+            solutions.push_back( chainSamples[ iChain ][ iSample ] );
+         }
+      }
+      return solutions;
+   }
+
+   /// The proposals of all chains are evaluated as one batch.
+   RealVectorEnsemble proposals( m_mcmcChains.size() );
    for ( size_t iIter = 0; iIter < m_numIterations + m_burnInSkip; ++iIter )
    {
       for ( size_t iChain = 0; iChain < m_mcmcChains.size(); ++iChain )
       {
-         const RealVector& x = proposeNew( m_mcmcChains[ iChain ], m_stepSizeVec[ iChain ] );
+         proposals[ iChain ] = proposeNew( m_mcmcChains[ iChain ], m_stepSizeVec[ iChain ], m_random );
+      }
+      const RealVector& probNewVec = m_objFunc.evaluateBatch( proposals );
 
-         double probNew = m_objFunc.evaluate( x );
-         if ( accept( probNew, m_probOld[ iChain ] ) )
+      for ( size_t iChain = 0; iChain < m_mcmcChains.size(); ++iChain )
+      {
+         double probNew = probNewVec[ iChain ];
+         if ( accept( probNew, m_probOld[ iChain ], m_random ) )
          {
-            m_mcmcChains[ iChain ] = x;
+            m_mcmcChains[ iChain ] = proposals[ iChain ];
             m_probOld[ iChain ] = probNew;
             m_numAccepted[ iChain ] += 1;
          }
@@ -85,15 +141,56 @@ RealVectorEnsemble McmcOptimiser::solve()
    return solutions;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// resetChainRandom
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void McmcOptimiser::resetChainRandom()
+{
+   m_chainRandom.clear();
+   for ( size_t iChain = 0; iChain < m_mcmcChains.size(); ++iChain )
+   {
+      m_chainRandom.push_back( RandomNumberGenerator( m_seed, iChain + 1 ) );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// runChain
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void McmcOptimiser::runChain( size_t iChain, RealVectorEnsemble& samples )
+{
+   RandomNumberGenerator& random = m_chainRandom[ iChain ];
+   for ( size_t iIter = 0; iIter < m_numIterations + m_burnInSkip; ++iIter )
+   {
+      const RealVector& x = proposeNew( m_mcmcChains[ iChain ], m_stepSizeVec[ iChain ], random );
+
+      double probNew = m_objFunc.evaluate( x );
+      if ( accept( probNew, m_probOld[ iChain ], random ) )
+      {
+         m_mcmcChains[ iChain ] = x;
+         m_probOld[ iChain ] = probNew;
+         m_numAccepted[ iChain ] += 1;
+      }
+      if ( iIter > m_burnInSkip )
+      {
+         samples.push_back( m_mcmcChains[ iChain ] );
+      }
+      if ( ( iIter % m_numIterStepUpdate ) == 0 )
+      {
+         updateStepSize( iChain );
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// proposeNew
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-RealVector McmcOptimiser::proposeNew( const RealVector& x, double stepSize )
+RealVector McmcOptimiser::proposeNew( const RealVector& x, double stepSize, RandomNumberGenerator& random )
 {
-   RealVector result( x );
+   RealVector result( x.size() );
+   random.fillUniform( result.data(), result.size(), -stepSize * stepSize, stepSize * stepSize );
    for ( size_t i = 0; i < x.size(); ++i )
    {
-      result[ i ] += stepSize * m_random.uniform( -1, 1 ) * stepSize;
+      result[ i ] += x[ i ];
    }
    return result;
 }
@@ -101,7 +198,7 @@ RealVector McmcOptimiser::proposeNew( const RealVector& x, double stepSize )
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// accept
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-bool McmcOptimiser::accept( double probNew, double probOld )
+bool McmcOptimiser::accept( double probNew, double probOld, RandomNumberGenerator& random )
 {
    if ( probNew > probOld )
    {
@@ -109,7 +206,7 @@ bool McmcOptimiser::accept( double probNew, double probOld )
    }
    else
    {
-      return m_random.uniform( 0, probOld ) < probNew;
+      return random.uniform( 0, probOld ) < probNew;
    }
 }
 
@@ -120,17 +217,25 @@ void McmcOptimiser::updateStepSize()
 {
    for ( size_t i = 0; i < m_stepSizeVec.size(); ++i )
    {
-      double eff = static_cast< double >( m_numAccepted[ i ] ) / m_numIterStepUpdate;
-      if ( eff < m_effLow )
-      {
-         m_stepSizeVec[ i ] *= m_stepDecrease;
-      }
-      else if ( eff > m_effHigh )
-      {
-         m_stepSizeVec[ i ] *= m_stepIncrease;
-      }
-      m_numAccepted[ i ] = 0;
+      updateStepSize( i );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// updateStepSize
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void McmcOptimiser::updateStepSize( size_t iChain )
+{
+   double eff = static_cast< double >( m_numAccepted[ iChain ] ) / m_numIterStepUpdate;
+   if ( eff < m_effLow )
+   {
+      m_stepSizeVec[ iChain ] *= m_stepDecrease;
+   }
+   else if ( eff > m_effHigh )
+   {
+      m_stepSizeVec[ iChain ] *= m_stepIncrease;
    }
+   m_numAccepted[ iChain ] = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
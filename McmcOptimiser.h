@@ -5,6 +5,10 @@
 #include "RandomNumberGenerator.h"
 #include "RealVector.h"
 
+#include <memory>
+
+class WorkerPool;
+
 namespace Math
 {
 
@@ -13,6 +17,13 @@ typedef std::vector< RealVector > RealVectorEnsemble;
 /**
  * @class McmcOptimiser
  * @brief Samples from probability distribution.
+ *
+ * By default all chains are advanced in lockstep with one shared random number generator, and the proposals of all
+ * chains are evaluated with one evaluateBatch call per iteration. After setNumThreads, every chain is an independent
+ * task with its own random stream (stream i + 1 of the seed for chain i) and its own step-size adaptation, and the
+ * chains run on a pool of threads; the samples are merged after all chains have finished, in the same order as in the
+ * sequential mode. The result then only depends on the seed, not on the number of threads or the scheduling. The
+ * objective function is evaluated concurrently in this mode, so its evaluate must be thread-safe.
  */
 class McmcOptimiser
 {
@@ -21,6 +32,10 @@ class McmcOptimiser
        * Constructor, about to sample @param objFunc.
        */
       McmcOptimiser( const IObjectiveFunction& objFunc );
+      /**
+       * Destructor.
+       */
+      ~McmcOptimiser();
 
       /**
        * Set the start values. This also determines the number of Markov chains.
@@ -42,6 +57,14 @@ class McmcOptimiser
        * Set the number of samples to be sampled.
        */
       void setNumSamples( size_t numSamples );
+      /**
+       * Set the seed of the random number generator(s).
+       */
+      void setSeed( size_t seed );
+      /**
+       * Run the chains independently on @param numThreads threads. 0 (default) selects the sequential lockstep mode.
+       */
+      void setNumThreads( size_t numThreads );
 
       /**
        * Sample the PDF.
@@ -50,17 +73,29 @@ class McmcOptimiser
 
    private:
       /**
-       * Perform one Markov step.
+       * Create the random number generator of every chain.
+       */
+      void resetChainRandom();
+      /**
+       * Run all iterations of chain @param iChain with its own random stream and append its samples to @param samples.
        */
-      RealVector proposeNew( const RealVector& x, double stepSize );
+      void runChain( size_t iChain, RealVectorEnsemble& samples );
       /**
-       * Accept function.
+       * Perform one Markov step, drawing from @param random.
        */
-      bool accept( double probNew, double probOld );
+      RealVector proposeNew( const RealVector& x, double stepSize, RandomNumberGenerator& random );
+      /**
+       * Accept function, drawing from @param random.
+       */
+      bool accept( double probNew, double probOld, RandomNumberGenerator& random );
       /**
        * Update the step size for every Markov chain.
        */
       void updateStepSize();
+      /**
+       * Update the step size of chain @param iChain.
+       */
+      void updateStepSize( size_t iChain );
 
    private:
       const IObjectiveFunction&  m_objFunc;              //! Objective function.
@@ -76,7 +111,11 @@ class McmcOptimiser
       double                     m_stepDecrease;         //! Decrease step-size factor.
       double                     m_effLow;               //! Lower bound proposal efficiency for decrease step-size.
       double                     m_effHigh;              //! Upper bound proposal efficiency for increase step-size.
+      size_t                     m_seed;                 //! Seed of the random number generator(s).
       RandomNumberGenerator      m_random;               //! Random number generator.
+      std::vector< RandomNumberGenerator > m_chainRandom; //! Random number generator per chain for independent chains.
+      size_t                     m_numThreads;           //! Number of threads for independent chains, 0 for lockstep.
+      std::unique_ptr< WorkerPool > m_workerPool;        //! Threads that run the chains.
 };
 
 } /// namespace Math
@@ -17,13 +17,8 @@ MlpErrorObjective::MlpErrorObjective( MultiLayerPerceptron& mlp, RealVector& eva
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 double MlpErrorObjective::evaluate( const RealVector& weights ) const
 {
-   double error;
    m_mlp.setWeights( weights );
-   RealVector&& grad = m_mlp.calcErrorAndGradient( m_eval, m_target, error );
-
-   /// Suppress compiler error.
-   assert( &grad );
-   return error;
+   return m_mlp.calcError( m_eval, m_target );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -31,7 +26,7 @@ double MlpErrorObjective::evaluate( const RealVector& weights ) const
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 size_t MlpErrorObjective::getNumParameters() const
 {
-   return m_mlp.getWeights().size();
+   return m_mlp.getNumWeights();
 }
 
 } /// namespace Mva
@@ -11,6 +11,8 @@ namespace Mva
  * @class MlpErrorObjective
  * @brief Square difference between target and MLP network evaluation as function of weights. Note that the target and
  * evaluation point have to be specified at construction and are no parameters during evaluation.
+ *
+ * Evaluation sets the weights of the shared network, so it is not thread-safe and setNumThreads must not be used.
  */
 class MlpErrorObjective : public Math::IObjectiveFunction
 {
@@ -79,7 +79,7 @@ RawPcmData::Ptr MonophonicSimpleRandomMusicGenerator::generateRandomMusic( size_
    for ( size_t iNote = 0; iNote < numNotes; ++iNote )
    {
       /// Draw a random note
-      size_t noteIndex = floor( m_random.Uniform( 0, m_availableNotes.size() ) );
+      size_t noteIndex = floor( m_random.uniform( 0, m_availableNotes.size() ) );
 
       /// Get duration
       const Note& note = m_availableNotes[noteIndex];
@@ -109,8 +109,10 @@ RawPcmData::Ptr MonophonicSimpleRandomMusicGenerator::generateRandomMusic( size_
 
       /// Generate wave data for each note
       m_synth->setFrequency( note.getFrequency() );
-      RawPcmData::Ptr noteData = m_synth->generate( numSamples );
-      rawPcmData->mixAdd( *noteData, mixOffset );
+      if ( numSamples > 0 )
+      {
+         m_synth->render( &(*rawPcmData)[ mixOffset ], numSamples );
+      }
       mixOffset += numSamples;
    }
 
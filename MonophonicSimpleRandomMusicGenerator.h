@@ -2,10 +2,9 @@
 #define MONOPHONICSIMPLERANDOMMUSICGENERATOR_H
 
 #include "Note.h"
+#include "RandomNumberGenerator.h"
 #include "RawPcmData.h"
 
-#include "TRandom3.h"
-
 namespace Synthesizer {
    class IGenerator;
 }
@@ -43,7 +42,7 @@ class MonophonicSimpleRandomMusicGenerator
 
    private:
       std::vector<Note>        m_availableNotes;      //! Urn of notes to draw from
-      TRandom3                 m_random;              //! Random number generator
+      RandomNumberGenerator    m_random;              //! Random number generator
       Synthesizer::IGenerator* m_synth;               //! Synthesizer
 
 };
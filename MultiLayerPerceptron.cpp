@@ -2,8 +2,8 @@
 
 #include "RandomNumberGenerator.h"
 
+#include <algorithm>
 #include <cmath>
-#include <iostream>
 
 namespace Mva
 {
@@ -12,79 +12,43 @@ namespace Mva
 /// Constructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 MultiLayerPerceptron::MultiLayerPerceptron( size_t numInputNodes, size_t numOutputNodes, const std::vector< size_t >& hiddenLayerStructure, bool useBiasNodes ) :
-   m_input( numInputNodes ),
-   m_output( numOutputNodes ),
-   m_deltaEInput( numInputNodes ),
-   m_deltaEOutput( numOutputNodes ),
    m_useBiasNodes( useBiasNodes ),
    m_numWeights( 0 )
 {
    assert( numInputNodes > 0 && numOutputNodes > 0 );
 
-   /// Initialise neuron quantities.
+   /// Layer structure.
+   m_layerSizes.push_back( numInputNodes );
    for ( auto it = hiddenLayerStructure.begin(); it != hiddenLayerStructure.end(); ++it )
    {
       assert( *it > 0 );
-      m_y.push_back( RealVector( *it ) );
-      m_dfdy.push_back( RealVector( *it ) );
-
-      m_x.push_back( RealVector( *it ) );
-      m_deltaE.push_back( RealVector( *it ) );
-   }
-
-   /// Initialise first layer weights.
-   size_t numFirstLayerTargetNeurons = m_y.size() > 0 ? m_y[0].size() : m_output.size();
-   m_weights.push_back( std::vector< RealVector >( m_input.size(), RealVector( numFirstLayerTargetNeurons, 1 ) ) );
-
-   /// Initialise hidden layer weights.
-   for ( int i = 0; i < static_cast< int >( m_y.size() ) - 1; ++i )
-   {
-      size_t nNeurons = m_y[ i ].size();
-      size_t nNeuronsNext = m_y[ i + 1 ].size();
-      m_weights.push_back( std::vector< RealVector >( nNeurons, RealVector( nNeuronsNext, 1 ) ) );
+      m_layerSizes.push_back( *it );
    }
+   m_layerSizes.push_back( numOutputNodes );
 
-   /// Initialse final layer weights.
-   if ( hiddenLayerStructure.size() != 0 )
+   /// Initialise weights with 1, and bias weights with 0.
+   for ( size_t iLayer = 0; iLayer + 1 < m_layerSizes.size(); ++iLayer )
    {
-      m_weights.push_back( std::vector< RealVector >( m_y.back().size(), RealVector( m_output.size(), 1 ) ) );
+      m_weightOffsets.push_back( m_numWeights );
+      m_numWeights += getRowSize( iLayer ) * m_layerSizes[ iLayer + 1 ];
    }
-
-   /// Initialise Bias nodes.
+   m_weights.assign( m_numWeights, 1 );
    if ( useBiasNodes )
    {
-      for ( size_t i = 0; i < m_x.size(); ++i )
+      for ( size_t iLayer = 0; iLayer < m_weightOffsets.size(); ++iLayer )
       {
-         m_x[ i ].push_back( 1 );
-         m_deltaE[ i ].push_back( 0 );
-      }
-
-      m_deltaEOutput.push_back( 0 );
-      m_input.push_back( 1 );
-
-      for ( size_t iLayer = 0; iLayer < m_weights.size(); ++iLayer )
-      {
-         m_weights[ iLayer ].push_back( m_weights[ iLayer ][ 0 ] );
-
-         /// Initialise bias weights with 0
-         for ( size_t i = 0; i < m_weights[ iLayer ].back().size(); ++i )
-         {
-            m_weights[ iLayer ].back()[ i ] = 0;
-         }
+         const size_t biasOffset = m_weightOffsets[ iLayer ] + m_layerSizes[ iLayer ] * m_layerSizes[ iLayer + 1 ];
+         std::fill( m_weights.begin() + biasOffset, m_weights.begin() + biasOffset + m_layerSizes[ iLayer + 1 ], 0.0 );
       }
    }
+   m_gradient.resize( m_numWeights );
 
-   m_weightDerivatives = m_weights;
-
-   /// Count the number of weights.
-   for ( size_t i = 0; i < m_weights.size(); ++i )
+   /// Initialise neuron quantities, the bias nodes are fixed at 1.
+   for ( size_t iLayer = 0; iLayer < m_layerSizes.size(); ++iLayer )
    {
-      for ( size_t j = 0; j < m_weights[ i ].size(); ++j )
-      {
-         m_numWeights += m_weights[ i ][ j ].size();
-      }
+      m_responses.push_back( RealVector( s_maxBatchSize * getRowSize( iLayer ), 1 ) );
+      m_deltas.push_back( RealVector( iLayer > 0 ? s_maxBatchSize * m_layerSizes[ iLayer ] : 0 ) );
    }
-
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -92,208 +56,230 @@ MultiLayerPerceptron::MultiLayerPerceptron( size_t numInputNodes, size_t numOutp
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 RealVector MultiLayerPerceptron::evaluate( const RealVector& x )
 {
-   /// Assert validity of input.
-   assert( !m_useBiasNodes && x.size() == m_input.size() || m_useBiasNodes && x.size() == m_input.size() - 1 );
+   setInput( 0, x );
+   propagateForward( 1 );
+   const RealVector& output = m_responses.back();
+   return RealVector( output.begin(), output.begin() + m_layerSizes.back() );
+}
 
-   /// Set input.
-   for ( size_t i = 0; i < x.size(); ++i )
-   {
-      m_input[ i ] = x[ i ];
-   }
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calcError
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double MultiLayerPerceptron::calcError( const RealVector& input, const RealVector& target )
+{
+   setInput( 0, input );
+   propagateForward( 1 );
+   return calcOutputDeltas( 0, target );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getErrorDerivative
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const RealVector& MultiLayerPerceptron::calcErrorAndGradient( const RealVector& input, const RealVector& target, double& error )
+{
+   /// The current state on the nodes will be used for backpropagation.
+   error = calcError( input, target );
+
+   std::fill( m_gradient.begin(), m_gradient.end(), 0.0 );
+   propagateBackward( 1 );
+   return m_gradient;
+}
 
-   /// Simple forward propagation when there are no hidden layers.
-   if ( m_y.size() == 0 )
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calcBatchError
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double MultiLayerPerceptron::calcBatchError( const std::vector< RealVector >& inputs, const std::vector< RealVector >& targets, const std::vector< size_t >& sampleIndices, RealVector& sampleErrors )
+{
+   return calcBatch( inputs, targets, sampleIndices, sampleErrors, false );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calcBatchErrorAndGradient
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const RealVector& MultiLayerPerceptron::calcBatchErrorAndGradient( const std::vector< RealVector >& inputs, const std::vector< RealVector >& targets, const std::vector< size_t >& sampleIndices, RealVector& sampleErrors )
+{
+   calcBatch( inputs, targets, sampleIndices, sampleErrors, true );
+   return m_gradient;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calcBatch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double MultiLayerPerceptron::calcBatch( const std::vector< RealVector >& inputs, const std::vector< RealVector >& targets, const std::vector< size_t >& sampleIndices,
+                                       RealVector& sampleErrors, bool calcGradient )
+{
+   assert( inputs.size() == targets.size() );
+
+   sampleErrors.resize( sampleIndices.size() );
+   if ( calcGradient )
    {
-      propagateForward( m_input, m_output, m_weights[ 0 ] );
+      std::fill( m_gradient.begin(), m_gradient.end(), 0.0 );
    }
-   else
-   {
-      /// Propage from input node to first hidden layer.
-      propagateForward( m_input, m_y[ 0 ], m_weights[ 0 ] );
-      applyActivationFunc( m_y[ 0 ], m_x[ 0 ] );
 
-      /// Propagate to last hidden layer.
-      for ( size_t iHiddenLayer = 0; iHiddenLayer < m_y.size() - 1; ++iHiddenLayer )
+   /// Propagate the samples in chunks that fit in the neuron buffers.
+   double totalError = 0;
+   for ( size_t iFirst = 0; iFirst < sampleIndices.size(); iFirst += s_maxBatchSize )
+   {
+      const size_t numRows = std::min( s_maxBatchSize, sampleIndices.size() - iFirst );
+      for ( size_t iRow = 0; iRow < numRows; ++iRow )
       {
-         propagateForward( m_x[ iHiddenLayer ], m_y[ iHiddenLayer + 1 ], m_weights[ iHiddenLayer + 1 ] );
-         applyActivationFunc( m_y[ iHiddenLayer + 1 ], m_x[ iHiddenLayer + 1 ] );
+         setInput( iRow, inputs[ sampleIndices[ iFirst + iRow ] ] );
+      }
+      propagateForward( numRows );
+      for ( size_t iRow = 0; iRow < numRows; ++iRow )
+      {
+         sampleErrors[ iFirst + iRow ] = calcOutputDeltas( iRow, targets[ sampleIndices[ iFirst + iRow ] ] );
+         totalError += sampleErrors[ iFirst + iRow ];
+      }
+      if ( calcGradient )
+      {
+         propagateBackward( numRows );
       }
-
-      /// Propagate to output nodes.
-      propagateForward( m_x.back(), m_output, m_weights.back() );
    }
-
-   return m_output;
+   return totalError;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// calcError
+/// setInput
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-double MultiLayerPerceptron::calcError( const RealVector& input, const RealVector& target )
+void MultiLayerPerceptron::setInput( size_t iRow, const RealVector& input )
 {
-   const RealVector& response = evaluate( input );
+   /// Assert validity of input.
+   assert( input.size() == m_layerSizes[ 0 ] );
+   std::copy( input.begin(), input.end(), m_responses[ 0 ].begin() + iRow * getRowSize( 0 ) );
+}
 
-   assert( target.size() == response.size() );
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calcOutputDeltas
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double MultiLayerPerceptron::calcOutputDeltas( size_t iRow, const RealVector& target )
+{
+   const size_t numOutputs = m_layerSizes.back();
+   assert( target.size() == numOutputs );
 
    /// Calculate the error and deltas on the output nodes.
+   const double* response = &m_responses.back()[ iRow * numOutputs ];
+   double* delta = &m_deltas.back()[ iRow * numOutputs ];
    double error = 0;
-   for ( size_t i = 0; i < response.size(); ++i )
+   for ( size_t i = 0; i < numOutputs; ++i )
    {
       double diff = response[ i ] - target[ i ];
       error += diff * diff;
-      m_deltaEOutput[ i ] = diff;
+      delta[ i ] = diff;
    }
    error *= 0.5;
    return error;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// getErrorDerivative
+/// propagateForward
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-RealVector MultiLayerPerceptron::calcErrorAndGradient( const RealVector& input, const RealVector& target, double& error )
+void MultiLayerPerceptron::propagateForward( size_t numRows )
 {
-   /// The current state on the nodes will be used for backpropagation.
-   error = calcError( input, target );
-
-   if ( m_deltaE.size() == 0 )
-   {
-      /// Calculate the gradient components with a single backward propagation if there are no hidden layers.
-      propagateBackward( m_deltaEOutput, m_deltaEInput, m_weights[ 0 ] );
-      for ( size_t iInput = 0; iInput < m_weights[ 0 ].size(); ++iInput )
-      {
-         for ( size_t iOutput = 0; iOutput < m_weights[ 0 ][ iInput ].size(); ++iOutput )
-         {
-            m_weightDerivatives[ 0 ][ iInput ][ iOutput ] = m_input[ iInput ] * m_deltaEOutput[ iOutput ];
-         }
-      }
-   }
-   else
+   const size_t numWeightLayers = m_weightOffsets.size();
+   for ( size_t iLayer = 0; iLayer < numWeightLayers; ++iLayer )
    {
-      /// Calculate the derivatives of the activation function on all the hidden nodes. This is independent of
-      /// backpropagation.
-      calcDerivativesActivationFunc();
-
-      /// Propagate output deltas to first hidden node.
-      propagateBackward( m_deltaEOutput, m_deltaE.back(), m_weights.back() );
-      for ( size_t i = 0; i < m_deltaE.back().size(); ++i )
+      const size_t numSource = getRowSize( iLayer );
+      const size_t numDest = m_layerSizes[ iLayer + 1 ];
+      const size_t destRowSize = getRowSize( iLayer + 1 );
+      const double* source = &m_responses[ iLayer ][ 0 ];
+      double* dest = &m_responses[ iLayer + 1 ][ 0 ];
+      const double* weights = &m_weights[ m_weightOffsets[ iLayer ] ];
+
+      /// Y = X W for all rows; each weight row is used for the whole batch before moving on.
+      for ( size_t iRow = 0; iRow < numRows; ++iRow )
       {
-         m_deltaE.back()[ i ] *= m_dfdy.back()[ i ];
+         std::fill( dest + iRow * destRowSize, dest + iRow * destRowSize + numDest, 0.0 );
       }
-
-      /// Calculate deltas for all hidden nodes.
-      /// delta_nk = f'(y_nk) * sum_i w_nki delta_(n+1)i
-      /// propageBackward calculates the sum.
-      for ( size_t iHiddenLayer = m_deltaE.size() - 1; iHiddenLayer > 0; --iHiddenLayer )
+      for ( size_t iSource = 0; iSource < numSource; ++iSource )
       {
-         propagateBackward( m_deltaE[ iHiddenLayer ], m_deltaE[ iHiddenLayer - 1 ], m_weights[ iHiddenLayer ] );
-         for ( size_t iNeuron = 0; iNeuron < m_deltaE[ iHiddenLayer - 1 ].size(); ++iNeuron )
+         const double* weightRow = weights + iSource * numDest;
+         for ( size_t iRow = 0; iRow < numRows; ++iRow )
          {
-            m_deltaE[ iHiddenLayer - 1 ][ iNeuron ] *= m_dfdy[ iHiddenLayer - 1 ][ iNeuron ];
+            const double x = source[ iRow * numSource + iSource ];
+            double* destRow = dest + iRow * destRowSize;
+            for ( size_t iDest = 0; iDest < numDest; ++iDest )
+            {
+               destRow[ iDest ] += x * weightRow[ iDest ];
+            }
          }
       }
 
-      /// Calculate the derivatives. dE/dw_nij = x_(n-1)j * delta_i
-      for ( size_t iLayer = 0; iLayer < m_weights.size(); ++iLayer )
+      /// Activation function on the hidden layers.
+      if ( iLayer + 1 < numWeightLayers )
       {
-         const RealVector& sourceNeuronActivations = iLayer != 0 ? m_x[ iLayer - 1 ] : m_input;
-         const RealVector& deltaVec = iLayer < m_deltaE.size() ? m_deltaE[ iLayer ] : m_deltaEOutput;
-         for ( size_t iSourceNeuron = 0; iSourceNeuron < m_weights[ iLayer ].size(); ++iSourceNeuron )
+         for ( size_t iRow = 0; iRow < numRows; ++iRow )
          {
-            for ( size_t iTargetNeuron = 0; iTargetNeuron < m_weights[ iLayer ][ iSourceNeuron ].size(); ++iTargetNeuron )
+            double* destRow = dest + iRow * destRowSize;
+            for ( size_t iDest = 0; iDest < numDest; ++iDest )
             {
-               m_weightDerivatives[ iLayer ][ iSourceNeuron ][ iTargetNeuron ] = sourceNeuronActivations[ iSourceNeuron ] * deltaVec[ iTargetNeuron ];
+               destRow[ iDest ] = tanh( destRow[ iDest ] );
             }
          }
       }
    }
-
-   /// @see composeGradient
-   return composeGradient();
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// propagateFwd
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-void MultiLayerPerceptron::propagateForward( const RealVector& sourceLayer, RealVector& destLayer, const std::vector< RealVector >& weights )
-{
-   assert( weights.size() == sourceLayer.size() );
-
-   for ( size_t iDestNeuron = 0; iDestNeuron < destLayer.size(); ++iDestNeuron )
-   {
-      destLayer[ iDestNeuron ] = 0;
-      for ( size_t iSourceNeuron = 0; iSourceNeuron < sourceLayer.size(); ++iSourceNeuron )
-      {
-         assert( weights[ iSourceNeuron ].size() == destLayer.size() );
-         destLayer[ iDestNeuron ] += sourceLayer[ iSourceNeuron ] * weights[ iSourceNeuron ][ iDestNeuron ];
-      }
-   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// propagateBackward
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-void MultiLayerPerceptron::propagateBackward( const RealVector& sourceLayer, RealVector& destLayer, const std::vector< RealVector >& weights )
+void MultiLayerPerceptron::propagateBackward( size_t numRows )
 {
-   assert( weights.size() == destLayer.size() );
-   for ( size_t iDestNeuron = 0; iDestNeuron < destLayer.size(); ++iDestNeuron )
+   for ( size_t iLayer = m_weightOffsets.size(); iLayer-- > 0; )
    {
-      destLayer[ iDestNeuron ] = 0;
-      size_t sourceSize = m_useBiasNodes ? sourceLayer.size() - 1 : sourceLayer.size();
-
-      assert( weights[ iDestNeuron ].size() == sourceSize );
-      for ( size_t iSourceNeuron = 0; iSourceNeuron < sourceSize; ++iSourceNeuron )
+      const size_t numSource = getRowSize( iLayer );
+      const size_t numDest = m_layerSizes[ iLayer + 1 ];
+      const double* source = &m_responses[ iLayer ][ 0 ];
+      const double* delta = &m_deltas[ iLayer + 1 ][ 0 ];
+      const double* weights = &m_weights[ m_weightOffsets[ iLayer ] ];
+      double* gradient = &m_gradient[ m_weightOffsets[ iLayer ] ];
+
+      /// dE/dW = X^T Delta, summed over the batch; each gradient row is completed before moving on.
+      for ( size_t iSource = 0; iSource < numSource; ++iSource )
       {
-         destLayer[ iDestNeuron ] += sourceLayer[ iSourceNeuron ] * weights[ iDestNeuron ][ iSourceNeuron ];
+         double* gradientRow = gradient + iSource * numDest;
+         for ( size_t iRow = 0; iRow < numRows; ++iRow )
+         {
+            const double x = source[ iRow * numSource + iSource ];
+            const double* deltaRow = delta + iRow * numDest;
+            for ( size_t iDest = 0; iDest < numDest; ++iDest )
+            {
+               gradientRow[ iDest ] += x * deltaRow[ iDest ];
+            }
+         }
       }
-   }
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// applyActivationFunc
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-void MultiLayerPerceptron::applyActivationFunc( const RealVector& neuronActivation, RealVector& neuronResponse )
-{
-   for ( size_t i = 0; i < neuronActivation.size(); ++i )
-   {
-      neuronResponse[ i ] = tanh( neuronActivation[ i ] );
-   }
-}
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// calcDerivativesActivationFunc
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-void MultiLayerPerceptron::calcDerivativesActivationFunc()
-{
-   for ( size_t iLayer = 0; iLayer < m_y.size(); ++iLayer )
-   {
-      for ( size_t iNeuron = 0; iNeuron < m_y[ iLayer ].size(); ++iNeuron )
+      /// delta_nk = f'(y_nk) * sum_i w_nki delta_(n+1)i, with f'(y) = 1 - tanh(y)^2. Bias nodes have no delta.
+      if ( iLayer > 0 )
       {
-         /// NB. m_x = f(m_y).
-         double tanhY = m_x[ iLayer ][ iNeuron ];
-         m_dfdy[ iLayer ][ iNeuron ] = 1 - tanhY * tanhY;
+         const size_t numSourceNodes = m_layerSizes[ iLayer ];
+         double* sourceDelta = &m_deltas[ iLayer ][ 0 ];
+         for ( size_t iSource = 0; iSource < numSourceNodes; ++iSource )
+         {
+            const double* weightRow = weights + iSource * numDest;
+            for ( size_t iRow = 0; iRow < numRows; ++iRow )
+            {
+               const double* deltaRow = delta + iRow * numDest;
+               double sum = 0;
+               for ( size_t iDest = 0; iDest < numDest; ++iDest )
+               {
+                  sum += weightRow[ iDest ] * deltaRow[ iDest ];
+               }
+               const double y = source[ iRow * numSource + iSource ];
+               sourceDelta[ iRow * numSourceNodes + iSource ] = sum * ( 1 - y * y );
+            }
+         }
       }
    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// composeGradient
+/// getRowSize
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-RealVector MultiLayerPerceptron::composeGradient()
+size_t MultiLayerPerceptron::getRowSize( size_t iLayer ) const
 {
-   RealVector result( getNumWeights() );
-
-   size_t index = 0;
-   for ( size_t iLayer = 0; iLayer < m_weightDerivatives.size(); ++iLayer )
-   {
-      for ( size_t iSource = 0; iSource < m_weightDerivatives[ iLayer ].size(); ++iSource )
-      {
-         for ( size_t iDest = 0; iDest < m_weightDerivatives[ iLayer ][ iSource ].size(); ++iDest, ++index )
-         {
-            result[ index ] = m_weightDerivatives[ iLayer ][ iSource ][ iDest ];
-         }
-      }
-   }
-   return result;
+   const bool hasBias = m_useBiasNodes && iLayer + 1 < m_layerSizes.size();
+   return m_layerSizes[ iLayer ] + ( hasBias ? 1 : 0 );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -304,33 +290,16 @@ void MultiLayerPerceptron::randomiseWeights( const Interval& interval, size_t se
    RandomNumberGenerator rng( seed );
    for ( size_t i = 0; i < m_weights.size(); ++i )
    {
-      for ( size_t j = 0; j < m_weights[ i ].size(); ++j )
-      {
-         for ( size_t k = 0; k < m_weights[ i ][ j ].size(); ++k )
-         {
-            m_weights[ i ][ j ][ k ] = rng.uniform( interval.getMin(), interval.getMax() );
-         }
-      }
+      m_weights[ i ] = rng.uniform( interval.getMin(), interval.getMax() );
    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// getWeightReference
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-std::vector< double > MultiLayerPerceptron::getWeights()
+std::vector< double > MultiLayerPerceptron::getWeights() const
 {
-   std::vector< double > result;
-   for ( size_t i = 0; i < m_weights.size(); ++i )
-   {
-      for ( size_t j = 0; j < m_weights[ i ].size(); ++j )
-      {
-         for ( size_t k = 0; k < m_weights[ i ][ j ].size(); ++k )
-         {
-            result.push_back( m_weights[ i ][ j ][ k ] );
-         }
-      }
-   }
-   return result;
+   return m_weights;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -338,18 +307,8 @@ std::vector< double > MultiLayerPerceptron::getWeights()
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void MultiLayerPerceptron::setWeights( const std::vector< double >& weights )
 {
-   size_t l = 0;
-   for ( size_t i = 0; i < m_weights.size(); ++i )
-   {
-      for ( size_t j = 0; j < m_weights[ i ].size(); ++j )
-      {
-         for ( size_t k = 0; k < m_weights[ i ][ j ].size(); ++k )
-         {
-            m_weights[ i ][ j ][ k ] = weights[ l ];
-            ++l;
-         }
-      }
-   }
+   assert( weights.size() == m_weights.size() );
+   std::copy( weights.begin(), weights.end(), m_weights.begin() );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -360,4 +319,20 @@ size_t MultiLayerPerceptron::getNumWeights() const
    return m_numWeights;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getLayerSizes
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const std::vector< size_t >& MultiLayerPerceptron::getLayerSizes() const
+{
+   return m_layerSizes;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// hasBiasNodes
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool MultiLayerPerceptron::hasBiasNodes() const
+{
+   return m_useBiasNodes;
+}
+
 } /// namespace Mva
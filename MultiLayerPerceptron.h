@@ -10,6 +10,15 @@ namespace Mva
 /**
  * @class MultiLayerPerceptron
  * @brief MultiLayerPerceptron artificial neural network with backpropagation.
+ *
+ * The weights of all layers are stored in one contiguous vector. The weights of a layer form a row-major matrix with
+ * one row per source node (the bias node last) and one column per destination node, so the flat order is layer,
+ * source node, destination node. The neuron responses and backpropagation deltas of a mini-batch are stored as
+ * row-major matrices with one row per sample. Propagation loops over the weight rows outermost and applies each one
+ * to every sample of the batch, with the innermost loop over the destination nodes; the gradient is accumulated in a
+ * preallocated buffer in the same order. This saves weight reloads and call overhead, but for networks whose weights
+ * fit in the L1 cache the per-sample and batched paths run the same vectorised inner loops, and batching gains about
+ * a factor 1.3 (@see devMlpBatchBenchmark).
  */
 class MultiLayerPerceptron
 {
@@ -29,7 +38,7 @@ class MultiLayerPerceptron
       /**
        * Retrieve the weights.
        */
-      std::vector< double > getWeights();
+      std::vector< double > getWeights() const;
       /**
        * Set weights.
        */
@@ -41,14 +50,22 @@ class MultiLayerPerceptron
       /**
        * Get the number of weights
        */
-     size_t getNumWeights() const;
+      size_t getNumWeights() const;
+      /**
+       * Get the number of neurons per layer (input, hidden layers, output), without bias nodes.
+       */
+      const std::vector< size_t >& getLayerSizes() const;
+      /**
+       * Check whether the input and hidden layers have bias nodes.
+       */
+      bool hasBiasNodes() const;
 
    public:
       /**
        * Calculate the error and gradient (@param[out] error and @return) for a sample @param input and
-       * desired output @param target.
+       * desired output @param target. The gradient is valid until the next gradient calculation.
        */
-      RealVector calcErrorAndGradient( const RealVector& input, const RealVector& target, double& error );
+      const RealVector& calcErrorAndGradient( const RealVector& input, const RealVector& target, double& error );
 
       /**
        * Calculate the error for an individual sample.
@@ -56,47 +73,57 @@ class MultiLayerPerceptron
       double calcError( const RealVector& input, const RealVector& target );
 
       /**
-       * Propagate neuron response from @param sourceLayer to activate @param destLayer.
+       * Calculate the errors of the samples @param sampleIndices of @param inputs and @param targets and store them in
+       * @param[out] sampleErrors (resized to the number of samples). @return the sum of the errors.
        */
-      void propagateForward( const RealVector& sourceLayer, RealVector& destLayer, const std::vector< RealVector >& weights );
+      double calcBatchError( const std::vector< RealVector >& inputs, const std::vector< RealVector >& targets, const std::vector< size_t >& sampleIndices, RealVector& sampleErrors );
       /**
-       * Backpropagation. The weights should not be transposed for this operation (i.e. use the feedforward weights
-       * representation for the matching layer).
+       * As calcBatchError, but also calculate the gradient summed over the samples (@return). The gradient is valid
+       * until the next gradient calculation.
        */
-      void propagateBackward( const RealVector& sourceLayer, RealVector& destLayer, const std::vector< RealVector >& weights );
+      const RealVector& calcBatchErrorAndGradient( const std::vector< RealVector >& inputs, const std::vector< RealVector >& targets, const std::vector< size_t >& sampleIndices, RealVector& sampleErrors );
 
+   private:
       /**
-       * Apply activation function on @param neuronActivation and store result in @param[out] neuronResponse.
-       * The neuronResponse vector should be initialised. This method is applied to compute x from y.
+       * Implementation of calcBatchError and calcBatchErrorAndGradient; the gradient is only calculated if
+       * @param calcGradient is set.
        */
-      void applyActivationFunc( const RealVector& neuronActivation, RealVector& neuronResponse );
-
+      double calcBatch( const std::vector< RealVector >& inputs, const std::vector< RealVector >& targets, const std::vector< size_t >& sampleIndices,
+                        RealVector& sampleErrors, bool calcGradient );
       /**
-       * Calculate all derivatives df/dy on all neurons.
+       * Copy @param input into row @param iRow of the input layer.
        */
-      void calcDerivativesActivationFunc();
-
-   private:
+      void setInput( size_t iRow, const RealVector& input );
+      /**
+       * Calculate the output deltas of row @param iRow for @param target and @return the error.
+       */
+      double calcOutputDeltas( size_t iRow, const RealVector& target );
+      /**
+       * Propagate the first @param numRows input rows forward through all layers.
+       */
+      void propagateForward( size_t numRows );
+      /**
+       * Propagate the output deltas of the first @param numRows rows backward and add the weight derivatives to
+       * m_gradient.
+       */
+      void propagateBackward( size_t numRows );
       /**
-       * Flatten m_weightDerivatives into a single weight vector.
+       * Get the number of nodes of layer @param iLayer, including its bias node.
        */
-      RealVector composeGradient();
+      size_t getRowSize( size_t iLayer ) const;
 
    private:
-      RealVector						              m_input;		         //! Input nodes values.
-      RealVector						              m_output;	         	//! Output nodes values.
-      std::vector< RealVector >	              m_y;			         //! Hidden layer neuron activations. First index layer, second index neuron in layer.
-      std::vector< RealVector >	              m_x;			         //! Hidden layer neuron response values. First index layers, second index neuron in layer.
+      static const size_t s_maxBatchSize = 64;  //! Maximum number of samples that are propagated at once.
 
-      std::vector< RealVector >					  m_deltaE;				   //! Backpropagation delta values (dE/dy) on hidden nodes.
-      RealVector              					  m_deltaEInput;   		//! Backpropagation delta values on input nodes.
-      RealVector              					  m_deltaEOutput;  		//! Backpropagation delta values on output nodes.
-      std::vector< RealVector >					  m_dfdy;				   //! Derivative of activation function on hidden nodes.
-      std::vector< std::vector< RealVector > > m_weights;			   //! All weights. Indexing: layer, source node, dest node.
+      std::vector< size_t >         m_layerSizes;     //! Number of neurons per layer (input, hidden layers, output), without bias nodes.
+      bool                          m_useBiasNodes;   //! Indicator whether or not to include bias nodes.
+      size_t                        m_numWeights;     //! The number of weights in this MLP.
+      std::vector< size_t >         m_weightOffsets;  //! Offset of the weight matrix of every layer in m_weights.
+      RealVector                    m_weights;        //! All weights. Indexing: layer, source node, dest node.
+      RealVector                    m_gradient;       //! Derivatives of the error with respect to all weights.
 
-      std::vector< std::vector< RealVector > > m_weightDerivatives;	//! Derivates of all weights.
-      bool												  m_useBiasNodes;			//! Indicator whether or not to include bias nodes.
-      size_t											  m_numWeights;		   //! The number of weights in this MLP.
+      std::vector< RealVector >     m_responses;      //! Neuron responses per layer, one row per sample (incl. bias nodes).
+      std::vector< RealVector >     m_deltas;         //! Backpropagation deltas (dE/dy) per layer, one row per sample.
 };
 
 } /// namespace Mva
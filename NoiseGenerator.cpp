@@ -12,20 +12,12 @@ NoiseGenerator::NoiseGenerator( const SamplingInfo& samplingInfo, int seed ) :
 {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// generate
+/// render
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-RawPcmData::Ptr NoiseGenerator::generate( size_t length )
+void NoiseGenerator::render( double* buffer, size_t numSamples )
 {
-   RawPcmData* result = new RawPcmData( getSamplingInfo(), length );
-
-   for ( size_t iSample = 0; iSample < length; ++iSample )
-   {
-      double val = m_ranGen.Uniform( -1, 1 ) * getCurrentSampleAmplitude();
-      (*result)[iSample] = val;
-      nextSample();
-   }
-
-   return RawPcmData::Ptr( result );
+   m_ranGen.fillUniform( buffer, numSamples, -1, 1 );
+   applyEnvelope( buffer, numSamples );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
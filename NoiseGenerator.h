@@ -2,9 +2,7 @@
 #define NOISEGENERATOR_H
 
 #include "IGenerator.h"
-
-/// ROOT includes
-#include "TRandom3.h"
+#include "RandomNumberGenerator.h"
 
 namespace Synthesizer {
 
@@ -22,13 +20,13 @@ class NoiseGenerator : public IGenerator
        */
       NoiseGenerator( const SamplingInfo& samplingInfo, int seed = -1 );
       /**
-       * generate (@see IGenerator)
+       * render (@see IGenerator)
        */
-      RawPcmData::Ptr generate( size_t length );
+      void render( double* buffer, size_t numSamples );
 
    private:
-      TRandom3    m_ranGen;
-      static int  s_ranSeed;
+      RandomNumberGenerator   m_ranGen;
+      static int              s_ranSeed;
 };
 
 } /// namespace Synthesizer
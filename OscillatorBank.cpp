@@ -0,0 +1,122 @@
+#include "OscillatorBank.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Synthesizer
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+OscillatorBank::OscillatorBank()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// addOscillator
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void OscillatorBank::addOscillator( double phaseStep, double phase, double amplitude )
+{
+   m_phaseStep.push_back( phaseStep );
+   m_phase.push_back( fmod( phase, 2 * M_PI ) );
+   m_amplitude.push_back( amplitude );
+   m_stepRe.push_back( cos( phaseStep ) );
+   m_stepIm.push_back( sin( phaseStep ) );
+   m_re.push_back( 0 );
+   m_im.push_back( 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// clear
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void OscillatorBank::clear()
+{
+   m_phaseStep.clear();
+   m_phase.clear();
+   m_amplitude.clear();
+   m_stepRe.clear();
+   m_stepIm.clear();
+   m_re.clear();
+   m_im.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumOscillators
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t OscillatorBank::getNumOscillators() const
+{
+   return m_phase.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getPhase
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double OscillatorBank::getPhase( size_t iOscillator ) const
+{
+   return m_phase[ iOscillator ];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getResyncInterval
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t OscillatorBank::getResyncInterval()
+{
+   return 256;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// render
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void OscillatorBank::render( double* result, size_t numSamples )
+{
+   const size_t resyncInterval = getResyncInterval();
+   for ( size_t iFirst = 0; iFirst < numSamples; iFirst += resyncInterval )
+   {
+      renderBlock( result + iFirst, std::min( resyncInterval, numSamples - iFirst ) );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// renderBlock
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void OscillatorBank::renderBlock( double* result, size_t numSamples )
+{
+   assert( numSamples <= getResyncInterval() );
+
+   const size_t numOscillators = m_phase.size();
+
+   /// Start from the exact phases.
+   for ( size_t iOsc = 0; iOsc < numOscillators; ++iOsc )
+   {
+      m_re[ iOsc ] = cos( m_phase[ iOsc ] );
+      m_im[ iOsc ] = sin( m_phase[ iOsc ] );
+   }
+
+   double* re = m_re.data();
+   double* im = m_im.data();
+   const double* stepRe = m_stepRe.data();
+   const double* stepIm = m_stepIm.data();
+   const double* amplitude = m_amplitude.data();
+   for ( size_t iSample = 0; iSample < numSamples; ++iSample )
+   {
+      double sum = 0;
+      for ( size_t iOsc = 0; iOsc < numOscillators; ++iOsc )
+      {
+         double newRe = re[ iOsc ] * stepRe[ iOsc ] - im[ iOsc ] * stepIm[ iOsc ];
+         double newIm = re[ iOsc ] * stepIm[ iOsc ] + im[ iOsc ] * stepRe[ iOsc ];
+         re[ iOsc ] = newRe;
+         im[ iOsc ] = newIm;
+         sum += amplitude[ iOsc ] * newIm;
+      }
+      result[ iSample ] = sum;
+   }
+
+   /// Advance the exact phases.
+   for ( size_t iOsc = 0; iOsc < numOscillators; ++iOsc )
+   {
+      m_phase[ iOsc ] = fmod( m_phase[ iOsc ] + numSamples * m_phaseStep[ iOsc ], 2 * M_PI );
+   }
+}
+
+} /// namespace Synthesizer
@@ -0,0 +1,78 @@
+#ifndef OSCILLATORBANK_H
+#define OSCILLATORBANK_H
+
+#include "RealVector.h"
+
+#include <cstddef>
+
+namespace Synthesizer
+{
+
+/**
+ * @class OscillatorBank
+ * @brief Bank of sine oscillators that are rendered together into a single signal.
+ *
+ * Each oscillator is advanced with a complex phasor recurrence, z <- z * exp( i * phaseStep ), so that rendering costs
+ * a few multiplications per oscillator per sample instead of a sin call. The oscillators are stored in flat arrays
+ * and the loop over oscillators has no dependencies, so it is vectorised by the compiler (one oscillator per SIMD lane).
+ *
+ * To stay phase-accurate for long notes, the phasors are recalculated from the exact phase every
+ * getResyncInterval() samples. The phase itself is kept modulo 2 pi, so it does not lose precision with time either.
+ * Sample i (counting from zero since the last render) has phase phase + ( i + 1 ) * phaseStep, which is the convention
+ * of AdditiveSynthesizer.
+ */
+class OscillatorBank
+{
+   public:
+      /**
+       * Constructor.
+       */
+      OscillatorBank();
+
+      /**
+       * Add an oscillator amplitude * sin( phase ) with phase step per sample @param phaseStep and initial phase @param phase.
+       */
+      void addOscillator( double phaseStep, double phase, double amplitude );
+      /**
+       * Remove all oscillators.
+       */
+      void clear();
+
+      /**
+       * Get the number of oscillators.
+       */
+      size_t getNumOscillators() const;
+      /**
+       * Get the current phase (modulo 2 pi) of oscillator @param iOscillator, i.e. the phase of the last rendered sample.
+       */
+      double getPhase( size_t iOscillator ) const;
+
+      /**
+       * Write the sum of all oscillators for the next @param numSamples samples to @param result.
+       */
+      void render( double* result, size_t numSamples );
+
+      /**
+       * Number of samples after which the phasors are recalculated from the exact phase.
+       */
+      static size_t getResyncInterval();
+
+   private:
+      /**
+       * Render at most getResyncInterval() samples starting from the exact phases.
+       */
+      void renderBlock( double* result, size_t numSamples );
+
+   private:
+      RealVector     m_phaseStep;         //! Phase step per sample.
+      RealVector     m_phase;             //! Current phase (modulo 2 pi).
+      RealVector     m_amplitude;         //! Amplitude.
+      RealVector     m_re;                //! Working array with the real part of the phasor.
+      RealVector     m_im;                //! Working array with the imaginary part of the phasor.
+      RealVector     m_stepRe;            //! Real part of the phasor step.
+      RealVector     m_stepIm;            //! Imaginary part of the phasor step.
+};
+
+} /// namespace Synthesizer
+
+#endif // OSCILLATORBANK_H
@@ -19,6 +19,8 @@ ParticleSwarmOptimiser::ParticleSwarmOptimiser( const IObjectiveFunction& objFun
    m_particleVelocities( numParticles, RealVector( solutionSpace.getDimensionality(), 1 ) ),
    m_solutionSpace( solutionSpace ),
    m_randGen( 1 ),
+   m_localRandom( solutionSpace.getDimensionality() ),
+   m_globalRandom( solutionSpace.getDimensionality() ),
    m_delta( 1 ),
    m_velocityPropagation( 0.5 ),
    m_localCoupling( -0.5 ),
@@ -68,11 +70,13 @@ void ParticleSwarmOptimiser::updateParticlePositions()
       RealVector& currentPos = m_particlePositions[ iParticle ];
       RealVector& currentVel = m_particleVelocities[ iParticle ];
       RealVector& localBest = m_particleBestPos[ iParticle ];
+      m_randGen.fillUniform( m_localRandom.data(), m_localRandom.size() );
+      m_randGen.fillUniform( m_globalRandom.data(), m_globalRandom.size() );
       for ( size_t iPar = 0; iPar < m_objFunc.getNumParameters(); ++iPar )
       {
          currentVel[ iPar ] *= m_velocityPropagation;
-         currentVel[ iPar ] += m_localCoupling * m_randGen.uniform() * ( - currentPos[ iPar ] + localBest[ iPar ] );
-         currentVel[ iPar ] += m_globalCoupling * m_randGen.uniform() * ( - currentPos[ iPar ] + m_bestSolution[ iPar ] );
+         currentVel[ iPar ] += m_localCoupling * m_localRandom[ iPar ] * ( - currentPos[ iPar ] + localBest[ iPar ] );
+         currentVel[ iPar ] += m_globalCoupling * m_globalRandom[ iPar ] * ( - currentPos[ iPar ] + m_bestSolution[ iPar ] );
          currentPos[ iPar ] += m_delta * currentVel[ iPar ];
       }
    }
@@ -80,10 +84,11 @@ void ParticleSwarmOptimiser::updateParticlePositions()
 
 void ParticleSwarmOptimiser::updateBestValues()
 {
+   const RealVector& objFuncVals = m_objFunc.evaluateBatch( m_particlePositions );
    size_t bestIndex = m_particlePositions.size();
    for ( size_t iParticle = 0; iParticle < m_particlePositions.size(); ++iParticle )
    {
-      double objFuncVal = m_objFunc.evaluate( m_particlePositions[ iParticle ] );
+      double objFuncVal = objFuncVals[ iParticle ];
       if ( objFuncVal > m_particleBest[ iParticle ] )
       {
          m_particleBest[ iParticle ] = objFuncVal;
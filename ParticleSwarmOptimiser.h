@@ -35,6 +35,8 @@ class ParticleSwarmOptimiser
       RealVector                 m_bestSolution;
       Hypercube              m_solutionSpace;
       RandomNumberGenerator      m_randGen;
+      RealVector                 m_localRandom;
+      RealVector                 m_globalRandom;
 
       double                     m_delta;
       double                     m_velocityPropagation;
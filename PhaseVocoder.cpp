@@ -0,0 +1,236 @@
+#include "PhaseVocoder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Music
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+PhaseVocoder::PhaseVocoder( double stretchFactor, const SamplingInfo& samplingInfo, size_t fourierSize ) :
+   m_stretchFactor( stretchFactor ),
+   m_samplingInfo( samplingInfo ),
+   m_fourierSize( fourierSize ),
+   m_synthesisHop( fourierSize / 4 ),
+   m_window( fourierSize ),
+   m_fftw( fourierSize ),
+   m_numInput( 0 ),
+   m_isFinished( false ),
+   m_prevSpectrum( m_fftw.getSpectrumDimension() ),
+   m_prevSynthesis( m_fftw.getSpectrumDimension() ),
+   m_power( m_fftw.getSpectrumDimension() ),
+   m_accumulator( fourierSize ),
+   m_numOutput( 0 )
+{
+   assert( stretchFactor > 0 );
+   assert( fourierSize % 4 == 0 );
+
+   /// Periodic Hann window; the squared windows add up to a constant at a hop of a quarter of the frame.
+   double sumSquares = 0;
+   for ( size_t i = 0; i < fourierSize; ++i )
+   {
+      m_window[ i ] = 0.5 - 0.5 * cos( 2 * M_PI * i / fourierSize );
+      sumSquares += m_window[ i ] * m_window[ i ];
+   }
+   m_scale = m_synthesisHop / sumSquares / fourierSize;
+
+   /// The first frames start before the input, so that the overlap-add is complete from the first output sample on.
+   m_iFrame = 1 - static_cast< long >( fourierSize / m_synthesisHop );
+   m_inputBegin = getAnalysisStart( m_iFrame );
+   m_input.assign( -m_inputBegin, 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getStretchFactor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double PhaseVocoder::getStretchFactor() const
+{
+   return m_stretchFactor;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getLatency
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double PhaseVocoder::getLatency() const
+{
+   return m_fourierSize / m_samplingInfo.getSamplingRate();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// write
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PhaseVocoder::write( const double* input, size_t numSamples )
+{
+   assert( !m_isFinished );
+   m_input.insert( m_input.end(), input, input + numSamples );
+   m_numInput += numSamples;
+   while ( getAnalysisStart( m_iFrame ) + static_cast< long >( m_fourierSize ) <= m_inputBegin + static_cast< long >( m_input.size() ) )
+   {
+      processFrame();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// finish
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PhaseVocoder::finish()
+{
+   if ( m_isFinished )
+   {
+      return;
+   }
+   m_isFinished = true;
+
+   /// Process the frames that start within the input, with zeros after the end.
+   while ( getAnalysisStart( m_iFrame ) < static_cast< long >( m_numInput ) )
+   {
+      const long end = getAnalysisStart( m_iFrame ) + m_fourierSize;
+      m_input.resize( std::max( end - m_inputBegin, static_cast< long >( m_input.size() ) ), 0 );
+      processFrame();
+   }
+
+   /// The rest of the overlap-add buffer is the tail of the output.
+   for ( size_t i = 0; i < m_accumulator.size(); ++i )
+   {
+      if ( m_iFrame * static_cast< long >( m_synthesisHop ) + static_cast< long >( i ) >= 0 )
+      {
+         m_output.push_back( m_accumulator[ i ] );
+         ++m_numOutput;
+      }
+   }
+
+   /// Cut or pad to the stretched input length.
+   const size_t numOutputTotal = static_cast< size_t >( floor( m_numInput * m_stretchFactor + 0.5 ) );
+   const size_t numRemove = std::min( m_numOutput - std::min( m_numOutput, numOutputTotal ), m_output.size() );
+   m_output.resize( m_output.size() - numRemove );
+   if ( m_numOutput < numOutputTotal )
+   {
+      m_output.resize( m_output.size() + numOutputTotal - m_numOutput, 0 );
+   }
+   m_numOutput = numOutputTotal;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumAvailable
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t PhaseVocoder::getNumAvailable() const
+{
+   return m_output.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// read
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t PhaseVocoder::read( double* output, size_t maxSamples )
+{
+   const size_t numSamples = std::min( maxSamples, m_output.size() );
+   std::copy( m_output.begin(), m_output.begin() + numSamples, output );
+   m_output.erase( m_output.begin(), m_output.begin() + numSamples );
+   return numSamples;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getAnalysisStart
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+long PhaseVocoder::getAnalysisStart( long iFrame ) const
+{
+   return static_cast< long >( floor( iFrame * static_cast< double >( m_synthesisHop ) / m_stretchFactor + 0.5 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// processFrame
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PhaseVocoder::processFrame()
+{
+   const size_t spectrumDimension = m_fftw.getSpectrumDimension();
+   const long analysisStart = getAnalysisStart( m_iFrame );
+   const double analysisHop = analysisStart - getAnalysisStart( m_iFrame - 1 );
+   const double synthesisHop = m_synthesisHop;
+
+   /// Analysis.
+   double* timeData = m_fftw.getTimeDataWorkingArray();
+   const double* input = &m_input[ analysisStart - m_inputBegin ];
+   for ( size_t i = 0; i < m_fourierSize; ++i )
+   {
+      timeData[ i ] = m_window[ i ] * input[ i ];
+   }
+   m_fftw.transform();
+   Complex* spectrum = m_fftw.getFourierDataWorkingArray();
+
+   /// Peaks are local maxima of the power spectrum.
+   for ( size_t k = 0; k < spectrumDimension; ++k )
+   {
+      m_power[ k ] = std::norm( spectrum[ k ] );
+   }
+   m_peaks.clear();
+   for ( size_t k = 1; k + 1 < spectrumDimension; ++k )
+   {
+      if ( m_power[ k ] > m_power[ k - 1 ] && m_power[ k ] >= m_power[ k + 1 ] )
+      {
+         m_peaks.push_back( k );
+      }
+   }
+
+   /// Propagate the phase of each peak with its instantaneous frequency; a peak without a predecessor keeps its phase.
+   m_rotation.resize( m_peaks.size() );
+   for ( size_t iPeak = 0; iPeak < m_peaks.size(); ++iPeak )
+   {
+      const size_t k = m_peaks[ iPeak ];
+      if ( std::norm( m_prevSpectrum[ k ] ) == 0 )
+      {
+         m_rotation[ iPeak ] = 1;
+         continue;
+      }
+      const double binFrequency = 2 * M_PI * k / m_fourierSize;
+      double phaseDeviation = std::arg( spectrum[ k ] * std::conj( m_prevSpectrum[ k ] ) ) - binFrequency * analysisHop;
+      phaseDeviation -= 2 * M_PI * floor( phaseDeviation / ( 2 * M_PI ) + 0.5 );
+      const double frequency = binFrequency + phaseDeviation / analysisHop;
+      const double phase = std::arg( m_prevSynthesis[ k ] ) + frequency * synthesisHop;
+      m_rotation[ iPeak ] = std::polar( 1.0, phase ) * std::conj( spectrum[ k ] ) / sqrt( m_power[ k ] );
+   }
+   std::copy( spectrum, spectrum + spectrumDimension, m_prevSpectrum.begin() );
+
+   /// Identity phase locking: every bin is rotated like the peak in whose region it lies. Regions are separated at the
+   /// minimum of the power between adjacent peaks.
+   size_t regionBegin = 0;
+   for ( size_t iPeak = 0; iPeak < m_peaks.size(); ++iPeak )
+   {
+      size_t regionEnd = spectrumDimension;
+      if ( iPeak + 1 < m_peaks.size() )
+      {
+         regionEnd = std::min_element( m_power.begin() + m_peaks[ iPeak ] + 1, m_power.begin() + m_peaks[ iPeak + 1 ] + 1 ) - m_power.begin();
+      }
+      const Complex rotation = m_rotation[ iPeak ];
+      for ( size_t k = regionBegin; k < regionEnd; ++k )
+      {
+         spectrum[ k ] *= rotation;
+      }
+      regionBegin = regionEnd;
+   }
+   std::copy( spectrum, spectrum + spectrumDimension, m_prevSynthesis.begin() );
+
+   /// Synthesis and overlap-add.
+   m_fftw.reverseTransform();
+   for ( size_t i = 0; i < m_fourierSize; ++i )
+   {
+      m_accumulator[ i ] += m_scale * m_window[ i ] * timeData[ i ];
+   }
+   if ( m_iFrame >= 0 )
+   {
+      m_output.insert( m_output.end(), m_accumulator.begin(), m_accumulator.begin() + m_synthesisHop );
+      m_numOutput += m_synthesisHop;
+   }
+   std::copy( m_accumulator.begin() + m_synthesisHop, m_accumulator.end(), m_accumulator.begin() );
+   std::fill( m_accumulator.end() - m_synthesisHop, m_accumulator.end(), 0.0 );
+
+   /// Drop the input before the next frame.
+   ++m_iFrame;
+   const size_t numDrop = std::min( static_cast< size_t >( getAnalysisStart( m_iFrame ) - m_inputBegin ), m_input.size() );
+   m_input.erase( m_input.begin(), m_input.begin() + numDrop );
+   m_inputBegin += numDrop;
+}
+
+} /// namespace Music
@@ -0,0 +1,110 @@
+#ifndef PHASEVOCODER_H
+#define PHASEVOCODER_H
+
+#include "FftwAlgorithm.h"
+#include "RealVector.h"
+#include "SamplingInfo.h"
+#include "Typedefs.h"
+
+namespace Music
+{
+
+/**
+ * @class PhaseVocoder
+ * @brief Streaming time stretcher with a phase-locked vocoder.
+ *
+ * Input samples are written in blocks of any size and the stretched output is read as soon as it is complete.
+ * Frames of the Fourier size are analysed with a Hann window at a hop of the synthesis hop (a quarter of the Fourier
+ * size) divided by the stretch factor, and overlap-added at the synthesis hop. The phases are propagated with the
+ * instantaneous frequency of the peaks (local maxima of the magnitude spectrum) only; every other bin keeps its phase
+ * relative to the peak in whose region of influence it lies (identity phase locking). This keeps the partials
+ * coherent and only costs a few complex multiplications per bin on top of the two FFTs per frame.
+ *
+ * An output sample is complete once the input up to one Fourier size after the corresponding input sample has been
+ * written (@see getLatency). The end of the input is marked with finish, after which the remaining output can be read;
+ * the total output length is the input length times the stretch factor.
+ */
+class PhaseVocoder
+{
+   public:
+      /**
+       * Constructor.
+       * @param stretchFactor: ratio of output duration and input duration.
+       * @param samplingInfo: sampling info of the input and output.
+       * @param fourierSize: frame size, should be a multiple of 4.
+       */
+      PhaseVocoder( double stretchFactor, const SamplingInfo& samplingInfo, size_t fourierSize = 1024 );
+
+      /**
+       * Get the stretch factor.
+       */
+      double getStretchFactor() const;
+      /**
+       * Get the algorithmic latency in seconds: the time between writing an input sample and the output that
+       * corresponds to it becoming available.
+       */
+      double getLatency() const;
+
+      /**
+       * Process @param numSamples samples in @param input.
+       */
+      void write( const double* input, size_t numSamples );
+      /**
+       * Mark the end of the input; the remaining output becomes available.
+       */
+      void finish();
+      /**
+       * Get the number of output samples that can be read.
+       */
+      size_t getNumAvailable() const;
+      /**
+       * Write at most @param maxSamples output samples to @param output. Returns the number of samples.
+       */
+      size_t read( double* output, size_t maxSamples );
+
+   private:
+      /**
+       * Get the (possibly negative) input sample at which frame @param iFrame starts.
+       */
+      long getAnalysisStart( long iFrame ) const;
+      /**
+       * Analyse and synthesise the next frame and overlap-add it.
+       */
+      void processFrame();
+
+   private:
+      double                        m_stretchFactor;     //! Ratio of output and input duration.
+      SamplingInfo                  m_samplingInfo;      //! Sampling info.
+      size_t                        m_fourierSize;       //! Frame size.
+      size_t                        m_synthesisHop;      //! Hop between output frames.
+      RealVector                    m_window;            //! Analysis and synthesis window.
+      double                        m_scale;             //! Overlap-add and inverse FFT normalisation.
+      WaveAnalysis::FftwAlgorithm   m_fftw;              //! Fourier transforms.
+
+      long                          m_iFrame;            //! Index of the next frame, negative frames lie before the input.
+      long                          m_inputBegin;        //! Input sample index of m_input[ 0 ].
+      RealVector                    m_input;             //! Input samples that are still needed.
+      size_t                        m_numInput;          //! Number of input samples written.
+      bool                          m_isFinished;        //! Whether finish was called.
+
+      ComplexVector                 m_prevSpectrum;      //! Analysis spectrum of the previous frame.
+      ComplexVector                 m_prevSynthesis;     //! Synthesis spectrum of the previous frame.
+      RealVector                    m_power;             //! Power spectrum of the current frame.
+      std::vector< size_t >         m_peaks;             //! Peak bins of the current frame.
+      ComplexVector                 m_rotation;          //! Phase rotation per peak.
+
+      RealVector                    m_accumulator;       //! Overlap-add buffer starting at output sample m_iFrame * hop.
+      RealVector                    m_output;            //! Complete output samples that have not been read.
+      size_t                        m_numOutput;         //! Number of output samples produced.
+
+   /**
+    * Blocked copy-constructor and assignment
+    */
+   private:
+      PhaseVocoder( const PhaseVocoder& other );
+      PhaseVocoder& operator=( const PhaseVocoder& other );
+};
+
+} /// namespace Music
+
+#endif // PHASEVOCODER_H
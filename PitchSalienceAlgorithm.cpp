@@ -0,0 +1,236 @@
+#include "PitchSalienceAlgorithm.h"
+
+#include "FourierConfig.h"
+#include "FourierSpectrum.h"
+#include "Logger.h"
+#include "SrSpectrum.h"
+#include "StftData.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+/// Anonymous namespace
+namespace
+{
+   bool isMoreSalient( const Feature::PitchCandidate& a, const Feature::PitchCandidate& b )
+   {
+      return a.getSalience() > b.getSalience();
+   }
+}
+
+namespace FeatureAlgorithm
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+PitchSalienceAlgorithm::PitchSalienceAlgorithm( const WaveAnalysis::FourierConfig& config, double minF0, double maxF0, size_t numHarmonics, double harmonicDecay,
+                                                double centsPerCandidate, size_t maxNumCandidates, const std::string& name, const AlgorithmBase* parent ) :
+   AlgorithmBase( name, parent ),
+   m_binWidth( config.getFrequencyBinWidth() ),
+   m_spectrumDimension( config.getSpectrumDimension() ),
+   m_logCandidateStep( centsPerCandidate / 1200 * log( 2.0 ) ),
+   m_maxNumCandidates( maxNumCandidates )
+{
+   assert( minF0 > 0 && maxF0 > minF0 );
+   initialise( minF0, maxF0, numHarmonics, harmonicDecay, centsPerCandidate );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// initialise
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PitchSalienceAlgorithm::initialise( double minF0, double maxF0, size_t numHarmonics, double harmonicDecay, double centsPerCandidate )
+{
+   size_t numCandidates = static_cast< size_t >( log( maxF0 / minF0 ) / m_logCandidateStep ) + 1;
+   m_candidateFrequencies.resize( numCandidates );
+   for ( size_t iCand = 0; iCand < numCandidates; ++iCand )
+   {
+      m_candidateFrequencies[ iCand ] = minF0 * exp( iCand * m_logCandidateStep );
+   }
+
+   m_rowBegin.resize( numCandidates + 1 );
+   for ( size_t iCand = 0; iCand < numCandidates; ++iCand )
+   {
+      m_rowBegin[ iCand ] = m_binIndex.size();
+      double weight = 1;
+      for ( size_t iHarm = 1; iHarm <= numHarmonics; ++iHarm )
+      {
+         addHarmonic( iCand, iHarm, weight );
+         weight *= harmonicDecay;
+      }
+   }
+   m_rowBegin[ numCandidates ] = m_binIndex.size();
+
+   m_magnitudes.resize( m_spectrumDimension );
+   m_salience.resize( numCandidates );
+
+   getLogger() << Msg::Debug << "Initialised " << numCandidates << " candidates at " << centsPerCandidate << " cents with "
+               << m_binIndex.size() << " bin mapping elements." << Msg::EndReq;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// addHarmonic
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PitchSalienceAlgorithm::addHarmonic( size_t iCand, double harmonic, double weight )
+{
+   double freq = harmonic * m_candidateFrequencies[ iCand ];
+   double freqLow = freq * exp( -m_logCandidateStep );
+   double freqHigh = freq * exp( m_logCandidateStep );
+
+   /// Harmonics (partly) above the last Fourier bin are dropped.
+   if ( freqHigh / m_binWidth >= m_spectrumDimension - 1 )
+   {
+      return;
+   }
+
+   /// The triangular weight of the harmonic spans the lattice cell [freqLow, freqHigh]. A cell narrower than two Fourier
+   /// bins contains at most two bin centres, possibly only one at the edge of the triangle or none at all, so sampling
+   /// the triangle there gives weights that depend on where freq falls between the bins. Below that width the
+   /// magnitude is interpolated linearly at freq instead, which always gives the harmonic its full weight.
+   if ( freqHigh - freqLow < 2 * m_binWidth )
+   {
+      /// Lattice cell narrower than two Fourier bins: linear interpolation of the magnitude at freq.
+      double pos = freq / m_binWidth;
+      size_t iBin = static_cast< size_t >( pos );
+      double frac = pos - iBin;
+      m_binIndex.push_back( iBin );
+      m_weight.push_back( weight * ( 1 - frac ) );
+      m_binIndex.push_back( iBin + 1 );
+      m_weight.push_back( weight * frac );
+   }
+   else
+   {
+      /// Lattice cell at least two Fourier bins wide: triangular weights in log-frequency over the bins it contains.
+      size_t iBinBegin = static_cast< size_t >( ceil( freqLow / m_binWidth ) );
+      size_t iBinEnd = static_cast< size_t >( floor( freqHigh / m_binWidth ) ) + 1;
+      for ( size_t iBin = iBinBegin; iBin < iBinEnd; ++iBin )
+      {
+         double dist = fabs( log( iBin * m_binWidth / freq ) ) / m_logCandidateStep;
+         if ( dist < 1 )
+         {
+            m_binIndex.push_back( iBin );
+            m_weight.push_back( weight * ( 1 - dist ) );
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// execute
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+std::vector< PitchSalienceAlgorithm::CandidateList > PitchSalienceAlgorithm::execute( const WaveAnalysis::StftData& stftData )
+{
+   assert( stftData.getConfig().getSpectrumDimension() == m_spectrumDimension );
+
+   std::vector< CandidateList > result( stftData.getNumSpectra() );
+   for ( size_t iHop = 0; iHop < stftData.getNumSpectra(); ++iHop )
+   {
+      calculateSalience( stftData.getSpectrum( iHop ), m_salience );
+      result[ iHop ] = selectCandidates( m_salience );
+   }
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// execute
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+PitchSalienceAlgorithm::CandidateList PitchSalienceAlgorithm::execute( const WaveAnalysis::FourierSpectrum& spectrum )
+{
+   calculateSalience( spectrum, m_salience );
+   return selectCandidates( m_salience );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calculateSalience
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PitchSalienceAlgorithm::calculateSalience( const WaveAnalysis::FourierSpectrum& spectrum, RealVector& salience )
+{
+   assert( spectrum.getConfig().getSpectrumDimension() == m_spectrumDimension );
+
+   fillMagnitudes( spectrum );
+
+   /// Sparse matrix-vector product; the inner loop is a gathered dot product without dependencies between candidates.
+   const size_t numCandidates = m_candidateFrequencies.size();
+   salience.resize( numCandidates );
+   const double* magnitudes = m_magnitudes.data();
+   const int* binIndex = m_binIndex.data();
+   const double* weight = m_weight.data();
+   for ( size_t iCand = 0; iCand < numCandidates; ++iCand )
+   {
+      double sum = 0;
+      const size_t iEnd = m_rowBegin[ iCand + 1 ];
+      for ( size_t i = m_rowBegin[ iCand ]; i < iEnd; ++i )
+      {
+         sum += weight[ i ] * magnitudes[ binIndex[ i ] ];
+      }
+      salience[ iCand ] = sum;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// fillMagnitudes
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PitchSalienceAlgorithm::fillMagnitudes( const WaveAnalysis::FourierSpectrum& spectrum )
+{
+   const WaveAnalysis::SrSpectrum* srSpectrum = dynamic_cast< const WaveAnalysis::SrSpectrum* >( &spectrum );
+   if ( srSpectrum == 0 )
+   {
+      for ( size_t iBin = 0; iBin < m_spectrumDimension; ++iBin )
+      {
+         m_magnitudes[ iBin ] = spectrum.getMagnitudeInBin( iBin );
+      }
+      return;
+   }
+
+   /// Rebin the corrected frequencies to the nearest Fourier bin (@see SrSpectrum::rebinToFourierLattice).
+   std::fill( m_magnitudes.begin(), m_magnitudes.end(), 0.0 );
+   const RealVector& frequencies = srSpectrum->getFrequencies();
+   for ( size_t iBin = 0; iBin < m_spectrumDimension; ++iBin )
+   {
+      double pos = frequencies[ iBin ] / m_binWidth + 0.5;
+      if ( pos >= 0 && pos < m_spectrumDimension )
+      {
+         m_magnitudes[ static_cast< size_t >( pos ) ] += srSpectrum->getMagnitudeInBin( iBin );
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// selectCandidates
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+PitchSalienceAlgorithm::CandidateList PitchSalienceAlgorithm::selectCandidates( const RealVector& salience ) const
+{
+   CandidateList result;
+   for ( size_t iCand = 1; iCand + 1 < salience.size(); ++iCand )
+   {
+      double left = salience[ iCand - 1 ];
+      double centre = salience[ iCand ];
+      double right = salience[ iCand + 1 ];
+      if ( centre <= left || centre < right || centre <= 0 )
+      {
+         continue;
+      }
+
+      /// Parabolic interpolation in log-frequency.
+      double delta = 0.5 * ( left - right ) / ( left - 2 * centre + right );
+      double frequency = m_candidateFrequencies[ iCand ] * exp( delta * m_logCandidateStep );
+      double peakSalience = centre - 0.25 * ( left - right ) * delta;
+      result.push_back( Feature::PitchCandidate( frequency, peakSalience ) );
+   }
+
+   size_t numSelected = std::min( result.size(), m_maxNumCandidates );
+   std::partial_sort( result.begin(), result.begin() + numSelected, result.end(), isMoreSalient );
+   result.resize( numSelected, Feature::PitchCandidate( 0, 0 ) );
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getCandidateFrequencies
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const RealVector& PitchSalienceAlgorithm::getCandidateFrequencies() const
+{
+   return m_candidateFrequencies;
+}
+
+} /// namespace FeatureAlgorithm
@@ -0,0 +1,178 @@
+#ifndef PITCHSALIENCEALGORITHM_H
+#define PITCHSALIENCEALGORITHM_H
+
+#include "AlgorithmBase.h"
+#include "RealVector.h"
+
+#include <vector>
+
+/// Forward declarations.
+namespace WaveAnalysis
+{
+class FourierConfig;
+class FourierSpectrum;
+class StftData;
+}
+
+namespace Feature
+{
+
+/**
+ * @class PitchCandidate
+ * @brief Fundamental frequency candidate with its salience (weighted harmonic sum).
+ */
+class PitchCandidate
+{
+   public:
+      /**
+       * Create a PitchCandidate with fundamental frequency @param frequency and @param salience.
+       */
+      PitchCandidate( double frequency, double salience );
+
+      /**
+       * Get the fundamental frequency of the candidate.
+       */
+      double getFrequency() const;
+      /**
+       * Get the salience of the candidate.
+       */
+      double getSalience() const;
+
+   private:
+      double      m_frequency;        //! Fundamental frequency.
+      double      m_salience;         //! Salience.
+};
+
+} /// namespace Feature
+
+
+
+namespace FeatureAlgorithm
+{
+
+/**
+ * @class PitchSalienceAlgorithm
+ * @brief Harmonic sum (sub-harmonic summation) pitch salience for all spectra of an StftData.
+ *
+ * The salience of a fundamental frequency candidate f0 is the weighted sum of the spectral magnitude at its harmonics
+ * k * f0, with weight harmonicDecay^( k - 1 ) for k = 1 .. numHarmonics. The candidates lie on a logarithmic lattice
+ * between minF0 and maxF0. Where the lattice cell of a harmonic is at least two Fourier bins wide, the magnitudes of all
+ * bins in the cell are summed with triangular weights (i.e. each bin magnitude is accumulated at f / k in a histogram
+ * with linear binning, as in GroundtoneHypothesisBuilder). Where it is narrower, the triangle would hit at most two
+ * bins, so the magnitude is linearly interpolated at k * f0 instead.
+ *
+ * The mapping from Fourier bins to candidates only depends on the FourierConfig and is precomputed at construction as a
+ * sparse matrix in flat arrays (compressed rows). Per spectrum, the salience is then a sparse matrix-vector product in
+ * tight loops that the compiler can vectorise, without allocations. Reassigned spectra are first rebinned to the
+ * Fourier lattice.
+ */
+class PitchSalienceAlgorithm : public AlgorithmBase
+{
+   public:
+      typedef std::vector< Feature::PitchCandidate > CandidateList;
+
+   public:
+      /**
+       * Create a PitchSalienceAlgorithm for spectra with Fourier configuration @param config.
+       * @param minF0, maxF0: range of fundamental frequencies.
+       * @param numHarmonics: number of harmonics (including the fundamental) in the sum.
+       * @param harmonicDecay: weight ratio between subsequent harmonics.
+       * @param centsPerCandidate: spacing of the candidate lattice in cents.
+       * @param maxNumCandidates: maximum number of candidates returned per spectrum.
+       * For other parameters @see AlgorithmBase.
+       */
+      PitchSalienceAlgorithm( const WaveAnalysis::FourierConfig& config, double minF0 = 50, double maxF0 = 2000, size_t numHarmonics = 10, double harmonicDecay = 0.8,
+                              double centsPerCandidate = 10, size_t maxNumCandidates = 5, const std::string& name = "PitchSalienceAlgorithm", const AlgorithmBase* parent = 0 );
+
+      /**
+       * Find the fundamental frequency candidates for every spectrum in @param stftData, ranked by decreasing salience.
+       * The Fourier configuration of @param stftData should be the one passed at construction.
+       */
+      std::vector< CandidateList > execute( const WaveAnalysis::StftData& stftData );
+      /**
+       * Find the fundamental frequency candidates in @param spectrum, ranked by decreasing salience.
+       */
+      CandidateList execute( const WaveAnalysis::FourierSpectrum& spectrum );
+
+      /**
+       * Calculate the salience of all candidate frequencies (@see getCandidateFrequencies) for @param spectrum into
+       * @param salience.
+       */
+      void calculateSalience( const WaveAnalysis::FourierSpectrum& spectrum, RealVector& salience );
+
+      /**
+       * Get the lattice of candidate fundamental frequencies.
+       */
+      const RealVector& getCandidateFrequencies() const;
+
+   private:
+      /**
+       * Fill the sparse bin to candidate mapping.
+       */
+      void initialise( double minF0, double maxF0, size_t numHarmonics, double harmonicDecay, double centsPerCandidate );
+      /**
+       * Add the contribution of harmonic @param harmonic of candidate @param iCand with @param weight to the mapping.
+       */
+      void addHarmonic( size_t iCand, double harmonic, double weight );
+      /**
+       * Fill m_magnitudes with the magnitude on the Fourier lattice of @param spectrum.
+       */
+      void fillMagnitudes( const WaveAnalysis::FourierSpectrum& spectrum );
+      /**
+       * Select the local maxima of @param salience and return the largest, ranked by decreasing salience.
+       */
+      CandidateList selectCandidates( const RealVector& salience ) const;
+
+   private:
+      double                  m_binWidth;             //! Frequency bin width of the Fourier spectrum.
+      size_t                  m_spectrumDimension;    //! Number of bins in the Fourier spectrum.
+      double                  m_logCandidateStep;     //! Logarithm of the frequency ratio between subsequent candidates.
+      size_t                  m_maxNumCandidates;     //! Maximum number of returned candidates per spectrum.
+      RealVector              m_candidateFrequencies; //! Lattice of candidate frequencies.
+
+      std::vector< size_t >   m_rowBegin;             //! Index of the first mapping element per candidate (and end).
+      std::vector< int >      m_binIndex;             //! Fourier bin index per mapping element.
+      RealVector              m_weight;               //! Weight per mapping element.
+
+      RealVector              m_magnitudes;           //! Working array for the magnitudes on the Fourier lattice.
+      RealVector              m_salience;             //! Working array for the salience.
+};
+
+} /// namespace FeatureAlgorithm
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Inline methods PitchCandidate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Feature
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline PitchCandidate::PitchCandidate( double frequency, double salience ) :
+   m_frequency( frequency ),
+   m_salience( salience )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getFrequency
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline double PitchCandidate::getFrequency() const
+{
+   return m_frequency;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getSalience
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline double PitchCandidate::getSalience() const
+{
+   return m_salience;
+}
+
+} /// namespace Feature
+
+#endif // PITCHSALIENCEALGORITHM_H
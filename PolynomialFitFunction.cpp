@@ -25,6 +25,31 @@ double PolynomialFitFunction::operator()( double x ) const
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// hasParameterGradient
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool PolynomialFitFunction::hasParameterGradient() const
+{
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// evalWithParameterGradient
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double PolynomialFitFunction::evalWithParameterGradient( double x, double* parGradient ) const
+{
+   double result = par( 0 );
+   double monomial = 1;
+   parGradient[ 0 ] = 1;
+   for ( size_t i = 1; i < getNumParameters(); ++i )
+   {
+      monomial *= x;
+      result += par( i ) * monomial;
+      parGradient[ i ] = monomial;
+   }
+   return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// clone
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
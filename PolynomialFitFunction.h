@@ -23,6 +23,14 @@ class PolynomialFitFunction : public FitFunctionBase
        * Defined in @see FitFunctionBase.
        */
       double operator()( double x ) const;
+      /**
+       * Defined in @see FitFunctionBase. The derivative with respect to parameter i is x^i.
+       */
+      bool hasParameterGradient() const;
+      /**
+       * Defined in @see FitFunctionBase.
+       */
+      double evalWithParameterGradient( double x, double* parGradient ) const;
       /**
        * Defined in @see IRealFunction.
        */
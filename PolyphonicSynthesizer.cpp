@@ -0,0 +1,282 @@
+#include "PolyphonicSynthesizer.h"
+
+#include "IGenerator.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Synthesizer
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// ScheduledNote constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+PolyphonicSynthesizer::ScheduledNote::ScheduledNote( double frequency, double amplitude, size_t startSample, size_t numSamples ) :
+   m_frequency( frequency ),
+   m_amplitude( amplitude ),
+   m_startSample( startSample ),
+   m_endSample( startSample + numSamples )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Voice constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+PolyphonicSynthesizer::Voice::Voice( IGenerator* generator ) :
+   m_generator( generator ),
+   m_iNextNote( 0 )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+PolyphonicSynthesizer::PolyphonicSynthesizer( const SamplingInfo& samplingInfo, size_t numThreads ) :
+   m_samplingInfo( samplingInfo ),
+   m_numThreads( std::max( numThreads, size_t( 1 ) ) ),
+   m_workerPool( new WorkerPool( m_numThreads ) ),
+   m_groupBuffers( m_numThreads ),
+   m_position( 0 ),
+   m_lastStartSample( 0 ),
+   m_endSample( 0 ),
+   m_numStolenNotes( 0 )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// destructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+PolyphonicSynthesizer::~PolyphonicSynthesizer()
+{
+   for ( size_t iVoice = 0; iVoice < m_voices.size(); ++iVoice )
+   {
+      delete m_voices[ iVoice ].m_generator;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// addVoice
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PolyphonicSynthesizer::addVoice( IGenerator* voice )
+{
+   assert( voice );
+   m_voices.push_back( Voice( voice ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumVoices
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t PolyphonicSynthesizer::getNumVoices() const
+{
+   return m_voices.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// addNote
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PolyphonicSynthesizer::addNote( double frequency, double amplitude, size_t startSample, size_t numSamples )
+{
+   assert( !m_voices.empty() );
+   assert( startSample >= m_lastStartSample );
+   assert( startSample >= m_position );
+
+   size_t iVoice = allocateVoice( startSample );
+   m_voices[ iVoice ].m_notes.push_back( ScheduledNote( frequency, amplitude, startSample, numSamples ) );
+   m_lastStartSample = startSample;
+   m_endSample = std::max( m_endSample, startSample + numSamples );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// addMelody
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t PolyphonicSynthesizer::addMelody( const std::vector< Music::Note >& notes, double bpm, double amplitude, size_t startSample )
+{
+   for ( size_t iNote = 0; iNote < notes.size(); ++iNote )
+   {
+      size_t numSamples = notes[ iNote ].getDuration().getNumSamples( bpm, m_samplingInfo );
+      addNote( notes[ iNote ].getFrequency(), amplitude, startSample, numSamples );
+      startSample += numSamples;
+   }
+   return startSample;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// addChord
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t PolyphonicSynthesizer::addChord( const std::vector< Music::Note >& notes, double bpm, double amplitude, size_t startSample )
+{
+   size_t endSample = startSample;
+   for ( size_t iNote = 0; iNote < notes.size(); ++iNote )
+   {
+      size_t numSamples = notes[ iNote ].getDuration().getNumSamples( bpm, m_samplingInfo );
+      addNote( notes[ iNote ].getFrequency(), amplitude, startSample, numSamples );
+      endSample = std::max( endSample, startSample + numSamples );
+   }
+   return endSample;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// allocateVoice
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t PolyphonicSynthesizer::allocateVoice( size_t startSample )
+{
+   /// A voice is free if its last note has ended; otherwise remember the voice with the oldest note.
+   size_t iOldest = 0;
+   size_t oldestStart = static_cast< size_t >( -1 );
+   for ( size_t iVoice = 0; iVoice < m_voices.size(); ++iVoice )
+   {
+      const std::vector< ScheduledNote >& notes = m_voices[ iVoice ].m_notes;
+      if ( notes.empty() || notes.back().m_endSample <= startSample )
+      {
+         return iVoice;
+      }
+      if ( notes.back().m_startSample < oldestStart )
+      {
+         oldestStart = notes.back().m_startSample;
+         iOldest = iVoice;
+      }
+   }
+
+   /// Voice stealing: the oldest note is cut off where the new note starts.
+   m_voices[ iOldest ].m_notes.back().m_endSample = startSample;
+   ++m_numStolenNotes;
+   return iOldest;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// render
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PolyphonicSynthesizer::render( double* buffer, size_t numSamples )
+{
+   std::fill( buffer, buffer + numSamples, 0.0 );
+
+   /// Group 0 renders directly into the buffer, the other groups into their own buffers, which are added afterwards.
+   const size_t numGroups = getNumGroups();
+   for ( size_t iGroup = 1; iGroup < numGroups; ++iGroup )
+   {
+      if ( m_groupBuffers[ iGroup ].size() < numSamples )
+      {
+         m_groupBuffers[ iGroup ].resize( numSamples );
+      }
+   }
+
+   m_workerPool->run( numGroups, [ this, buffer, numSamples ]( size_t iGroup )
+   {
+      double* groupBuffer = buffer;
+      if ( iGroup > 0 )
+      {
+         groupBuffer = m_groupBuffers[ iGroup ].data();
+         std::fill( groupBuffer, groupBuffer + numSamples, 0.0 );
+      }
+      renderGroup( iGroup, groupBuffer, numSamples );
+   } );
+
+   for ( size_t iGroup = 1; iGroup < numGroups; ++iGroup )
+   {
+      const double* groupBuffer = m_groupBuffers[ iGroup ].data();
+      for ( size_t iSample = 0; iSample < numSamples; ++iSample )
+      {
+         buffer[ iSample ] += groupBuffer[ iSample ];
+      }
+   }
+
+   m_position += numSamples;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// generate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RawPcmData::Ptr PolyphonicSynthesizer::generate()
+{
+   size_t numSamples = m_endSample > m_position ? m_endSample - m_position : 0;
+   RawPcmData* result = new RawPcmData( m_samplingInfo, numSamples );
+   if ( numSamples > 0 )
+   {
+      render( &(*result)[ 0 ], numSamples );
+   }
+   return RawPcmData::Ptr( result );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// renderGroup
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PolyphonicSynthesizer::renderGroup( size_t iGroup, double* buffer, size_t numSamples )
+{
+   const size_t numGroups = getNumGroups();
+   for ( size_t iVoice = iGroup; iVoice < m_voices.size(); iVoice += numGroups )
+   {
+      renderVoice( m_voices[ iVoice ], buffer, numSamples );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// renderVoice
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void PolyphonicSynthesizer::renderVoice( Voice& voice, double* buffer, size_t numSamples )
+{
+   const size_t begin = m_position;
+   const size_t end = m_position + numSamples;
+   while ( voice.m_iNextNote < voice.m_notes.size() )
+   {
+      const ScheduledNote& note = voice.m_notes[ voice.m_iNextNote ];
+      if ( note.m_startSample >= end )
+      {
+         break;
+      }
+
+      /// Note-on.
+      if ( note.m_startSample >= begin )
+      {
+         voice.m_generator->setFrequency( note.m_frequency );
+         voice.m_generator->setAmplitude( note.m_amplitude );
+         voice.m_generator->setPhase( 0 );
+         voice.m_generator->resetEnvelopePhase();
+      }
+
+      const size_t first = std::max( note.m_startSample, begin );
+      const size_t last = std::min( note.m_endSample, end );
+      if ( last > first )
+      {
+         voice.m_generator->renderAdd( buffer + first - begin, last - first );
+      }
+
+      /// The note continues after this block.
+      if ( note.m_endSample > end )
+      {
+         break;
+      }
+      ++voice.m_iNextNote;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumGroups
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t PolyphonicSynthesizer::getNumGroups() const
+{
+   return std::min( m_numThreads, m_voices.size() );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getPosition
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t PolyphonicSynthesizer::getPosition() const
+{
+   return m_position;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getEndSample
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t PolyphonicSynthesizer::getEndSample() const
+{
+   return m_endSample;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumStolenNotes
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t PolyphonicSynthesizer::getNumStolenNotes() const
+{
+   return m_numStolenNotes;
+}
+
+} /// namespace Synthesizer
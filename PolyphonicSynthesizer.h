@@ -0,0 +1,163 @@
+#ifndef POLYPHONICSYNTHESIZER_H
+#define POLYPHONICSYNTHESIZER_H
+
+#include "Note.h"
+#include "RawPcmData.h"
+#include "RealVector.h"
+
+#include <memory>
+#include <vector>
+
+/// Forward declarations.
+class WorkerPool;
+
+namespace Synthesizer
+{
+
+/// Forward declarations.
+class IGenerator;
+
+/**
+ * @class PolyphonicSynthesizer
+ * @brief Renders many simultaneous notes with a fixed pool of voices (generators).
+ *
+ * Notes are scheduled with a start sample (note-on) and a number of samples (note-off) in order of start sample. Each
+ * note is assigned to a free voice at scheduling time; if all voices are busy, the oldest sounding note is cut off and
+ * its voice is reused (voice stealing). Rendering then only has to play back the notes assigned to each voice, in
+ * blocks of any size, without allocations.
+ *
+ * The voices are divided in groups, one per thread. Each group renders its voices into its own buffer and the group
+ * buffers are summed afterwards, so the result does not depend on the number of threads. The threads are kept in a
+ * WorkerPool for the lifetime of the synthesizer, so rendering in small blocks does not pay for starting threads.
+ */
+class PolyphonicSynthesizer
+{
+   public:
+      /**
+       * Create a PolyphonicSynthesizer for @param samplingInfo that renders with @param numThreads threads.
+       */
+      PolyphonicSynthesizer( const SamplingInfo& samplingInfo, size_t numThreads = 1 );
+      /**
+       * Destructor, deletes the voices.
+       */
+      ~PolyphonicSynthesizer();
+
+      /**
+       * Add @param voice to the pool of voices. The voice is owned by the PolyphonicSynthesizer.
+       * All voices should be added before the first note is scheduled.
+       */
+      void addVoice( IGenerator* voice );
+      /**
+       * Get the number of voices.
+       */
+      size_t getNumVoices() const;
+
+      /**
+       * Schedule a note with @param frequency and @param amplitude that starts at @param startSample and lasts for
+       * @param numSamples. Notes should be added in order of increasing start sample.
+       */
+      void addNote( double frequency, double amplitude, size_t startSample, size_t numSamples );
+      /**
+       * Schedule @param notes one after the other (a melody) at tempo @param bpm, starting at @param startSample.
+       * Returns the sample after the last note.
+       */
+      size_t addMelody( const std::vector< Music::Note >& notes, double bpm, double amplitude, size_t startSample );
+      /**
+       * Schedule @param notes at the same time (a chord) at tempo @param bpm, starting at @param startSample.
+       * Returns the sample after the longest note.
+       */
+      size_t addChord( const std::vector< Music::Note >& notes, double bpm, double amplitude, size_t startSample );
+
+      /**
+       * Render the next @param numSamples samples of all scheduled notes into @param buffer, overwriting its contents.
+       */
+      void render( double* buffer, size_t numSamples );
+      /**
+       * Render all scheduled notes from the current position until the last note-off.
+       */
+      RawPcmData::Ptr generate();
+
+      /**
+       * Get the next sample to be rendered.
+       */
+      size_t getPosition() const;
+      /**
+       * Get the sample after the last note-off.
+       */
+      size_t getEndSample() const;
+      /**
+       * Get the number of notes that were cut off by voice stealing.
+       */
+      size_t getNumStolenNotes() const;
+
+   private:
+      /**
+       * @class ScheduledNote
+       * @brief Note assigned to a voice.
+       */
+      class ScheduledNote
+      {
+         public:
+            ScheduledNote( double frequency, double amplitude, size_t startSample, size_t numSamples );
+
+            double      m_frequency;      //! Frequency.
+            double      m_amplitude;      //! Amplitude.
+            size_t      m_startSample;    //! Sample of the note-on.
+            size_t      m_endSample;      //! Sample after the note-off.
+      };
+
+      /**
+       * @class Voice
+       * @brief Generator with the notes it plays.
+       */
+      class Voice
+      {
+         public:
+            Voice( IGenerator* generator );
+
+            IGenerator*                   m_generator;   //! Generator (owned).
+            std::vector< ScheduledNote >  m_notes;       //! Notes in order of start sample.
+            size_t                        m_iNextNote;   //! First note that has not been completely rendered.
+      };
+
+   private:
+      /**
+       * Find the voice for a note starting at @param startSample; steals the oldest note if no voice is free.
+       */
+      size_t allocateVoice( size_t startSample );
+      /**
+       * Get the number of voice groups; voice i belongs to group i modulo the number of groups.
+       */
+      size_t getNumGroups() const;
+      /**
+       * Add the samples [m_position, m_position + @param numSamples) of the voices in group @param iGroup to
+       * @param buffer.
+       */
+      void renderGroup( size_t iGroup, double* buffer, size_t numSamples );
+      /**
+       * Add the samples [m_position, m_position + @param numSamples) of @param voice to @param buffer.
+       */
+      void renderVoice( Voice& voice, double* buffer, size_t numSamples );
+
+   private:
+      SamplingInfo                  m_samplingInfo;      //! Sampling info of the rendered data.
+      size_t                        m_numThreads;        //! Number of threads (and voice groups).
+      std::unique_ptr< WorkerPool > m_workerPool;        //! Threads that render the voice groups.
+      std::vector< Voice >          m_voices;            //! Pool of voices.
+      std::vector< RealVector >     m_groupBuffers;      //! Working buffers of the voice groups 1 .. numGroups - 1.
+      size_t                        m_position;          //! Next sample to be rendered.
+      size_t                        m_lastStartSample;   //! Start sample of the last scheduled note.
+      size_t                        m_endSample;         //! Sample after the last note-off.
+      size_t                        m_numStolenNotes;    //! Number of notes cut off by voice stealing.
+
+   /**
+    * Blocked copy-constructor and assignment
+    */
+   private:
+      PolyphonicSynthesizer( const PolyphonicSynthesizer& other );
+      PolyphonicSynthesizer& operator=( const PolyphonicSynthesizer& other );
+};
+
+} /// namespace Synthesizer
+
+#endif // POLYPHONICSYNTHESIZER_H
@@ -1,19 +1,142 @@
 #include "RandomNumberGenerator.h"
 
-#include "TRandom3.h"
+#include <algorithm>
+#include <cmath>
+
+/// Anonymous namespace
+namespace
+{
+   /**
+    * SplitMix64 step, used to expand the seed into the generator state.
+    */
+   uint64_t splitMix64( uint64_t& x )
+   {
+      uint64_t z = ( x += 0x9e3779b97f4a7c15ULL );
+      z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+      z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+      return z ^ ( z >> 31 );
+   }
+
+   /**
+    * Number of Box-Muller pairs per block in fillGauss.
+    */
+   const size_t s_gaussBlockSize = 128;
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// constructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-RandomNumberGenerator::RandomNumberGenerator( size_t seed )
+RandomNumberGenerator::RandomNumberGenerator( size_t seed, size_t stream ) :
+   m_hasSpareGauss( false ),
+   m_spareGauss( 0 )
 {
-   m_ranGen = new TRandom3( seed );
+   uint64_t x = seed;
+   for ( size_t i = 0; i < 4; ++i )
+   {
+      m_state[ i ] = splitMix64( x );
+   }
+   for ( size_t iStream = 0; iStream < stream; ++iStream )
+   {
+      jump();
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// destructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 RandomNumberGenerator::~RandomNumberGenerator()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// gauss
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double RandomNumberGenerator::gauss( double mean, double sigma )
+{
+   if ( m_hasSpareGauss )
+   {
+      m_hasSpareGauss = false;
+      return mean + sigma * m_spareGauss;
+   }
+
+   /// Box-Muller; 1 - u is in (0, 1], so the logarithm is finite.
+   const double r = sqrt( -2 * log( 1 - uniform() ) );
+   const double phi = 2 * M_PI * uniform();
+   m_spareGauss = r * sin( phi );
+   m_hasSpareGauss = true;
+   return mean + sigma * r * cos( phi );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// fillUniform
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void RandomNumberGenerator::fillUniform( double* result, size_t numValues, double xMin, double xMax )
+{
+   const double scale = ( xMax - xMin ) / 9007199254740992.0;
+   for ( size_t i = 0; i < numValues; ++i )
+   {
+      result[ i ] = xMin + ( next() >> 11 ) * scale;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// fillGauss
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void RandomNumberGenerator::fillGauss( double* result, size_t numValues, double mean, double sigma )
 {
-   delete m_ranGen;
+   /// Per block, the first half of the output gets the cosine and the second half the sine of the Box-Muller pairs.
+   /// The transform is split in separate loops (instead of a sincos call) so that each of them is vectorised.
+   double u[ 2 * s_gaussBlockSize ];
+   size_t iFirst = 0;
+   while ( numValues - iFirst >= 2 )
+   {
+      const size_t numPairs = std::min( s_gaussBlockSize, ( numValues - iFirst ) / 2 );
+      fillUniform( u, 2 * numPairs );
+      double* radius = u;
+      double* phi = u + numPairs;
+      for ( size_t i = 0; i < numPairs; ++i )
+      {
+         radius[ i ] = sigma * sqrt( -2 * log( 1 - radius[ i ] ) );
+         phi[ i ] *= 2 * M_PI;
+      }
+      double* first = result + iFirst;
+      for ( size_t i = 0; i < numPairs; ++i )
+      {
+         first[ i ] = mean + radius[ i ] * cos( phi[ i ] );
+      }
+      double* second = first + numPairs;
+      for ( size_t i = 0; i < numPairs; ++i )
+      {
+         second[ i ] = mean + radius[ i ] * sin( phi[ i ] );
+      }
+      iFirst += 2 * numPairs;
+   }
+   if ( iFirst < numValues )
+   {
+      result[ iFirst ] = gauss( mean, sigma );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// jump
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void RandomNumberGenerator::jump()
+{
+   static const uint64_t jumpPolynomial[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+   uint64_t state[ 4 ] = { 0, 0, 0, 0 };
+   for ( size_t iWord = 0; iWord < 4; ++iWord )
+   {
+      for ( size_t iBit = 0; iBit < 64; ++iBit )
+      {
+         if ( jumpPolynomial[ iWord ] & ( uint64_t( 1 ) << iBit ) )
+         {
+            for ( size_t i = 0; i < 4; ++i )
+            {
+               state[ i ] ^= m_state[ i ];
+            }
+         }
+         next();
+      }
+   }
+   std::copy( state, state + 4, m_state );
 }
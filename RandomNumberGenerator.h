@@ -2,21 +2,27 @@
 #define RANDOMNUMBERGENERATOR_H
 
 #include <cstddef>
-
-#include "TRandom3.h"
-
+#include <stdint.h>
 
 /**
  * @class RandomNumberGenerator
- * @brief Class that generates random numbers. Wraps the ROOT TRandom3 class.
+ * @brief Class that generates random numbers with the xoshiro256** algorithm.
+ *
+ * The generator has a period of 2^256 - 1 and a state of four 64 bit words, so it is cheap to copy and to keep one per
+ * thread. Independent, reproducible streams are derived from a single seed: stream i starts i * 2^128 numbers after
+ * stream 0 (@see jump), so streams never overlap in practice.
+ *
+ * Next to single draws, there are bulk fills that avoid per-number overhead. Gaussian numbers are generated with the
+ * Box-Muller transform, which in the bulk fill is applied to blocks of uniform numbers in a loop that the compiler can
+ * vectorise.
  */
 class RandomNumberGenerator
 {
    public:
       /**
-       * Constructor.
+       * Constructor. Create stream @param stream of the generator with @param seed.
        */
-      RandomNumberGenerator( size_t seed );
+      RandomNumberGenerator( size_t seed, size_t stream = 0 );
       /**
        * Destructor.
        */
@@ -35,8 +41,28 @@ class RandomNumberGenerator
        */
       double gauss( double mean, double sigma );
 
+      /**
+       * Fill @param result with @param numValues random numbers between @param xMin and @param xMax.
+       */
+      void fillUniform( double* result, size_t numValues, double xMin = 0, double xMax = 1 );
+      /**
+       * Fill @param result with @param numValues normal distributed numbers with @param mean and @param sigma.
+       */
+      void fillGauss( double* result, size_t numValues, double mean = 0, double sigma = 1 );
+
+      /**
+       * Get the next raw 64 bit random number.
+       */
+      uint64_t next();
+      /**
+       * Advance the generator by 2^128 numbers.
+       */
+      void jump();
+
    private:
-      TRandom3*      m_ranGen;         //! ROOT random number generator.
+      uint64_t       m_state[ 4 ];     //! State of the generator.
+      bool           m_hasSpareGauss;  //! Whether m_spareGauss holds the second number of the last Box-Muller pair.
+      double         m_spareGauss;     //! Second standard normal number of the last Box-Muller pair.
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -44,27 +70,37 @@ class RandomNumberGenerator
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// uniform
+/// next
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-inline double RandomNumberGenerator::uniform()
+inline uint64_t RandomNumberGenerator::next()
 {
-   return m_ranGen->Uniform();
+   const uint64_t x = m_state[ 1 ] * 5;
+   const uint64_t result = ( ( x << 7 ) | ( x >> 57 ) ) * 9;
+   const uint64_t t = m_state[ 1 ] << 17;
+   m_state[ 2 ] ^= m_state[ 0 ];
+   m_state[ 3 ] ^= m_state[ 1 ];
+   m_state[ 1 ] ^= m_state[ 2 ];
+   m_state[ 0 ] ^= m_state[ 3 ];
+   m_state[ 2 ] ^= t;
+   m_state[ 3 ] = ( m_state[ 3 ] << 45 ) | ( m_state[ 3 ] >> 19 );
+   return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// uniform
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-inline double RandomNumberGenerator::uniform( double xMin, double xMax )
+inline double RandomNumberGenerator::uniform()
 {
-   return m_ranGen->Uniform( xMin, xMax );
+   /// The upper 53 bits fill the mantissa, the result is in [0, 1).
+   return ( next() >> 11 ) * ( 1.0 / 9007199254740992.0 );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// gauss
+/// uniform
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-inline double RandomNumberGenerator::gauss( double mean, double sigma )
+inline double RandomNumberGenerator::uniform( double xMin, double xMax )
 {
-   return m_ranGen->Gaus( mean, sigma );
+   return xMin + ( xMax - xMin ) * uniform();
 }
 
 
@@ -0,0 +1,76 @@
+#include "RealTimeRenderer.h"
+
+#include <cmath>
+
+namespace Synthesizer
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// RenderStatistics constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RenderStatistics::RenderStatistics( double blockPeriod, const RealVector& renderTimes, size_t numUnderruns, double latency ) :
+   m_blockPeriod( blockPeriod ),
+   m_sortedRenderTimes( renderTimes ),
+   m_numUnderruns( numUnderruns ),
+   m_latency( latency )
+{
+   std::sort( m_sortedRenderTimes.begin(), m_sortedRenderTimes.end() );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumBlocks
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t RenderStatistics::getNumBlocks() const
+{
+   return m_sortedRenderTimes.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getBlockPeriod
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double RenderStatistics::getBlockPeriod() const
+{
+   return m_blockPeriod;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getRenderTimePercentile
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double RenderStatistics::getRenderTimePercentile( double percentile ) const
+{
+   if ( m_sortedRenderTimes.empty() )
+   {
+      return 0;
+   }
+
+   /// Nearest rank.
+   double rank = ceil( percentile / 100 * m_sortedRenderTimes.size() );
+   size_t index = rank < 1 ? 0 : std::min( static_cast< size_t >( rank ) - 1, m_sortedRenderTimes.size() - 1 );
+   return m_sortedRenderTimes[ index ];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumDeadlineMisses
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t RenderStatistics::getNumDeadlineMisses() const
+{
+   return m_sortedRenderTimes.end() - std::upper_bound( m_sortedRenderTimes.begin(), m_sortedRenderTimes.end(), m_blockPeriod );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumUnderruns
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t RenderStatistics::getNumUnderruns() const
+{
+   return m_numUnderruns;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getLatency
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double RenderStatistics::getLatency() const
+{
+   return m_latency;
+}
+
+} /// namespace Synthesizer
@@ -0,0 +1,228 @@
+#ifndef REALTIMERENDERER_H
+#define REALTIMERENDERER_H
+
+#include "IAudioSink.h"
+#include "IThread.h"
+#include "RealVector.h"
+#include "SpscRingBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace Synthesizer
+{
+
+/**
+ * @class RenderStatistics
+ * @brief Timing statistics of a RealTimeRenderer run.
+ */
+class RenderStatistics
+{
+   public:
+      /**
+       * Constructor.
+       * @param blockPeriod: wall-clock duration of a block in seconds.
+       * @param renderTimes: render time per block in seconds.
+       * @param numUnderruns: number of blocks for which the ring buffer did not hold enough samples.
+       * @param latency: time in seconds between rendering a sample and passing it to the sink (ring buffer size).
+       */
+      RenderStatistics( double blockPeriod, const RealVector& renderTimes, size_t numUnderruns, double latency );
+
+      /**
+       * Get the number of rendered blocks.
+       */
+      size_t getNumBlocks() const;
+      /**
+       * Get the wall-clock duration of a block in seconds, i.e. the deadline for rendering a block.
+       */
+      double getBlockPeriod() const;
+      /**
+       * Get the @param percentile (between 0 and 100) of the render time per block in seconds.
+       */
+      double getRenderTimePercentile( double percentile ) const;
+      /**
+       * Get the number of blocks that took longer to render than the block period.
+       */
+      size_t getNumDeadlineMisses() const;
+      /**
+       * Get the number of blocks for which the sink did not get the samples in time (they were padded with zeros).
+       */
+      size_t getNumUnderruns() const;
+      /**
+       * Get the latency in seconds.
+       */
+      double getLatency() const;
+
+   private:
+      double         m_blockPeriod;          //! Wall-clock duration of a block.
+      RealVector     m_sortedRenderTimes;    //! Render time per block, sorted.
+      size_t         m_numUnderruns;         //! Number of buffer underruns.
+      double         m_latency;              //! Latency.
+};
+
+/**
+ * @class RealTimeRenderer
+ * @brief Renders a source against the wall clock, as a live system would, and measures whether it keeps up.
+ *
+ * A producer thread renders fixed-size blocks from the source into a lock-free ring buffer as long as there is space.
+ * The calling thread drains one block from the ring buffer per block period (at wall-clock rate) and passes it to the
+ * sink. If the ring buffer does not hold a full block at that time, the block is padded with zeros and counted as an
+ * underrun. The ring buffer is filled before the clock starts, so its size sets the latency.
+ *
+ * The Source can be any class with a method render( double* buffer, size_t numSamples ) that renders the next samples,
+ * e.g. an IGenerator or a PolyphonicSynthesizer. The source and the sink should outlive the renderer.
+ */
+template < class Source >
+class RealTimeRenderer
+{
+   public:
+      /**
+       * Constructor.
+       * @param source, sink: source of the samples and their destination.
+       * @param samplingRate: sampling rate that sets the wall-clock rate.
+       * @param blockSize: number of samples per block.
+       * @param numBufferedBlocks: number of blocks in the ring buffer.
+       */
+      RealTimeRenderer( Source& source, IAudioSink& sink, double samplingRate, size_t blockSize = 256, size_t numBufferedBlocks = 4 );
+
+      /**
+       * Render @param numBlocks blocks in real time; this takes about numBlocks block periods.
+       */
+      RenderStatistics run( size_t numBlocks );
+
+   private:
+      class ProducerThread;
+
+      /**
+       * Render @param numBlocks blocks into @param ringBuffer, called from the producer thread.
+       */
+      void produce( SpscRingBuffer& ringBuffer, size_t numBlocks );
+
+   private:
+      typedef std::chrono::steady_clock Clock;
+
+      Source&                 m_source;            //! Source of the samples.
+      IAudioSink&             m_sink;              //! Destination of the samples.
+      size_t                  m_blockSize;         //! Number of samples per block.
+      size_t                  m_numBufferedBlocks; //! Number of blocks in the ring buffer.
+      Clock::duration         m_blockPeriod;       //! Wall-clock duration of a block.
+      RealVector              m_renderTimes;       //! Render time per block.
+      std::atomic< bool >     m_stop;              //! Signals the producer to stop.
+};
+
+/**
+ * @class RealTimeRenderer::ProducerThread
+ * @brief Thread that runs RealTimeRenderer::produce.
+ */
+template < class Source >
+class RealTimeRenderer< Source >::ProducerThread : public IThread
+{
+   public:
+      ProducerThread( RealTimeRenderer< Source >& renderer, SpscRingBuffer& ringBuffer, size_t numBlocks ) :
+         IThread( "RealTimeRenderer::ProducerThread" ),
+         m_renderer( renderer ),
+         m_ringBuffer( ringBuffer ),
+         m_numBlocks( numBlocks )
+      {}
+
+   private:
+      ReturnStatus run()
+      {
+         m_renderer.produce( m_ringBuffer, m_numBlocks );
+         return Finished;
+      }
+
+   private:
+      RealTimeRenderer< Source >&   m_renderer;       //! Renderer that owns the thread.
+      SpscRingBuffer&               m_ringBuffer;     //! Ring buffer to fill.
+      size_t                        m_numBlocks;      //! Number of blocks to render.
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Implementation
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template < class Source >
+RealTimeRenderer< Source >::RealTimeRenderer( Source& source, IAudioSink& sink, double samplingRate, size_t blockSize, size_t numBufferedBlocks ) :
+   m_source( source ),
+   m_sink( sink ),
+   m_blockSize( blockSize ),
+   m_numBufferedBlocks( std::max( numBufferedBlocks, size_t( 1 ) ) ),
+   m_blockPeriod( std::chrono::duration_cast< Clock::duration >( std::chrono::duration< double >( blockSize / samplingRate ) ) ),
+   m_stop( false )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// run
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template < class Source >
+RenderStatistics RealTimeRenderer< Source >::run( size_t numBlocks )
+{
+   SpscRingBuffer ringBuffer( m_numBufferedBlocks * m_blockSize );
+   const size_t numPrefill = std::min( ringBuffer.getCapacity() / m_blockSize, numBlocks ) * m_blockSize;
+   m_renderTimes.assign( numBlocks, 0 );
+   m_stop = false;
+
+   ProducerThread producer( *this, ringBuffer, numBlocks );
+   producer.start();
+   while ( ringBuffer.getNumAvailable() < numPrefill )
+   {
+      std::this_thread::sleep_for( m_blockPeriod / 4 );
+   }
+
+   RealVector block( m_blockSize );
+   size_t numUnderruns = 0;
+   const Clock::time_point start = Clock::now();
+   for ( size_t iBlock = 0; iBlock < numBlocks; ++iBlock )
+   {
+      std::this_thread::sleep_until( start + ( iBlock + 1 ) * m_blockPeriod );
+      const size_t numRead = ringBuffer.read( block.data(), m_blockSize );
+      if ( numRead < m_blockSize )
+      {
+         std::fill( block.begin() + numRead, block.end(), 0.0 );
+         ++numUnderruns;
+      }
+      m_sink.write( block.data(), m_blockSize );
+   }
+
+   m_stop = true;
+   producer.join();
+   m_sink.finish();
+
+   const double blockPeriod = std::chrono::duration< double >( m_blockPeriod ).count();
+   return RenderStatistics( blockPeriod, m_renderTimes, numUnderruns, blockPeriod * ringBuffer.getCapacity() / m_blockSize );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// produce
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template < class Source >
+void RealTimeRenderer< Source >::produce( SpscRingBuffer& ringBuffer, size_t numBlocks )
+{
+   RealVector block( m_blockSize );
+   for ( size_t iBlock = 0; iBlock < numBlocks; ++iBlock )
+   {
+      const Clock::time_point t0 = Clock::now();
+      m_source.render( block.data(), m_blockSize );
+      m_renderTimes[ iBlock ] = std::chrono::duration< double >( Clock::now() - t0 ).count();
+
+      while ( ringBuffer.getNumFree() < m_blockSize )
+      {
+         if ( m_stop )
+         {
+            return;
+         }
+         std::this_thread::sleep_for( m_blockPeriod / 4 );
+      }
+      ringBuffer.write( block.data(), m_blockSize );
+   }
+}
+
+} /// namespace Synthesizer
+
+#endif // REALTIMERENDERER_H
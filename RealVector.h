@@ -4,6 +4,7 @@
 #include <cassert>
 #include <cstddef>
 #include <memory>
+#include <utility>
 #include <vector>
 
 /**
@@ -30,6 +31,31 @@ RealVector operator+( double a, const RealVector& x );
 RealVector operator-( const RealVector& x, double a );
 RealVector operator-( double a, const RealVector& x );
 
+/**
+ * Overloads for temporaries: the result is computed in the storage of the temporary operand, so that a chained
+ * expression like x - gamma * grad allocates only once (for gamma * grad) instead of once per operator.
+ */
+RealVector operator+( RealVector&& x, const RealVector& y );
+RealVector operator+( const RealVector& x, RealVector&& y );
+RealVector operator+( RealVector&& x, RealVector&& y );
+RealVector operator-( RealVector&& x, const RealVector& y );
+RealVector operator-( const RealVector& x, RealVector&& y );
+RealVector operator-( RealVector&& x, RealVector&& y );
+RealVector operator*( RealVector&& x, double lambda );
+RealVector operator*( double lambda, RealVector&& x );
+RealVector operator/( RealVector&& x, double lambda );
+RealVector operator+( RealVector&& x, double a );
+RealVector operator+( double a, RealVector&& x );
+RealVector operator-( RealVector&& x, double a );
+
+/**
+ * In-place operations, these never allocate.
+ */
+RealVector& operator+=( RealVector& x, const RealVector& y );
+RealVector& operator-=( RealVector& x, const RealVector& y );
+/** x += lambda * y */
+void addScaled( RealVector& x, double lambda, const RealVector& y );
+
 /**
  * Modify vector.
  */
@@ -150,6 +176,116 @@ inline RealVector operator-( double a, const RealVector& x )
    return x - a;
 }
 
+inline RealVector& operator+=( RealVector& x, const RealVector& y )
+{
+   assert( x.size() == y.size() );
+   for ( size_t i = 0; i < x.size(); ++i )
+   {
+      x[ i ] += y[ i ];
+   }
+   return x;
+}
+
+inline RealVector& operator-=( RealVector& x, const RealVector& y )
+{
+   assert( x.size() == y.size() );
+   for ( size_t i = 0; i < x.size(); ++i )
+   {
+      x[ i ] -= y[ i ];
+   }
+   return x;
+}
+
+inline void addScaled( RealVector& x, double lambda, const RealVector& y )
+{
+   assert( x.size() == y.size() );
+   for ( size_t i = 0; i < x.size(); ++i )
+   {
+      x[ i ] += lambda * y[ i ];
+   }
+}
+
+inline RealVector operator+( RealVector&& x, const RealVector& y )
+{
+   x += y;
+   return std::move( x );
+}
+
+inline RealVector operator+( const RealVector& x, RealVector&& y )
+{
+   y += x;
+   return std::move( y );
+}
+
+inline RealVector operator+( RealVector&& x, RealVector&& y )
+{
+   x += y;
+   return std::move( x );
+}
+
+inline RealVector operator-( RealVector&& x, const RealVector& y )
+{
+   x -= y;
+   return std::move( x );
+}
+
+inline RealVector operator-( const RealVector& x, RealVector&& y )
+{
+   assert( x.size() == y.size() );
+   for ( size_t i = 0; i < x.size(); ++i )
+   {
+      y[ i ] = x[ i ] - y[ i ];
+   }
+   return std::move( y );
+}
+
+inline RealVector operator-( RealVector&& x, RealVector&& y )
+{
+   x -= y;
+   return std::move( x );
+}
+
+inline RealVector operator*( RealVector&& x, double lambda )
+{
+   x *= lambda;
+   return std::move( x );
+}
+
+inline RealVector operator*( double lambda, RealVector&& x )
+{
+   x *= lambda;
+   return std::move( x );
+}
+
+inline RealVector operator/( RealVector&& x, double lambda )
+{
+   x /= lambda;
+   return std::move( x );
+}
+
+inline RealVector operator+( RealVector&& x, double a )
+{
+   for ( size_t i = 0; i < x.size(); ++i )
+   {
+      x[ i ] += a;
+   }
+   return std::move( x );
+}
+
+inline RealVector operator+( double a, RealVector&& x )
+{
+   return std::move( x ) + a;
+}
+
+inline RealVector operator-( RealVector&& x, double a )
+{
+   for ( size_t i = 0; i < x.size(); ++i )
+   {
+      x[ i ] -= a;
+   }
+   return std::move( x );
+}
+
 inline double sum( const RealVector& x )
 {
    double result = 0;
@@ -10,10 +10,10 @@ namespace Math
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// constructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-RegularAccumArray::RegularAccumArray( size_t nBins, double minX, double maxX ) :
-   m_underflow( -std::numeric_limits<double>::max(), minX ),
-   m_overflow( maxX, std::numeric_limits<double>::max() ),
-   m_missed( -std::numeric_limits<double>::max(), std::numeric_limits<double>::max() ),
+RegularAccumArray::RegularAccumArray( size_t nBins, double minX, double maxX, BinMode binMode ) :
+   m_underflow( -std::numeric_limits<double>::max(), minX, binMode ),
+   m_overflow( maxX, std::numeric_limits<double>::max(), binMode ),
+   m_missed( -std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), binMode ),
    m_binWidth( ( maxX - minX ) / nBins )
 {
    m_bins.reserve( nBins );
@@ -21,7 +21,7 @@ RegularAccumArray::RegularAccumArray( size_t nBins, double minX, double maxX ) :
    double binXright = minX + m_binWidth;
    for ( size_t i = 0; i < nBins; ++i )
    {
-      m_bins.push_back( Bin( binXleft, binXright ) );
+      m_bins.push_back( Bin( binXleft, binXright, binMode ) );
       binXleft = binXright;
       binXright += m_binWidth;
    }
@@ -59,7 +59,7 @@ RealVector RegularAccumArray::getAllBinContents() const
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 double RegularAccumArray::getMissedContent() const
 {
-   return 0;
+   return m_missed.getContents();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -134,6 +134,14 @@ double RegularAccumArray::getBinWidth() const
    return ( getMaxX() - getMinX() ) / getNumBins();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getBinMode
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+IAccumArray::BinMode RegularAccumArray::getBinMode() const
+{
+   return m_missed.getBinMode();
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// getMinX
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -186,7 +194,7 @@ void RegularAccumArray::add( double x, double value )
    {
       m_underflow.add( x, value );
    }
-   else if ( x > m_overflow.getMinX() )
+   else if ( x >= m_overflow.getMinX() )
    {
       m_overflow.add( x, value );
    }
@@ -14,9 +14,10 @@ class RegularAccumArray : public IAccumArray
 {
    public:
       /**
-       * Constructor. Create @param nBins regular bins between @param minX and @param maxX.
+       * Constructor. Create @param nBins regular bins between @param minX and @param maxX. @param binMode determines
+       * whether the bins (including under-, overflow and missed bins) store the entries (@see IAccumArray::BinMode).
        */
-      RegularAccumArray( size_t nBins, double minX, double maxX );
+      RegularAccumArray( size_t nBins, double minX, double maxX, BinMode binMode = StoreEntries );
       /**
        * Destructor.
        */
@@ -66,6 +67,7 @@ class RegularAccumArray : public IAccumArray
 
    public:
       double getBinWidth() const;
+      BinMode getBinMode() const;
 
    public:
       std::vector< Bin >      m_bins;
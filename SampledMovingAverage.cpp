@@ -1,5 +1,8 @@
 #include "SampledMovingAverage.h"
 
+#include "FftConvolution.h"
+
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
@@ -10,51 +13,280 @@ namespace Math
 /// constructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 SampledMovingAverage::SampledMovingAverage( size_t nSamples ) :
-   m_weights( nSamples, 1. / nSamples )
+   m_weights( nSamples, 1. / nSamples ),
+   m_backend( Automatic ),
+   m_fftCrossover( 101 )
 {
    assert( ( nSamples % 2 ) == 1 );
+   initialise();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// constructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-SampledMovingAverage::SampledMovingAverage( const RealVector& weights ) :
-   m_weights( weights )
+SampledMovingAverage::SampledMovingAverage( const RealVector& weights, Backend backend ) :
+   m_weights( weights ),
+   m_backend( backend ),
+   m_fftCrossover( 101 )
 {
    normaliseWeights();
    assert( ( m_weights.size() % 2 ) == 1 );
+   assert( backend != RunningSum || isBoxFilter() );
+   initialise();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// destructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+SampledMovingAverage::~SampledMovingAverage()
+{}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// calculate
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 RealVector SampledMovingAverage::calculate( const RealVector& dataSet ) const
 {
-   RealVector result( dataSet.size() );
+   RealVector result;
+   calculate( dataSet, result );
+   return result;
+}
 
-   int nSamplesOneSide = ( m_weights.size() - 1 ) / 2;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calculate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SampledMovingAverage::calculate( const RealVector& dataSet, RealVector& result ) const
+{
+   const size_t nData = dataSet.size();
+   const Backend backend = getBackend();
 
-   for ( size_t iSample = 0; iSample < dataSet.size(); ++iSample )
+   if ( backend == Fft )
+   {
+      calculateFft( dataSet, result );
+      return;
+   }
+   if ( backend == RecursiveGaussian )
+   {
+      if ( &result != &dataSet )
+      {
+         result.assign( dataSet.begin(), dataSet.end() );
+      }
+      calculateRecursiveGaussian( result );
+      return;
+   }
+
+   /// The direct backends read neighbours of every sample, so in-place calculation works on a copy of the data set.
+   const double* data = dataSet.data();
+   if ( &result == &dataSet )
+   {
+      m_workspace.assign( dataSet.begin(), dataSet.end() );
+      data = m_workspace.data();
+   }
+   result.resize( nData );
+
+   if ( backend == RunningSum )
+   {
+      calculateRunningSum( data, nData, result.data() );
+   }
+   else
+   {
+      calculateDirect( data, nData, result.data() );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getBackend
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+SampledMovingAverage::Backend SampledMovingAverage::getBackend() const
+{
+   if ( m_backend != Automatic )
+   {
+      return m_backend;
+   }
+   if ( isBoxFilter() )
+   {
+      return RunningSum;
+   }
+   if ( m_weights.size() > m_fftCrossover )
+   {
+      return Fft;
+   }
+   return Direct;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// setFftCrossover
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SampledMovingAverage::setFftCrossover( size_t fftCrossover )
+{
+   m_fftCrossover = fftCrossover;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calculateDirect
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SampledMovingAverage::calculateDirect( const double* data, size_t nData, double* result ) const
+{
+   const int nSamplesOneSide = ( m_weights.size() - 1 ) / 2;
+   const int nDataInt = static_cast< int >( nData );
+   const double* weights = m_weights.data();
+
+   for ( int iSample = 0; iSample < nDataInt; ++iSample )
    {
-      double sumWeights = 0;
       double avg = 0;
+
+      /// Away from the edges all weights overlap with the data; no bounds checks and a constant sum of weights.
+      if ( iSample >= nSamplesOneSide - 1 && iSample + nSamplesOneSide < nDataInt )
+      {
+         const double* sample = data + iSample + nSamplesOneSide;
+         for ( int iWeight = 0; iWeight < 2 * nSamplesOneSide; ++iWeight )
+         {
+            avg += sample[ -iWeight ] * weights[ iWeight ];
+         }
+         result[ iSample ] = avg / m_sumWeights;
+         continue;
+      }
+
+      double sumWeights = 0;
       for ( int iMovAvg = -nSamplesOneSide; iMovAvg < nSamplesOneSide; ++iMovAvg )
       {
          int weightIndex = iMovAvg + nSamplesOneSide;
          int sampleIndex = iSample - iMovAvg;
-         if ( sampleIndex >= 0 && sampleIndex < static_cast< int >( dataSet.size() ) )
+         if ( sampleIndex >= 0 && sampleIndex < nDataInt )
          {
-            sumWeights += m_weights[ weightIndex ];
-            avg += dataSet[ sampleIndex ] * m_weights[ weightIndex ];
+            sumWeights += weights[ weightIndex ];
+            avg += data[ sampleIndex ] * weights[ weightIndex ];
          }
       }
       assert( sumWeights > 0 );
-      avg /= sumWeights;
+      result[ iSample ] = avg / sumWeights;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calculateRunningSum
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SampledMovingAverage::calculateRunningSum( const double* data, size_t nData, double* result ) const
+{
+   /// Sample iSample averages the data in [ iSample - nSamplesOneSide + 1, iSample + nSamplesOneSide ] (the last weight
+   /// is not used); the window [ iLow, iHigh ) moves one sample per step.
+   const size_t nSamplesOneSide = ( m_weights.size() - 1 ) / 2;
+   double sum = 0;
+   size_t iLow = 0;
+   size_t iHigh = 0;
+   for ( size_t iSample = 0; iSample < nData; ++iSample )
+   {
+      const size_t iHighNew = std::min( iSample + nSamplesOneSide + 1, nData );
+      for ( ; iHigh < iHighNew; ++iHigh )
+      {
+         sum += data[ iHigh ];
+      }
+      const size_t iLowNew = iSample + 1 > nSamplesOneSide ? iSample + 1 - nSamplesOneSide : 0;
+      for ( ; iLow < iLowNew; ++iLow )
+      {
+         sum -= data[ iLow ];
+      }
+      result[ iSample ] = sum / ( iHigh - iLow );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calculateFft
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SampledMovingAverage::calculateFft( const RealVector& dataSet, RealVector& result ) const
+{
+   const size_t nData = dataSet.size();
+   const size_t nWeights = m_weights.size();
+
+   /// The convolution is recreated only if the data set does not fit into its Fourier size.
+   if ( !m_fftConvolution || nData + nWeights - 1 > m_fftConvolution->getFourierSize() )
+   {
+      RealVector weights( m_weights );
+      weights.back() = 0;
+      const size_t fourierSize = FftConvolution::calcFourierSize( nData + nWeights - 1 );
+      m_fftConvolution.reset( new FftConvolution( weights, fourierSize - nWeights + 1 ) );
+   }
+   m_fftConvolution->calculate( dataSet, result );
+
+   /// Renormalise with the sum of weights that overlap with the data.
+   const size_t nSamplesOneSide = ( nWeights - 1 ) / 2;
+   for ( size_t iSample = 0; iSample < nData; ++iSample )
+   {
+      const size_t iShifted = iSample + nSamplesOneSide;
+      const size_t iWeightMin = iShifted + 1 > nData ? iShifted + 1 - nData : 0;
+      const size_t iWeightMax = std::min( iShifted + 1, nWeights );
+      const double sumWeights = m_cumulWeights[ iWeightMax ] - m_cumulWeights[ iWeightMin ];
+      assert( sumWeights > 0 );
+      result[ iSample ] /= sumWeights;
+   }
+}
 
-      result[ iSample ] = avg;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calculateRecursiveGaussian
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SampledMovingAverage::calculateRecursiveGaussian( RealVector& data ) const
+{
+   /// The filter response to ones over the data range renormalises the edges; it only depends on the data size.
+   if ( m_recursiveNorm.size() != data.size() )
+   {
+      m_recursiveNorm.assign( data.size(), 1 );
+      applyRecursiveGaussian( m_recursiveNorm.data(), m_recursiveNorm.size() );
    }
 
-   return result;
+   applyRecursiveGaussian( data.data(), data.size() );
+   for ( size_t i = 0; i < data.size(); ++i )
+   {
+      data[ i ] /= m_recursiveNorm[ i ];
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// applyRecursiveGaussian
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SampledMovingAverage::applyRecursiveGaussian( double* data, size_t nData ) const
+{
+   const double b = m_recursiveCoeffs[ 0 ];
+   const double b1 = m_recursiveCoeffs[ 1 ];
+   const double b2 = m_recursiveCoeffs[ 2 ];
+   const double b3 = m_recursiveCoeffs[ 3 ];
+
+   /// Causal pass; the filter state before the first sample is zero (zero padding).
+   double w1 = 0, w2 = 0, w3 = 0;
+   for ( size_t i = 0; i < nData; ++i )
+   {
+      const double w = b * data[ i ] + b1 * w1 + b2 * w2 + b3 * w3;
+      data[ i ] = w;
+      w3 = w2;
+      w2 = w1;
+      w1 = w;
+   }
+
+   /// The causal response continues into the zero padding after the data; it is needed by the anti-causal pass.
+   for ( size_t i = 0; i < m_recursiveTail.size(); ++i )
+   {
+      const double w = b1 * w1 + b2 * w2 + b3 * w3;
+      m_recursiveTail[ i ] = w;
+      w3 = w2;
+      w2 = w1;
+      w1 = w;
+   }
+
+   /// Anti-causal pass, starting at the end of the padding.
+   w1 = w2 = w3 = 0;
+   for ( size_t i = m_recursiveTail.size(); i-- > 0; )
+   {
+      const double w = b * m_recursiveTail[ i ] + b1 * w1 + b2 * w2 + b3 * w3;
+      w3 = w2;
+      w2 = w1;
+      w1 = w;
+   }
+   for ( size_t i = nData; i-- > 0; )
+   {
+      const double w = b * data[ i ] + b1 * w1 + b2 * w2 + b3 * w3;
+      data[ i ] = w;
+      w3 = w2;
+      w2 = w1;
+      w1 = w;
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -82,6 +314,76 @@ void SampledMovingAverage::normaliseWeights()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// initialise
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SampledMovingAverage::initialise()
+{
+   /// The last weight is never used.
+   const size_t nUsed = m_weights.size() - 1;
+   m_cumulWeights.assign( m_weights.size() + 1, 0 );
+   for ( size_t i = 0; i < nUsed; ++i )
+   {
+      m_cumulWeights[ i + 1 ] = m_cumulWeights[ i ] + m_weights[ i ];
+   }
+   m_cumulWeights.back() = m_cumulWeights[ nUsed ];
+   m_sumWeights = m_cumulWeights.back();
+
+   /// Width of the weights around the centre sample.
+   const double centre = nUsed / 2;
+   double variance = 0;
+   for ( size_t i = 0; i < nUsed; ++i )
+   {
+      variance += m_weights[ i ] * ( i - centre ) * ( i - centre );
+   }
+   const double sigma = m_sumWeights > 0 ? sqrt( variance / m_sumWeights ) : 0;
+
+   /// Below sigma = 0.5, q becomes negative and the recursion can be unstable; such narrow filters are cheap directly.
+   if ( sigma < 0.5 )
+   {
+      if ( m_backend == RecursiveGaussian )
+      {
+         m_backend = Direct;
+      }
+      return;
+   }
+
+   /// Recursive Gaussian coefficients of Young and van Vliet (Signal Processing 44, 1995), valid for sigma >= 0.5.
+   const double q = sigma >= 2.5 ? 0.98711 * sigma - 0.96330 : 3.97156 - 4.14554 * sqrt( std::max( 1 - 0.26891 * sigma, 0.0 ) );
+   const double b0 = 1.57825 + 2.44413 * q + 1.4281 * q * q + 0.422205 * q * q * q;
+   const double b1 = 2.44413 * q + 2.85619 * q * q + 1.26661 * q * q * q;
+   const double b2 = -1.4281 * q * q - 1.26661 * q * q * q;
+   const double b3 = 0.422205 * q * q * q;
+   m_recursiveCoeffs.resize( 4 );
+   m_recursiveCoeffs[ 0 ] = 1 - ( b1 + b2 + b3 ) / b0;
+   m_recursiveCoeffs[ 1 ] = b1 / b0;
+   m_recursiveCoeffs[ 2 ] = b2 / b0;
+   m_recursiveCoeffs[ 3 ] = b3 / b0;
+
+   /// The response has decayed to a negligible level after ten widths.
+   m_recursiveTail.resize( static_cast< size_t >( 10 * sigma ) + 3 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// isBoxFilter
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SampledMovingAverage::isBoxFilter() const
+{
+   const size_t nUsed = m_weights.size() - 1;
+   if ( nUsed == 0 )
+   {
+      return false;
+   }
+   for ( size_t i = 1; i < nUsed; ++i )
+   {
+      if ( fabs( m_weights[ i ] - m_weights[ 0 ] ) > 1e-12 * fabs( m_weights[ 0 ] ) )
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// createGaussianWeights
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -3,15 +3,49 @@
 
 #include "RealVector.h"
 
+#include <memory>
+
 namespace Math
 {
 
+/// Forward declares
+class FftConvolution;
+
 /**
  * @class SampledMovingAverage
  * @brief Helper class to calculate moving averages for data set that are equidistant (sampled)
+ *
+ * The moving average can be calculated with several backends. Direct, RunningSum and Fft are exact and give the same
+ * result up to rounding:
+ * - Direct: direct convolution, O( N x K ) for N samples and K weights.
+ * - RunningSum: for equal weights (box filter) only, O( N ) independent of K.
+ * - Fft: FFT convolution (@see FftConvolution), O( N log N ); faster than Direct for wide filters.
+ * RecursiveGaussian is an approximation:
+ * - RecursiveGaussian: third order recursive (IIR) approximation of a Gaussian filter with the width of the weights,
+ *   O( N ) independent of K. The result deviates by the order of 1e-2 of the data amplitude, so this backend is only
+ *   used when requested explicitly. It needs a width (standard deviation of the weights) of at least 0.5 samples;
+ *   for narrower weights Direct is used instead.
+ * The Automatic backend chooses RunningSum for box filters, Fft for filters with more weights than the FFT crossover and
+ * Direct otherwise. At the edges of the data set, the average is renormalised with the weights that overlap with the data.
+ *
+ * The backends use internal working buffers, so that calculate does not allocate once the buffers have the size of the
+ * data set. Therefore, an instance cannot be shared among threads.
  */
 class SampledMovingAverage
 {
+   public:
+      /**
+       * Backend for the calculation of the moving average.
+       */
+      enum Backend
+      {
+         Automatic,
+         Direct,
+         RunningSum,
+         Fft,
+         RecursiveGaussian
+      };
+
    public:
       /**
        * Instantiate a moving average calculator. @param nSamples is the total number of samples that are used in the
@@ -20,19 +54,44 @@ class SampledMovingAverage
       SampledMovingAverage( size_t nSamples );
       /**
        * Instantiate a moving average calculator with given weights. @see comment at constructor above. Also here the number of samples should be odd.
+       * The calculation is done with @param backend.
+       */
+      SampledMovingAverage( const RealVector& weights, Backend backend = Automatic );
+      /**
+       * Destructor.
        */
-      SampledMovingAverage( const RealVector& weights );
+      ~SampledMovingAverage();
 
       /**
        * Calculate moving average for @param dataSet
        */
       RealVector calculate( const RealVector& dataSet ) const;
+      /**
+       * Calculate moving average for @param dataSet and write it into @param result. @param result is resized to the size
+       * of @param dataSet and may be the same object as @param dataSet.
+       */
+      void calculate( const RealVector& dataSet, RealVector& result ) const;
+
+      /**
+       * Get the backend that is used for the calculation (Automatic is resolved, and RecursiveGaussian is replaced by
+       * Direct for weights narrower than 0.5 samples).
+       */
+      Backend getBackend() const;
+      /**
+       * Set the number of weights above which the Automatic backend uses FFT convolution.
+       */
+      void setFftCrossover( size_t fftCrossover );
 
       /**
        * Helper function that creates Gaussian weights. @param nSamples should be odd and the centre of the Gaussian is located at the middle sample.
        */
       static RealVector createGaussianFilter( size_t nSamples, double sigma );
 
+   private:
+      /// Blocked copy-constructor and assignment.
+      SampledMovingAverage( const SampledMovingAverage& other );
+      SampledMovingAverage& operator=( const SampledMovingAverage& other );
+
    private:
       /**
        * Helper method to retreive weights
@@ -42,9 +101,44 @@ class SampledMovingAverage
        * Normalise weights to unity
        */
       void normaliseWeights();
+      /**
+       * Precalculate the weight sums and the recursive Gaussian coefficients.
+       */
+      void initialise();
+      /**
+       * Check whether all weights that are used are equal.
+       */
+      bool isBoxFilter() const;
+
+      /**
+       * Backend implementations. @param data and @param result have @param nData samples and do not overlap.
+       */
+      void calculateDirect( const double* data, size_t nData, double* result ) const;
+      void calculateRunningSum( const double* data, size_t nData, double* result ) const;
+      /**
+       * FFT backend; @param result may be the same object as @param dataSet.
+       */
+      void calculateFft( const RealVector& dataSet, RealVector& result ) const;
+      /**
+       * Recursive Gaussian backend, in place on @param data.
+       */
+      void calculateRecursiveGaussian( RealVector& data ) const;
+      /**
+       * Apply the recursive Gaussian forward and backward over @param data (in place) with zero initial conditions.
+       */
+      void applyRecursiveGaussian( double* data, size_t nData ) const;
 
    private:
-      RealVector     m_weights;
+      RealVector                          m_weights;           //! The weights; the last one is not used.
+      Backend                             m_backend;           //! The requested backend, Direct if RecursiveGaussian is too narrow.
+      size_t                              m_fftCrossover;      //! Number of weights above which Automatic uses Fft.
+      double                              m_sumWeights;        //! Sum of the used weights.
+      RealVector                          m_cumulWeights;      //! Cumulative sum of the used weights, for edge normalisation.
+      RealVector                          m_recursiveCoeffs;   //! B, b1/b0, b2/b0, b3/b0 of the recursive Gaussian.
+      mutable RealVector                  m_workspace;         //! Copy of the data set for in-place calculation.
+      mutable RealVector                  m_recursiveNorm;     //! Recursive Gaussian applied to ones, for edge normalisation.
+      mutable RealVector                  m_recursiveTail;     //! Causal response in the zero padding after the data.
+      mutable std::unique_ptr< FftConvolution > m_fftConvolution;  //! FFT convolution for the current data size.
 };
 
 } /// namespace Math
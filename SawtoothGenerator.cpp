@@ -2,6 +2,22 @@
 
 #include <math.h>
 
+/// Anonymous namespace
+namespace
+{
+
+Synthesizer::BandLimitedWavetable createWavetable()
+{
+   RealVector amplitudes( Synthesizer::WavetableSynthesizer::getMaxNumHarmonics() );
+   for ( size_t iHarmonic = 1; iHarmonic <= amplitudes.size(); ++iHarmonic )
+   {
+      amplitudes[ iHarmonic - 1 ] = 2 / M_PI / iHarmonic * ( ( iHarmonic % 2 == 0 ) ? -1 : 1 );
+   }
+   return Synthesizer::BandLimitedWavetable( amplitudes );
+}
+
+}
+
 namespace Synthesizer
 {
 
@@ -9,26 +25,16 @@ namespace Synthesizer
 /// constructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 SawtoothGenerator::SawtoothGenerator( const SamplingInfo& samplingInfo ) :
-   AdditiveSynthesizer( samplingInfo )
+   WavetableSynthesizer( samplingInfo, getWavetable() )
 {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// getHarmonicsInfo
+/// getWavetable
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-std::vector< AdditiveSynthesizer::HarmonicInfo > SawtoothGenerator::getHarmonicsInfo() const
+const BandLimitedWavetable& SawtoothGenerator::getWavetable()
 {
-   size_t iMaxHarmonic = getSamplingInfo().getNyquistFrequency() / getFrequency();
-
-   std::vector< HarmonicInfo > result;
-   for ( size_t iHarmonic = 1; iHarmonic < iMaxHarmonic; ++iHarmonic )
-   {
-      double phaseStep = getSamplingInfo().getPhaseStepPerSample( getFrequency() * iHarmonic );
-      double phase = getPhase() * iHarmonic;
-      double amplitude = 2 / M_PI / iHarmonic * ( ( iHarmonic % 2 == 0 ) ? -1 : 1 );
-      result.push_back( HarmonicInfo( phaseStep, phase, amplitude ) );
-   }
-
-   return result;
+   static const BandLimitedWavetable wavetable( createWavetable() );
+   return wavetable;
 }
 
-} /// namespace WaveAnalysis
+} /// namespace Synthesizer
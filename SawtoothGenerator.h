@@ -1,13 +1,16 @@
 #ifndef SAWTOOTHGENERATOR_H
 #define SAWTOOTHGENERATOR_H
 
-#include "AdditiveSynthesizer.h"
+#include "WavetableSynthesizer.h"
 
 namespace Synthesizer
 {
 
-/// TODO: doc
-class SawtoothGenerator : public AdditiveSynthesizer
+/**
+ * @class SawtoothGenerator
+ * @brief Class that generates sawtooth waves
+ */
+class SawtoothGenerator : public WavetableSynthesizer
 {
    public:
       /**
@@ -15,11 +18,10 @@ class SawtoothGenerator : public AdditiveSynthesizer
        */
       SawtoothGenerator( const SamplingInfo& samplingInfo );
 
-   private:
       /**
-       * getHarmonicsInfo (@see AdditiveSynthesizer).
+       * Get the band-limited wavetable shared by all sawtooth generators. It is built at the first construction.
        */
-      std::vector< HarmonicInfo > getHarmonicsInfo() const;
+      static const BandLimitedWavetable& getWavetable();
 };
 
 } /// namespace Synthesizer
@@ -12,25 +12,21 @@ SineGenerator::SineGenerator( const SamplingInfo& samplingInfo ) :
 {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// generate
+/// render
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-RawPcmData::Ptr SineGenerator::generate( size_t length )
+void SineGenerator::render( double* buffer, size_t numSamples )
 {
-   RawPcmData* data = new RawPcmData( getSamplingInfo(), length );
-
    double phaseStep = getSamplingInfo().getPhaseStepPerSample( getFrequency() );
    double phase = getPhase();
 
-   for ( size_t iSample = 0; iSample < length; ++iSample )
+   for ( size_t iSample = 0; iSample < numSamples; ++iSample )
    {
       phase += phaseStep;
-      double val = sin( phase ) * getCurrentSampleAmplitude();
-      (*data)[iSample] = val;
-      nextSample();
+      buffer[iSample] = sin( phase );
    }
+   applyEnvelope( buffer, numSamples );
 
    setPhase( phase );
-   return RawPcmData::Ptr( data );
 }
 
 } /// namespace Synthesizer
@@ -17,9 +17,9 @@ class SineGenerator : public IGenerator
        */
       SineGenerator( const SamplingInfo& samplingInfo );
       /**
-       * generate (@see IGenerator)
+       * render (@see IGenerator)
        */
-      RawPcmData::Ptr generate( size_t length );
+      void render( double* buffer, size_t numSamples );
 };
 
 } /// namespace Synthesizer
@@ -0,0 +1,78 @@
+#include "SpscRingBuffer.h"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+SpscRingBuffer::SpscRingBuffer( size_t minCapacity ) :
+   m_writeIndex( 0 ),
+   m_readIndex( 0 )
+{
+   size_t capacity = 1;
+   while ( capacity < minCapacity )
+   {
+      capacity *= 2;
+   }
+   m_data.resize( capacity );
+   m_mask = capacity - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getCapacity
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t SpscRingBuffer::getCapacity() const
+{
+   return m_data.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumAvailable
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t SpscRingBuffer::getNumAvailable() const
+{
+   return m_writeIndex.load( std::memory_order_acquire ) - m_readIndex.load( std::memory_order_relaxed );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumFree
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t SpscRingBuffer::getNumFree() const
+{
+   return getCapacity() - ( m_writeIndex.load( std::memory_order_relaxed ) - m_readIndex.load( std::memory_order_acquire ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// write
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t SpscRingBuffer::write( const double* data, size_t numSamples )
+{
+   const size_t writeIndex = m_writeIndex.load( std::memory_order_relaxed );
+   const size_t numWritten = std::min( numSamples, getNumFree() );
+
+   /// Copy in at most two contiguous parts (before and after the wrap-around).
+   const size_t begin = writeIndex & m_mask;
+   const size_t numFirst = std::min( numWritten, getCapacity() - begin );
+   std::copy( data, data + numFirst, m_data.begin() + begin );
+   std::copy( data + numFirst, data + numWritten, m_data.begin() );
+
+   m_writeIndex.store( writeIndex + numWritten, std::memory_order_release );
+   return numWritten;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// read
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t SpscRingBuffer::read( double* data, size_t numSamples )
+{
+   const size_t readIndex = m_readIndex.load( std::memory_order_relaxed );
+   const size_t numRead = std::min( numSamples, getNumAvailable() );
+
+   const size_t begin = readIndex & m_mask;
+   const size_t numFirst = std::min( numRead, getCapacity() - begin );
+   std::copy( m_data.begin() + begin, m_data.begin() + begin + numFirst, data );
+   std::copy( m_data.begin(), m_data.begin() + ( numRead - numFirst ), data + numFirst );
+
+   m_readIndex.store( readIndex + numRead, std::memory_order_release );
+   return numRead;
+}
@@ -0,0 +1,61 @@
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include "RealVector.h"
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class SpscRingBuffer
+ * @brief Lock-free ring buffer of samples for a single producer thread and a single consumer thread.
+ *
+ * The producer only modifies the write index and the consumer only the read index; both indices increase
+ * monotonically and are wrapped with a bit mask, since the capacity is a power of two. The samples are published with
+ * release/acquire ordering on the indices, so no locks are needed and neither side ever blocks.
+ */
+class SpscRingBuffer
+{
+   public:
+      /**
+       * Create a ring buffer that holds at least @param minCapacity samples (rounded up to a power of two).
+       */
+      SpscRingBuffer( size_t minCapacity );
+
+      /**
+       * Get the maximum number of samples in the buffer.
+       */
+      size_t getCapacity() const;
+      /**
+       * Get the number of samples that can be read (consumer side).
+       */
+      size_t getNumAvailable() const;
+      /**
+       * Get the number of samples that can be written (producer side).
+       */
+      size_t getNumFree() const;
+
+      /**
+       * Write at most @param numSamples samples from @param data (producer side). Returns the number of samples written.
+       */
+      size_t write( const double* data, size_t numSamples );
+      /**
+       * Read at most @param numSamples samples into @param data (consumer side). Returns the number of samples read.
+       */
+      size_t read( double* data, size_t numSamples );
+
+   private:
+      RealVector              m_data;        //! Sample storage.
+      size_t                  m_mask;        //! Capacity - 1.
+      std::atomic< size_t >   m_writeIndex;  //! Total number of samples written.
+      std::atomic< size_t >   m_readIndex;   //! Total number of samples read.
+
+   /**
+    * Blocked copy-constructor and assignment
+    */
+   private:
+      SpscRingBuffer( const SpscRingBuffer& other );
+      SpscRingBuffer& operator=( const SpscRingBuffer& other );
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -2,34 +2,38 @@
 
 #include <math.h>
 
+/// Anonymous namespace
+namespace
+{
+
+Synthesizer::BandLimitedWavetable createWavetable()
+{
+   RealVector amplitudes( Synthesizer::WavetableSynthesizer::getMaxNumHarmonics(), 0 );
+   for ( size_t iHarmonic = 1; iHarmonic <= amplitudes.size(); iHarmonic += 2 )
+   {
+      amplitudes[ iHarmonic - 1 ] = 4 / M_PI / iHarmonic;
+   }
+   return Synthesizer::BandLimitedWavetable( amplitudes );
+}
+
+}
+
 namespace Synthesizer {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// constructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 SquareGenerator::SquareGenerator( const SamplingInfo& samplingInfo ) :
-   AdditiveSynthesizer( samplingInfo )
+   WavetableSynthesizer( samplingInfo, getWavetable() )
 {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// getHarmonicsInfo
+/// getWavetable
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-std::vector< AdditiveSynthesizer::HarmonicInfo > SquareGenerator::getHarmonicsInfo() const
+const BandLimitedWavetable& SquareGenerator::getWavetable()
 {
-   size_t nHarmonics = getSamplingInfo().getNyquistFrequency() / getFrequency();
-
-   std::vector< HarmonicInfo > result;
-
-   for ( size_t iHarmonic = 1; iHarmonic < nHarmonics; iHarmonic += 2 )
-   {
-      double relAmp = 4 / M_PI / iHarmonic;
-      double phase = fmod( getPhase() * iHarmonic, 2 * M_PI );
-      double phaseStep = getSamplingInfo().getPhaseStepPerSample( getFrequency() * iHarmonic );
-
-      result.push_back( HarmonicInfo( phaseStep, phase, relAmp ) );
-   }
-
-   return result;
+   static const BandLimitedWavetable wavetable( createWavetable() );
+   return wavetable;
 }
 
 } /// namespace Synthesizer
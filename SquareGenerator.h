@@ -1,7 +1,7 @@
 #ifndef SQUAREGENERATOR_H
 #define SQUAREGENERATOR_H
 
-#include "AdditiveSynthesizer.h"
+#include "WavetableSynthesizer.h"
 
 namespace Synthesizer {
 
@@ -9,7 +9,7 @@ namespace Synthesizer {
  * @class SquareGenerator
  * @brief Class that generates a square wave
  */
-class SquareGenerator : public AdditiveSynthesizer
+class SquareGenerator : public WavetableSynthesizer
 {
    public:
       /**
@@ -17,11 +17,10 @@ class SquareGenerator : public AdditiveSynthesizer
        */
       SquareGenerator( const SamplingInfo& samplingInfo );
 
-   private:
       /**
-       * getHarmonicsInfo (@see AdditiveSynthesizer).
+       * Get the band-limited wavetable shared by all square generators. It is built at the first construction.
        */
-      std::vector< HarmonicInfo > getHarmonicsInfo() const;
+      static const BandLimitedWavetable& getWavetable();
 };
 
 } /// namespace Synthesizer
@@ -222,13 +222,14 @@ std::vector< Feature::SrSpecPeak > SrSpecPeakAlgorithm::execute( const WaveAnaly
 
    Math::LinearInterpolator baseline( baselineX, baselineY );
 
-   /// Record the points above baseline.
+   /// Record the points above baseline. The preselected frequencies are sorted, so evalMany walks the baseline once.
+   const RealVector& preselectedBaseline = baseline.evalMany( preselectedFrequencies );
    RealVector magAboveBaseline;
    RealVector freqAboveBaseline;
 
    for ( size_t i = 0; i < preselectedFrequencies.size(); ++i )
    {
-      if ( preselectedMagnitudes[ i ] > baseline( preselectedFrequencies[ i ] ) )
+      if ( preselectedMagnitudes[ i ] > preselectedBaseline[ i ] )
       {
          magAboveBaseline.push_back( preselectedMagnitudes[ i ] );
          freqAboveBaseline.push_back( preselectedFrequencies[ i ] );
@@ -77,14 +77,14 @@ const RealVector& SrSpectrum::getTimeCorrections() const
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// rebinToFourierLattice
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-Math::RegularAccumArray SrSpectrum::rebinToFourierLattice() const
+Math::RegularAccumArray SrSpectrum::rebinToFourierLattice( Math::IAccumArray::BinMode binMode ) const
 {
    size_t nBins = getFrequencies().size();
    double freqBinWidth = FourierSpectrum::getFrequencies()[1] - FourierSpectrum::getFrequencies()[0];
    double minX = FourierSpectrum::getFrequencies()[0] - 0.5 * freqBinWidth;
    double maxX = FourierSpectrum::getFrequencies()[ nBins - 1 ] - 0.5 * freqBinWidth;
 
-   Math::RegularAccumArray result( nBins, minX, maxX );
+   Math::RegularAccumArray result( nBins, minX, maxX, binMode );
 
    for ( size_t i = 0; i < nBins; ++i )
    {
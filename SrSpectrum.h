@@ -52,9 +52,10 @@ class SrSpectrum : public FourierSpectrum
 
    public:
       /**
-       * Rebin the corrected (frequency, magnitude) to the original Fourier bins.
+       * Rebin the corrected (frequency, magnitude) to the original Fourier bins. Use @param binMode ContentsOnly if the
+       * individual entries are not needed.
        */
-      Math::RegularAccumArray rebinToFourierLattice() const;
+      Math::RegularAccumArray rebinToFourierLattice( Math::IAccumArray::BinMode binMode = Math::IAccumArray::StoreEntries ) const;
 
    private:
       RealVector        m_correctedFrequencies;          //! Corrected frequencies.
@@ -3,6 +3,7 @@
 #include "Logger.h"
 #include "MultiLayerPerceptron.h"
 #include "Utils.h"
+#include "WorkerPool.h"
 
 namespace Mva
 {
@@ -15,7 +16,14 @@ StochasticGradDescMlpTrainer::StochasticGradDescMlpTrainer( MultiLayerPerceptron
    m_eta( 0.01 ),
    m_batchSize( 25 ),
    m_numIterationsPerEpoch( 10 ),
-   m_rng( 64293 )
+   m_rng( 64293 ),
+   m_numThreads( 1 )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// destructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+StochasticGradDescMlpTrainer::~StochasticGradDescMlpTrainer()
 {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -35,6 +43,14 @@ void StochasticGradDescMlpTrainer::setBatchSize( size_t batchSize, size_t numIte
    m_numIterationsPerEpoch = numIterationsPerEpoch;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// setNumThreads
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void StochasticGradDescMlpTrainer::setNumThreads( size_t numThreads )
+{
+   m_numThreads = std::max( numThreads, size_t( 1 ) );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// makeBatch
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -92,13 +108,15 @@ std::vector< size_t > StochasticGradDescMlpTrainer::makeBatch()
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 double StochasticGradDescMlpTrainer::calculateErrorsFullSet()
 {
-   double totalError = 0;
+   if ( m_fullSet.size() != m_trainDataInput->size() )
+   {
+      m_fullSet = Utils::createRange( 0, m_trainDataInput->size() );
+   }
 
-   for ( size_t iSample = 0; iSample < m_trainDataInput->size(); ++iSample )
+   double totalError = calcBatch( m_fullSet, false );
+   for ( size_t iSample = 0; iSample < m_fullSet.size(); ++iSample )
    {
-      double sampleError = m_mlp.calcError( (*m_trainDataInput)[ iSample ], (*m_trainDataOutput)[ iSample ] );
-      updateSampleError( iSample, sampleError );
-      totalError += sampleError;
+      updateSampleError( iSample, m_batchErrors[ iSample ] );
    }
    return totalError / m_trainDataInput->size();
 }
@@ -120,28 +138,41 @@ void StochasticGradDescMlpTrainer::train()
       m_sampleErrors.resize( m_trainDataInput->size() );
    }
 
+   /// Every thread after the first propagates its shard through its own copy of the MLP.
+   if ( !m_workerPool || m_workerPool->getNumThreads() != m_numThreads )
+   {
+      m_workerPool.reset( new WorkerPool( m_numThreads ) );
+   }
+   m_shardMlps.assign( m_numThreads - 1, m_mlp );
+   m_shardIndices.resize( m_numThreads );
+   m_shardErrors.resize( m_numThreads );
+   m_shardGradients.resize( m_numThreads );
+
    calculateErrorsFullSet();
 
    for ( size_t iIter = 0; iIter < m_numIterations; ++iIter )
    {
       for ( size_t iSubIter = 0; iSubIter < m_numIterationsPerEpoch; ++iSubIter )
       {
-         RealVector gradient( weights.size(), 0 );
          std::vector< size_t >&& batch = makeBatch();
 
+         /// The gradient summed over the batch, propagated through the network as a whole.
+         calcBatch( batch, true );
          for ( size_t iSample = 0; iSample < batch.size(); ++iSample )
          {
-            size_t sampleIndex = batch[ iSample ];
-            double sampleError;
-            RealVector sampleGradient = m_mlp.calcErrorAndGradient( (*m_trainDataInput)[ sampleIndex ], (*m_trainDataOutput)[ sampleIndex ], sampleError );
-            gradient = gradient + sampleGradient;
-            updateSampleError( sampleIndex, sampleError );
+            updateSampleError( batch[ iSample ], m_batchErrors[ iSample ] );
          }
 
-         gradient = gradient * ( 1.0 / batch.size() );
-
-         weights = weights - gradient * m_eta;
+         const double step = m_eta / batch.size();
+         for ( size_t i = 0; i < weights.size(); ++i )
+         {
+            weights[ i ] -= step * m_gradient[ i ];
+         }
          m_mlp.setWeights( weights );
+         for ( size_t iShard = 0; iShard < m_shardMlps.size(); ++iShard )
+         {
+            m_shardMlps[ iShard ].setWeights( weights );
+         }
       }
 
       double error = calculateErrorsFullSet();
@@ -170,6 +201,63 @@ void StochasticGradDescMlpTrainer::train()
 
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// calcBatch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double StochasticGradDescMlpTrainer::calcBatch( const std::vector< size_t >& sampleIndices, bool calcGradient )
+{
+   if ( m_numThreads == 1 )
+   {
+      if ( !calcGradient )
+      {
+         return m_mlp.calcBatchError( *m_trainDataInput, *m_trainDataOutput, sampleIndices, m_batchErrors );
+      }
+      m_gradient = m_mlp.calcBatchErrorAndGradient( *m_trainDataInput, *m_trainDataOutput, sampleIndices, m_batchErrors );
+      return sumElements( m_batchErrors );
+   }
+
+   /// Split the samples into contiguous shards.
+   const size_t numShards = std::min( m_numThreads, sampleIndices.size() );
+   for ( size_t iShard = 0; iShard < numShards; ++iShard )
+   {
+      m_shardIndices[ iShard ].assign( sampleIndices.begin() + iShard * sampleIndices.size() / numShards,
+                                       sampleIndices.begin() + ( iShard + 1 ) * sampleIndices.size() / numShards );
+   }
+
+   m_workerPool->run( numShards, [ this, calcGradient ]( size_t iShard )
+   {
+      MultiLayerPerceptron& mlp = iShard == 0 ? m_mlp : m_shardMlps[ iShard - 1 ];
+      if ( calcGradient )
+      {
+         m_shardGradients[ iShard ] = &mlp.calcBatchErrorAndGradient( *m_trainDataInput, *m_trainDataOutput, m_shardIndices[ iShard ], m_shardErrors[ iShard ] );
+      }
+      else
+      {
+         mlp.calcBatchError( *m_trainDataInput, *m_trainDataOutput, m_shardIndices[ iShard ], m_shardErrors[ iShard ] );
+      }
+   } );
+
+   /// Reduce in shard order, so that the result does not depend on which thread finished first.
+   m_batchErrors.clear();
+   for ( size_t iShard = 0; iShard < numShards; ++iShard )
+   {
+      m_batchErrors.insert( m_batchErrors.end(), m_shardErrors[ iShard ].begin(), m_shardErrors[ iShard ].end() );
+   }
+   if ( calcGradient )
+   {
+      m_gradient.assign( m_mlp.getNumWeights(), 0 );
+      for ( size_t iShard = 0; iShard < numShards; ++iShard )
+      {
+         const RealVector& shardGradient = *m_shardGradients[ iShard ];
+         for ( size_t i = 0; i < m_gradient.size(); ++i )
+         {
+            m_gradient[ i ] += shardGradient[ i ];
+         }
+      }
+   }
+   return sumElements( m_batchErrors );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// updateSampleError
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
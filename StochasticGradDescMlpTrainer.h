@@ -2,14 +2,25 @@
 #define STOCHASTICGRADDESCMLPTRAINER_H
 
 #include "MlpTrainer.h"
+#include "MultiLayerPerceptron.h"
 #include "RandomNumberGenerator.h"
 
+#include <memory>
+
+class WorkerPool;
+
 namespace Mva
 {
 
 /**
  * @class StochasticGradDescMlpTrainer
  * @brief Stochastic/batch training for MLP neural network.
+ *
+ * With more than one thread, every batch (and the full set when the sample errors are updated) is split into one
+ * contiguous shard per thread. Each shard is propagated by its own copy of the MLP, so that the threads do not share
+ * neuron buffers, and the partial gradients are summed in shard order. The result therefore only depends on the number
+ * of threads, not on the scheduling. The batches are drawn on the calling thread, so the random draws do not depend on
+ * the number of threads.
  */
 class StochasticGradDescMlpTrainer : public Mva::MlpTrainer
 {
@@ -18,6 +29,10 @@ class StochasticGradDescMlpTrainer : public Mva::MlpTrainer
        * Constructur. Train MLP @param mlp.
        */
       StochasticGradDescMlpTrainer( MultiLayerPerceptron& mlp, const std::string& algName = "StochasticGradDescMlpTrainer", const AlgorithmBase* parent = 0 );
+      /**
+       * Destructor.
+       */
+      ~StochasticGradDescMlpTrainer();
 
       /**
        * Set the gradient descent eta: x(i+1) = x(i) + eta * df/dx(i).
@@ -27,6 +42,10 @@ class StochasticGradDescMlpTrainer : public Mva::MlpTrainer
        * Set the batch size and the number of iterations before a full batch study is done.
        */
       void setBatchSize( size_t batchSize, size_t numIterationsPerEpoch );
+      /**
+       * Set the number of threads that share the propagation of a batch (default 1).
+       */
+      void setNumThreads( size_t numThreads );
 
       /**
        * Train the network.
@@ -42,6 +61,11 @@ class StochasticGradDescMlpTrainer : public Mva::MlpTrainer
        * Calculate the errors of the individual samples for the full set and @return the total error normalised to the number of samples in the full set.
        */
       double calculateErrorsFullSet();
+      /**
+       * Calculate the errors of the samples @param sampleIndices into m_batchErrors and, if @param calcGradient is set,
+       * the gradient summed over the samples into m_gradient. @return the sum of the errors.
+       */
+      double calcBatch( const std::vector< size_t >& sampleIndices, bool calcGradient );
       /**
        * Update the error, @param error, for sample @param sampleIndex.
        */
@@ -53,6 +77,15 @@ class StochasticGradDescMlpTrainer : public Mva::MlpTrainer
       size_t					 m_numIterationsPerEpoch;		//! Number of iterations before full batch study is done.
       RandomNumberGenerator m_rng;								//! Random number generator.
       RealVector				 m_sampleErrors;					//! Errors for each sample.
+      RealVector				 m_batchErrors;					//! Errors of the samples in the current batch.
+      std::vector< size_t >	 m_fullSet;							//! Indices of all samples.
+      RealVector				 m_gradient;						//! Gradient summed over the current batch.
+      size_t					 m_numThreads;						//! Number of threads.
+      std::unique_ptr< WorkerPool > m_workerPool;				//! Threads that propagate the shards.
+      std::vector< MultiLayerPerceptron > m_shardMlps;		//! Copies of the MLP for the shards after the first.
+      std::vector< std::vector< size_t > > m_shardIndices;	//! Sample indices per shard.
+      std::vector< RealVector > m_shardErrors;				//! Sample errors per shard.
+      std::vector< const RealVector* > m_shardGradients;	//! Gradient per shard, owned by the shard MLPs.
       double					 m_largestSampleError;			//! Largest sample error.
       const static size_t	 s_numTriesAddSampleToBatch;	//! Max number of tries to draw an individual sample.
 
@@ -156,8 +156,10 @@ RawPcmData::Ptr TestDataSupply::generateChord( Synthesizer::IGenerator& generato
       generator.setPhase( 0 );
       generator.setFrequency( notes[iNote].getFrequency() );
       generator.resetEnvelopePhase();
-      RawPcmData::Ptr noteData = generator.generate( numSamples );
-      result->mixAdd( *noteData );
+      if ( numSamples > 0 )
+      {
+         generator.renderAdd( &(*result)[ 0 ], numSamples );
+      }
 
    }
    return RawPcmData::Ptr( result );
@@ -7,24 +7,30 @@
 #include "TestDataSupply.h"
 
 /// Algorithms being tested.
+#include "AutoDiffFitFunction.h"
 #include "Chi2FitObjective.h"
 #include "ComposedRealFuncWithDerivative.h"
+#include "FftConvolution.h"
 #include "GaussPdf.h"
 #include "GradDescOptimiser.h"
 #include "Hypercube.h"
 #include "KernelPdf.h"
+#include "LevenbergMarquardtOptimiser.h"
 #include "LinearInterpolator.h"
 #include "LineSearchGradDescOptimiser.h"
 #include "McmcOptimiser.h"
 #include "NewtonSolver1D.h"
 #include "ParticleSwarmOptimiser.h"
 #include "PolynomialFitFunction.h"
+#include "RandomNumberGenerator.h"
 #include "RealMemFunction.h"
 #include "SampledMovingAverage.h"
+#include "SortCache.h"
 #include "TwoDimExampleObjective.h"
 #include "UniformPdf.h"
 
 
+#include <algorithm>
 #include <cmath>
 
 using namespace Math;
@@ -43,11 +49,14 @@ void TestMath::execute()
 
    /// Fitting.
    testSimpleFit();
+   testFitGradient();
+   testLevenbergMarquardt();
 
    /// Stochastic optimisation algorithms.
    testParticleSwarm();
    testMcmc();
    testSampledMovingAverage();
+   testFftConvolution();
 
    /// Math containers.
    testTwoTuple();
@@ -56,7 +65,9 @@ void TestMath::execute()
    /// Other/uncategorized.
    testNewtonSolver1D();
    testPdf();
+   testKernelPdfBatch();
    testLinearInterpolator();
+   testRandomNumberGenerator();
 
    msg << Msg::Info << "Math tests done." << Msg::EndReq;
 }
@@ -93,6 +104,21 @@ void TestMath::testGradDescOptimiser()
    startVal[0] = 50;
    startVal[1] = 100;
 
+   /// Batch evaluation agrees with single evaluations.
+   std::vector< RealVector > points;
+   for ( size_t i = 0; i < 10; ++i )
+   {
+      points.push_back( realVector( 0.3 * i - 1, 2 - 0.5 * i ) );
+   }
+   const RealVector& batchValues = obj.evaluateBatch( points );
+   for ( size_t i = 0; i < points.size(); ++i )
+   {
+      if ( fabs( batchValues[ i ] - obj.evaluate( points[ i ] ) ) > 1e-12 * ( 1 + fabs( batchValues[ i ] ) ) )
+      {
+         throw ExceptionTestFailed( "testGradDescOptimiser", "Batch evaluation differs from single evaluation." );
+      }
+   }
+
    GradDescOptimiser opt( obj, startVal );
    const RealVector& solution = opt.solve();
 
@@ -133,6 +159,21 @@ void TestMath::testSimpleFit()
    /// Define the fit objective.
    Math::Chi2FitObjective fitObj( xData, yData, ySigma2, fitFunction );
 
+   /// Batch evaluation agrees with single evaluations.
+   std::vector< RealVector > parameterSets( 5, startValues );
+   for ( size_t i = 0; i < parameterSets.size(); ++i )
+   {
+      parameterSets[ i ][ i ] = 0.1 * ( i + 1 );
+   }
+   const RealVector& batchChi2 = fitObj.evaluateBatch( parameterSets );
+   for ( size_t i = 0; i < parameterSets.size(); ++i )
+   {
+      if ( fabs( batchChi2[ i ] - fitObj.evaluate( parameterSets[ i ] ) ) > 1e-12 * batchChi2[ i ] )
+      {
+         throw ExceptionTestFailed( "testSimpleFit", "Batch chi2 differs from single chi2." );
+      }
+   }
+
    Math::LineSearchGradDescOptimiser lineSearchOptimiser( fitObj );
    lineSearchOptimiser.setMaxIterations( 100000 );
    lineSearchOptimiser.setMinGradLength( 1 );
@@ -154,6 +195,160 @@ void TestMath::testSimpleFit()
    gPlotFactory().createGraph( xData, fitFunction->evalMany( xData ), Qt::green );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// GaussFitFunction (needed by testFitGradient and testLevenbergMarquardt).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class GaussFitFunction : public Math::AutoDiffFitFunction< GaussFitFunction, 3 >
+{
+   public:
+      template < class T >
+      T evaluate( double x, const T* p ) const
+      {
+         T z = ( x - p[ 1 ] ) / p[ 2 ];
+         return p[ 0 ] * exp( -0.5 * z * z );
+      }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testFitGradient
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestMath::testFitGradient()
+{
+   Logger msg( "testFitGradient" );
+   msg << Msg::Info << "Running testFitGradient..." << Msg::EndReq;
+
+   RandomNumberGenerator rng( 2 );
+   size_t numSamples = 200;
+   RealVector xData( numSamples );
+   RealVector yData( numSamples );
+   RealVector ySigma2( numSamples, 0.5 );
+   for ( size_t i = 0; i < numSamples; ++i )
+   {
+      xData[ i ] = ( i - 0.5 * numSamples ) / 40.0;
+      yData[ i ] = 3 * exp( -xData[ i ] * xData[ i ] ) + rng.uniform( -0.1, 0.1 );
+   }
+
+   /// Exact gradients of an analytic (polynomial) and an automatically differentiated (Gauss) fit function agree with
+   /// finite differences.
+   Math::PolynomialFitFunction polynomial( 6 );
+   GaussFitFunction gauss;
+   Math::FitFunctionBase* functions[] = { &polynomial, &gauss };
+   const RealVector parameters[] = { realVector( 1, -0.5, 0.3, 0.2, -0.1, 0.05, 0.01 ), realVector( 2, 0.3, 0.8 ) };
+   for ( size_t iFunc = 0; iFunc < 2; ++iFunc )
+   {
+      Math::Chi2FitObjective fitObj( xData, yData, ySigma2, functions[ iFunc ] );
+      const RealVector& exact = fitObj.calculateGradient( parameters[ iFunc ] );
+      const RealVector& approx = fitObj.Math::IObjectiveFunction::calculateGradient( parameters[ iFunc ], 1e-7 );
+      msg << Msg::Info << "Exact gradient = " << exact << Msg::EndReq;
+      msg << Msg::Info << "Finite difference gradient = " << approx << Msg::EndReq;
+      for ( size_t i = 0; i < exact.size(); ++i )
+      {
+         if ( fabs( exact[ i ] - approx[ i ] ) > 1e-4 * ( 1 + fabs( exact[ i ] ) ) )
+         {
+            throw ExceptionTestFailed( "testFitGradient", "Exact gradient differs from finite differences." );
+         }
+      }
+   }
+
+   /// The value with the parameter gradient equals the plain evaluation.
+   gauss.setParameters( parameters[ 1 ] );
+   RealVector parGradient( 3 );
+   if ( fabs( gauss.evalWithParameterGradient( 0.7, parGradient.data() ) - gauss( 0.7 ) ) > 1e-15 )
+   {
+      throw ExceptionTestFailed( "testFitGradient", "Automatic differentiation changes the function value." );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// NumericGaussFitFunction (needed by testLevenbergMarquardt).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class NumericGaussFitFunction : public GaussFitFunction
+{
+   public:
+      bool hasParameterGradient() const
+      {
+         return false;
+      }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testLevenbergMarquardt
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestMath::testLevenbergMarquardt()
+{
+   Logger msg( "testLevenbergMarquardt" );
+   msg << Msg::Info << "Running testLevenbergMarquardt..." << Msg::EndReq;
+
+   RandomNumberGenerator rng( 3 );
+   size_t numSamples = 200;
+   RealVector xData( numSamples );
+   RealVector yData( numSamples );
+   RealVector ySigma2( numSamples, 0.01 );
+   for ( size_t i = 0; i < numSamples; ++i )
+   {
+      xData[ i ] = ( i - 0.5 * numSamples ) / 40.0;
+      double z = ( xData[ i ] - 0.2 ) / 0.5;
+      yData[ i ] = 3 * exp( -0.5 * z * z ) + rng.uniform( -0.1, 0.1 );
+   }
+
+   /// Fit a Gauss peak with the exact (automatically differentiated) and with the finite difference Jacobian.
+   GaussFitFunction gauss;
+   NumericGaussFitFunction numericGauss;
+   Math::FitFunctionBase* functions[] = { &gauss, &numericGauss };
+   RealVector solutions[ 2 ];
+   for ( size_t iFunc = 0; iFunc < 2; ++iFunc )
+   {
+      Math::Chi2FitObjective fitObj( xData, yData, ySigma2, functions[ iFunc ] );
+      Math::LevenbergMarquardtOptimiser optimiser( fitObj );
+      solutions[ iFunc ] = optimiser.solve( realVector( 1, -0.5, 1 ) );
+      msg << Msg::Info << "Solution = " << solutions[ iFunc ] << ", chi2 = " << optimiser.getChi2() << " after " << optimiser.getNumIterations() << " iterations and " << optimiser.getNumEvaluations() << " evaluations." << Msg::EndReq;
+
+      /// Every iteration but the last accepts a trial step; the finite difference Jacobian costs one residual evaluation
+      /// per parameter and iteration on top.
+      const size_t numJacobianEvaluations = fitObj.hasParameterGradient() ? 0 : 3 * optimiser.getNumIterations();
+      if ( optimiser.getNumEvaluations() < 1 + numJacobianEvaluations + optimiser.getNumIterations() - 1 )
+      {
+         throw ExceptionTestFailed( "testLevenbergMarquardt", "Jacobian evaluations are not counted." );
+      }
+      if ( fabs( optimiser.getChi2() - fitObj.evaluate( solutions[ iFunc ] ) ) > 1e-9 * optimiser.getChi2() )
+      {
+         throw ExceptionTestFailed( "testLevenbergMarquardt", "Reported chi2 differs from the objective." );
+      }
+      if ( fabs( solutions[ iFunc ][ 0 ] - 3 ) > 0.05 || fabs( solutions[ iFunc ][ 1 ] - 0.2 ) > 0.05 || fabs( fabs( solutions[ iFunc ][ 2 ] ) - 0.5 ) > 0.05 )
+      {
+         throw ExceptionTestFailed( "testLevenbergMarquardt", "Fit did not converge to the true peak." );
+      }
+   }
+   for ( size_t i = 0; i < 3; ++i )
+   {
+      if ( fabs( solutions[ 0 ][ i ] - solutions[ 1 ][ i ] ) > 1e-5 )
+      {
+         throw ExceptionTestFailed( "testLevenbergMarquardt", "Exact and finite difference Jacobian give different solutions." );
+      }
+   }
+
+   /// Linear least squares (polynomial): the first Gauss-Newton step reaches the minimum found by line search.
+   Math::PolynomialFitFunction polynomial( 3 );
+   Math::Chi2FitObjective polyObj( xData, yData, ySigma2, &polynomial );
+   Math::LevenbergMarquardtOptimiser lmOptimiser( polyObj );
+   const RealVector& lmSolution = lmOptimiser.solve( RealVector( 4, 0 ) );
+   Math::LineSearchGradDescOptimiser lsOptimiser( polyObj );
+   lsOptimiser.setMaxIterations( 100000 );
+   lsOptimiser.setMinObjFuncValChange( 1e-10 );
+   lsOptimiser.setLoggerThreshold( Msg::Info );
+   const RealVector& lsSolution = lsOptimiser.solve( RealVector( 4, 0 ) );
+   msg << Msg::Info << "Polynomial: LevenbergMarquardtOptimiser chi2 = " << polyObj.evaluate( lmSolution ) << ", LineSearchGradDescOptimiser chi2 = " << polyObj.evaluate( lsSolution ) << Msg::EndReq;
+   if ( polyObj.evaluate( lmSolution ) > polyObj.evaluate( lsSolution ) * ( 1 + 1e-9 ) )
+   {
+      throw ExceptionTestFailed( "testLevenbergMarquardt", "Chi2 above the line search result for a linear problem." );
+   }
+
+   gPlotFactory().createPlot( "testLevenbergMarquardt/GaussFit" );
+   gPlotFactory().createScatter( xData, yData );
+   gauss.setParameters( solutions[ 0 ] );
+   gPlotFactory().createGraph( xData, gauss.evalMany( xData ), Qt::green );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// testSampledMovingAverage
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -200,6 +395,101 @@ void TestMath::testSampledMovingAverage()
       msg << Msg::Verbose << "Moving average of sample " << i << ": " << movAvg[i] << Msg::EndReq;
    }
 
+   /// All exact backends agree with the direct calculation, also in place; Automatic picks the expected backend.
+   typedef Math::SampledMovingAverage SMA;
+   const RealVector& gaussWeights = SMA::createGaussianFilter( 41, 20 );
+   const RealVector boxWeights( 41, 1 );
+   const RealVector* weightSets[] = { &gaussWeights, &boxWeights };
+   const SMA::Backend exactBackends[] = { SMA::Fft, SMA::RunningSum };
+   const SMA::Backend automaticBackends[] = { SMA::Direct, SMA::RunningSum };
+   for ( size_t iSet = 0; iSet < 2; ++iSet )
+   {
+      SMA direct( *weightSets[ iSet ], SMA::Direct );
+      SMA exact( *weightSets[ iSet ], exactBackends[ iSet ] );
+      SMA automatic( *weightSets[ iSet ] );
+      if ( automatic.getBackend() != automaticBackends[ iSet ] )
+      {
+         throw ExceptionTestFailed( "testSampledMovingAverage", "Unexpected automatic backend." );
+      }
+
+      const RealVector& reference = direct.calculate( dataSet );
+      RealVector inPlace( dataSet );
+      direct.calculate( inPlace, inPlace );
+      RealVector exactInPlace( dataSet );
+      exact.calculate( exactInPlace, exactInPlace );
+      const RealVector& exactResult = exact.calculate( dataSet );
+      for ( size_t i = 0; i < dataSet.size(); ++i )
+      {
+         if ( inPlace[ i ] != reference[ i ] || exactInPlace[ i ] != exactResult[ i ] || fabs( exactResult[ i ] - reference[ i ] ) > 1e-12 * ( 1 + fabs( reference[ i ] ) ) )
+         {
+            throw ExceptionTestFailed( "testSampledMovingAverage", "Backends or in-place calculation differ from direct calculation." );
+         }
+      }
+   }
+
+   /// The recursive Gaussian approximates a wide Gaussian filter.
+   const RealVector& wideGaussWeights = SMA::createGaussianFilter( 201, 2 * 15 * 15 );
+   const RealVector& wideReference = SMA( wideGaussWeights, SMA::Direct ).calculate( dataSet );
+   const RealVector& recursive = SMA( wideGaussWeights, SMA::RecursiveGaussian ).calculate( dataSet );
+   double maxDiff = 0;
+   for ( size_t i = 0; i < dataSet.size(); ++i )
+   {
+      maxDiff = std::max( maxDiff, fabs( recursive[ i ] - wideReference[ i ] ) );
+   }
+   msg << Msg::Info << "Maximum difference of recursive Gaussian = " << maxDiff << ", data maximum = " << Utils::getMaxValue( dataSet ) << Msg::EndReq;
+   if ( maxDiff > 0.01 * Utils::getMaxValue( dataSet ) )
+   {
+      throw ExceptionTestFailed( "testSampledMovingAverage", "Recursive Gaussian differs from direct calculation." );
+   }
+
+   /// The recursion is not stable for widths below 0.5 samples; such filters are calculated directly.
+   const RealVector& narrowGaussWeights = SMA::createGaussianFilter( 5, 0.2 );
+   SMA narrowRecursive( narrowGaussWeights, SMA::RecursiveGaussian );
+   if ( narrowRecursive.getBackend() != SMA::Direct || narrowRecursive.calculate( dataSet ) != SMA( narrowGaussWeights, SMA::Direct ).calculate( dataSet ) )
+   {
+      throw ExceptionTestFailed( "testSampledMovingAverage", "Narrow recursive Gaussian does not fall back to direct calculation." );
+   }
+
+   msg << Msg::Info << "Test done." << Msg::EndReq;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testFftConvolution
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestMath::testFftConvolution()
+{
+   Logger msg( "testFftConvolution" );
+   msg << Msg::Info << "In testFftConvolution..." << Msg::EndReq;
+
+   const RealVector& dataSet = TestDataSupply::createNoiseAndPeaks();
+   const RealVector& kernel = Math::SampledMovingAverage::createGaussianFilter( 41, 20 );
+   const int nSamplesOneSide = ( kernel.size() - 1 ) / 2;
+
+   Math::FftConvolution convolution( kernel, dataSet.size() );
+   const RealVector& fftResult = convolution.calculate( dataSet );
+
+   /// Compare with direct convolution.
+   double maxDiff = 0;
+   for ( size_t iSample = 0; iSample < dataSet.size(); ++iSample )
+   {
+      double directResult = 0;
+      for ( size_t iKernel = 0; iKernel < kernel.size(); ++iKernel )
+      {
+         int iData = static_cast< int >( iSample ) + nSamplesOneSide - static_cast< int >( iKernel );
+         if ( iData >= 0 && iData < static_cast< int >( dataSet.size() ) )
+         {
+            directResult += kernel[ iKernel ] * dataSet[ iData ];
+         }
+      }
+      maxDiff = std::max( maxDiff, fabs( directResult - fftResult[ iSample ] ) );
+   }
+
+   msg << Msg::Info << "Maximum difference between direct and FFT convolution = " << maxDiff << Msg::EndReq;
+   if ( maxDiff > 1e-9 * Utils::getMaxValue( dataSet ) * sum( kernel ) )
+   {
+      throw ExceptionTestFailed( "testFftConvolution", "FFT convolution differs from direct convolution." );
+   }
+
    msg << Msg::Info << "Test done." << Msg::EndReq;
 }
 
@@ -392,6 +682,38 @@ void TestMath::testRegularAccumArray()
    }
    msg << Msg::Info << "Histogram entries are tested to be working correctly." << Msg::EndReq;
 
+   /// Fill an accumulation array that does not store entries with the same numbers.
+   Math::RegularAccumArray histNoEntries( nBins, minX, maxX, IAccumArray::ContentsAndMoments );
+   histNoEntries.add( minX - 0.1, 1 );
+   histNoEntries.add( maxX + 0.1, 1 );
+   x = histNoEntries.getMinX();
+   for ( size_t i = 0; i < nFills; ++i )
+   {
+      histNoEntries.add( x, 1 );
+      x += step;
+   }
+
+   if ( histNoEntries.getUnderflow() != 1 || histNoEntries.getOverflow() != 1 )
+   {
+      throw ExceptionTestFailed( "testRegularAccumArray", "Underflow or overflow not correct without entries." );
+   }
+   for ( size_t iBin = 0; iBin < nBins; ++iBin )
+   {
+      const IAccumArray::Bin& bin = histNoEntries.getBin( iBin );
+      if ( bin.getContents() != ( nFills / 2 ) || bin.getEntries().getNumElements() != 0 )
+      {
+         throw ExceptionTestFailed( "testRegularAccumArray", "Histogram without entries not filled correctly." );
+      }
+      /// Uniformly filled bins: the mean is in the middle of the filled values and the variance that of a uniform distribution.
+      const double expectedMean = bin.getMinX() + 0.5 * ( nFills / 2 - 1 ) * step;
+      const double expectedVariance = step * step * ( ( nFills / 2 ) * ( nFills / 2 ) - 1 ) / 12.;
+      if ( fabs( bin.getMean() - expectedMean ) > 1e-9 || fabs( bin.getVariance() - expectedVariance ) > 1e-9 )
+      {
+         throw ExceptionTestFailed( "testRegularAccumArray", "Moments of histogram without entries not correct." );
+      }
+   }
+   msg << Msg::Info << "Histogram without entries is tested to be working correctly." << Msg::EndReq;
+
    /// Test done.
    msg << Msg::Info << "Test done." << Msg::EndReq;
 }
@@ -571,6 +893,44 @@ void TestMath::testMcmc()
    gPlotFactory().createPlot( "testMcmc/distribution" );
    gPlotFactory().createGraph( xArr, objFuncEval, Qt::blue );
    gPlotFactory().createHistogram( regAccArr );
+
+   /// The default batch evaluation on a pool of threads agrees with single evaluations.
+   objFunc.setNumThreads( 3 );
+   const RealVector& batchProbs = objFunc.evaluateBatch( solution );
+   for ( size_t i = 0; i < solution.size(); i += 97 )
+   {
+      if ( batchProbs[ i ] != objFunc.evaluate( solution[ i ] ) )
+      {
+         throw ExceptionTestFailed( "testMcmc", "Multi-threaded batch evaluation differs from single evaluation." );
+      }
+   }
+   objFunc.setNumThreads( 1 );
+
+   /// Independent chains give the same samples for any number of threads.
+   std::vector< Math::RealVectorEnsemble > parallelSolutions;
+   for ( size_t numThreads = 1; numThreads <= 3; numThreads += 2 )
+   {
+      Math::McmcOptimiser parallelMcmc( objFunc );
+      parallelMcmc.setStartValues( Math::RealVectorEnsemble( 4, realVector( 10, 10 ) ) );
+      parallelMcmc.setNumIterations( 5000 );
+      parallelMcmc.setSeed( 3 );
+      parallelMcmc.setNumThreads( numThreads );
+      parallelSolutions.push_back( parallelMcmc.solve() );
+   }
+   if ( parallelSolutions[ 0 ] != parallelSolutions[ 1 ] || parallelSolutions[ 0 ].size() != 4 * 4999 )
+   {
+      throw ExceptionTestFailed( "testMcmc", "Independent chains depend on the number of threads." );
+   }
+   double xMean = 0;
+   for ( size_t i = 0; i < parallelSolutions[ 0 ].size(); ++i )
+   {
+      xMean += parallelSolutions[ 0 ][ i ][ 0 ] / parallelSolutions[ 0 ].size();
+   }
+   msg << Msg::Info << "Mean of independent chains: " << xMean << Msg::EndReq;
+   if ( fabs( xMean - 50 ) > 10 )
+   {
+      throw ExceptionTestFailed( "testMcmc", "Independent chains do not sample the distribution." );
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -623,6 +983,58 @@ void TestMath::testPdf()
    gPlotFactory().createGraph( xEvalKern, uniformEval, Qt::red );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testKernelPdfBatch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestMath::testKernelPdfBatch()
+{
+   Logger msg( "testKernelPdfBatch" );
+   msg << Msg::Info << "Running testKernelPdfBatch..." << Msg::EndReq;
+
+   RandomNumberGenerator rng( 1 );
+
+   size_t nSamples = 2000;
+   RealVector sampling( nSamples );
+   RealVector weights( nSamples );
+   for ( size_t i = 0; i < nSamples; ++i )
+   {
+      sampling[ i ] = rng.uniform( -100, 100 );
+      weights[ i ] = rng.uniform( 0, 1 );
+   }
+
+   const RealVector& xEval = Utils::createRangeReal( -200, 200, 5000 );
+
+   std::vector< Math::KernelPdf* > kernPdfs;
+   kernPdfs.push_back( new Math::KernelPdf( Math::IPdf::CPtr( new Math::GaussPdf( 1, 5 ) ), sampling, weights ) );
+   kernPdfs.push_back( new Math::KernelPdf( Math::IPdf::CPtr( new Math::UniformPdf( -3, 7 ) ), sampling, weights ) );
+
+   for ( size_t iPdf = 0; iPdf < kernPdfs.size(); ++iPdf )
+   {
+      const Math::KernelPdf& kernPdf = *kernPdfs[ iPdf ];
+      const RealVector& densityMany = kernPdf.getDensityMany( xEval );
+      const RealVector& integralMany = kernPdf.getIntegralMany( xEval );
+
+      double maxDiffDensity = 0;
+      double maxDiffIntegral = 0;
+      for ( size_t i = 0; i < xEval.size(); ++i )
+      {
+         maxDiffDensity = std::max( maxDiffDensity, fabs( densityMany[ i ] - kernPdf.getDensity( xEval[ i ] ) ) );
+         maxDiffIntegral = std::max( maxDiffIntegral, fabs( integralMany[ i ] - kernPdf.getIntegral( xEval[ i ] ) ) );
+      }
+
+      msg << Msg::Info << "KernelPdf " << iPdf << ": max. difference density = " << maxDiffDensity << ", integral = "
+          << maxDiffIntegral << Msg::EndReq;
+      if ( maxDiffDensity > 1e-12 || maxDiffIntegral > 1e-12 )
+      {
+         throw ExceptionTestFailed( "testKernelPdfBatch", "Batch evaluation differs from point-wise evaluation." );
+      }
+   }
+
+   Utils::cleanupVector( kernPdfs );
+
+   msg << Msg::Info << "Test done." << Msg::EndReq;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// devLinearInterpolator
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -644,5 +1056,117 @@ void TestMath::testLinearInterpolator()
       msg << Msg::Info << "x = " << xEval[ i ] << ", f(x) = x => x - f(x) = " << diff << " = 0" << Msg::EndReq;
    }
 
-   return;
+   /// Uniform and non-uniform data; evalMany with sorted (cursor) and unsorted points agrees with single evaluations
+   /// and with interpolate, also outside the data range.
+   RandomNumberGenerator rng( 4 );
+   RealVector xUniform( 50 );
+   RealVector xRandom( 50 );
+   RealVector yData( 50 );
+   for ( size_t i = 0; i < yData.size(); ++i )
+   {
+      xUniform[ i ] = 0.25 * i - 3;
+      xRandom[ i ] = rng.uniform( -3, 9 );
+      yData[ i ] = rng.uniform( -1, 1 );
+   }
+   Math::LinearInterpolator uniform( xUniform, yData );
+   Math::LinearInterpolator nonUniform( xRandom, yData );
+   if ( !uniform.isUniform() || nonUniform.isUniform() )
+   {
+      throw ExceptionTestFailed( "testLinearInterpolator", "Uniform spacing not detected correctly." );
+   }
+
+   const RealVector& xSorted = Utils::createRangeReal( -4, 10, 1000 );
+   RealVector xUnsorted( 1000 );
+   for ( size_t i = 0; i < xUnsorted.size(); ++i )
+   {
+      xUnsorted[ i ] = rng.uniform( -4, 10 );
+   }
+   Math::LinearInterpolator* interpolators[] = { &uniform, &nonUniform };
+   const RealVector* xDatas[] = { &xUniform, &xRandom };
+   for ( size_t iInterp = 0; iInterp < 2; ++iInterp )
+   {
+      SortCache sc( *xDatas[ iInterp ] );
+      const RealVector& xs = sc.applyTo( *xDatas[ iInterp ] );
+      const RealVector& ys = sc.applyTo( yData );
+      const RealVector* xEvals[] = { &xSorted, &xUnsorted };
+      for ( size_t iEval = 0; iEval < 2; ++iEval )
+      {
+         const RealVector& batch = interpolators[ iInterp ]->evalMany( *xEvals[ iEval ] );
+         for ( size_t i = 0; i < batch.size(); ++i )
+         {
+            double x = ( *xEvals[ iEval ] )[ i ];
+            size_t iUpper = std::upper_bound( xs.begin(), xs.end(), x ) - xs.begin();
+            double expected = iUpper == 0 ? ys.front() : iUpper == xs.size() ? ys.back() : Math::LinearInterpolator::interpolate( x, xs[ iUpper - 1 ], xs[ iUpper ], ys[ iUpper - 1 ], ys[ iUpper ] );
+            if ( fabs( batch[ i ] - expected ) > 1e-12 || fabs( ( *interpolators[ iInterp ] )( x ) - expected ) > 1e-12 )
+            {
+               throw ExceptionTestFailed( "testLinearInterpolator", "Interpolation differs from reference." );
+            }
+         }
+      }
+   }
+
+   msg << Msg::Info << "Test done." << Msg::EndReq;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testRandomNumberGenerator
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestMath::testRandomNumberGenerator()
+{
+   Logger msg( "testRandomNumberGenerator" );
+   msg << Msg::Info << "Running testRandomNumberGenerator..." << Msg::EndReq;
+
+   /// Streams are reproducible from the seed and different from each other.
+   RandomNumberGenerator stream2( 42, 2 );
+   RandomNumberGenerator jumped( 42 );
+   jumped.jump();
+   jumped.jump();
+   RandomNumberGenerator stream0( 42 );
+   for ( size_t i = 0; i < 100; ++i )
+   {
+      uint64_t x = stream2.next();
+      if ( x != jumped.next() || x == stream0.next() )
+      {
+         throw ExceptionTestFailed( "testRandomNumberGenerator", "Streams are not reproducible or not independent." );
+      }
+   }
+
+   /// Moments of the bulk fills, with n = 1e6 the statistical uncertainty is about 1e-3.
+   const size_t numValues = 1000001;
+   RandomNumberGenerator rng( 1 );
+   RealVector values( numValues );
+   for ( size_t iDist = 0; iDist < 2; ++iDist )
+   {
+      double expectedMean = iDist == 0 ? 1 : 2;
+      double expectedSigma = iDist == 0 ? 2 / sqrt( 12 ) : 3;
+      if ( iDist == 0 )
+      {
+         rng.fillUniform( values.data(), numValues, 0, 2 );
+      }
+      else
+      {
+         rng.fillGauss( values.data(), numValues, 2, 3 );
+      }
+
+      double sum = 0;
+      double sumSq = 0;
+      double sumFourth = 0;
+      for ( size_t i = 0; i < numValues; ++i )
+      {
+         double d = ( values[ i ] - expectedMean ) / expectedSigma;
+         sum += d;
+         sumSq += d * d;
+         sumFourth += d * d * d * d;
+      }
+      double mean = sum / numValues;
+      double variance = sumSq / numValues;
+      double kurtosis = sumFourth / numValues;
+      double expectedKurtosis = iDist == 0 ? 1.8 : 3;
+      msg << Msg::Info << ( iDist == 0 ? "Uniform" : "Gauss" ) << ": standardised mean = " << mean << ", variance = " << variance
+          << ", kurtosis = " << kurtosis << Msg::EndReq;
+      if ( fabs( mean ) > 5e-3 || fabs( variance - 1 ) > 1e-2 || fabs( kurtosis - expectedKurtosis ) > 5e-2 )
+      {
+         throw ExceptionTestFailed( "testRandomNumberGenerator", "Bulk fill has the wrong distribution." );
+      }
+   }
 }
@@ -22,6 +22,8 @@ class TestMath
 
    public:
       static void testSimpleFit();
+      static void testFitGradient();
+      static void testLevenbergMarquardt();
 
    /**
     * Stochastic optimisation algorithms.
@@ -35,6 +37,7 @@ class TestMath
     */
    public:
       static void testSampledMovingAverage();
+      static void testFftConvolution();
       static void testTwoTuple();
       static void testRegularAccumArray();
 
@@ -44,7 +47,9 @@ class TestMath
    public:
       static void testNewtonSolver1D();
       static void testPdf();
+      static void testKernelPdfBatch();
       static void testLinearInterpolator();
+      static void testRandomNumberGenerator();
 };
 
 #endif // TESTMATH_H
@@ -37,19 +37,32 @@ void TestSuite::execute()
    testNoiseGenerator();
    testTriangleGenerator();
    testSawtoothGenerator();
+   testOscillatorBank();
+   testBandLimitedWavetable();
+   testGeneratorRender();
+   testPolyphonicSynthesizer();
+   testRealTimeRenderer();
    testRandomMusic();
 
+   /// Test effects.
+   testEffectTrianglizerStream();
+
    /// Test waveAnalysis.
    testAdvancedFourier();
    testStftAlgorithm();
    testSpectralReassignment();
+   testPhaseVocoder();
+   testTimeStretcherSynthesis();
 
    /// Test feature algorithms.
    testPeakDetection();
    testSrSpecPeakAlgorithm();
+   testPitchSalienceAlgorithm();
+   testGroundToneLikelihood();
 
    /// Test multivariate analysis algorithms.
    testMlpGradients();
+   testFrozenMlp();
    testMultiLayerPerceptron();
 
    /// Test everything together.
@@ -84,6 +97,7 @@ void TestSuite::singleTest()
 #include "AlgorithmBase.h"
 #include "FftwAlgorithm.h"
 #include "FocalTones.h"
+#include "GroundToneLikelihood.h"
 #include "GaussPdf.h"
 #include "IThread.h"
 #include "Note.h"
@@ -91,17 +105,26 @@ void TestSuite::singleTest()
 #include "MultiLayerPerceptron.h"
 #include "MlpErrorObjective.h"
 #include "ObjectPool.h"
+#include "OscillatorBank.h"
+#include "FrozenMlp.h"
 #include "Peak.h"
 #include "Tone.h"
 #include "NaivePeaks.h"
+#include "PitchSalienceAlgorithm.h"
+#include "PhaseVocoder.h"
+#include "PeakSustainAlgorithm.h"
+#include "PolyphonicSynthesizer.h"
+#include "RealTimeRenderer.h"
 #include "SrSpecPeakAlgorithm.h"
 #include "StochasticGradDescMlpTrainer.h"
 #include "StftGraph.h"
 #include "DynamicFourier.h"
 #include "Regular2DHistogram.h"
 #include "ResonanceMatrixVisualisation.h"
+#include "FourierConfig.h"
 #include "FourierTransform.h"
 #include "StftAlgorithm.h"
+#include "TimeStretcher.h"
 #include "AdsrEnvelope.h"
 #include "NoiseGenerator.h"
 #include "TriangleGenerator.h"
@@ -109,6 +132,7 @@ void TestSuite::singleTest()
 #include "RealMemFunction.h"
 #include "RebinnedSRGraph.h"
 #include "SawtoothGenerator.h"
+#include "BandLimitedWavetable.h"
 #include "StftData.h"
 #include "SpectralReassignmentTransform.h"
 #include "WindowLocation.h"
@@ -220,6 +244,71 @@ void TestSuite::testEffectTrianglizer()
    delete outputData;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testEffectTrianglizerStream
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSuite::testEffectTrianglizerStream()
+{
+   Logger msg( "testEffectTrianglizerStream" );
+   msg << Msg::Info << "Running testEffectTrianglizerStream..." << Msg::EndReq;
+
+   /// Stereo input: a noisy tone with many extrema and a slow tone with a flat part and few extrema.
+   SamplingInfo samplingInfo( 44100 );
+   const size_t numSamples = 10000;
+   RandomNumberGenerator rng( 1 );
+   std::vector< RawPcmData* > channels;
+   channels.push_back( new RawPcmData( samplingInfo, numSamples ) );
+   channels.push_back( new RawPcmData( samplingInfo, numSamples ) );
+   for ( size_t i = 0; i < numSamples; ++i )
+   {
+      (*channels[ 0 ])[ i ] = sin( 0.05 * i ) + 0.1 * rng.uniform( -1, 1 );
+      (*channels[ 1 ])[ i ] = ( i > 3000 && i < 5000 ) ? 0.5 : sin( 0.001 * i );
+   }
+
+   /// Stream blocks in and read smaller blocks out, until the end.
+   EffectTrianglizer trianglizer( channels.size() );
+   const size_t blockSize = 100;
+   RealVector input( blockSize * channels.size() );
+   RealVector output( 64 * channels.size() );
+   RealVector result;
+   for ( size_t iFirst = 0; iFirst < numSamples; iFirst += blockSize )
+   {
+      for ( size_t i = 0; i < blockSize; ++i )
+      {
+         for ( size_t iChannel = 0; iChannel < channels.size(); ++iChannel )
+         {
+            input[ i * channels.size() + iChannel ] = (*channels[ iChannel ])[ iFirst + i ];
+         }
+      }
+      trianglizer.write( &input[ 0 ], blockSize );
+      if ( iFirst + blockSize >= numSamples )
+      {
+         trianglizer.finish();
+      }
+      while ( size_t numFrames = trianglizer.read( &output[ 0 ], 64 ) )
+      {
+         result.insert( result.end(), output.begin(), output.begin() + numFrames * channels.size() );
+      }
+   }
+
+   if ( result.size() != numSamples * channels.size() )
+   {
+      throw ExceptionTestFailed( "testEffectTrianglizerStream", "Streaming output has the wrong length." );
+   }
+   for ( size_t iChannel = 0; iChannel < channels.size(); ++iChannel )
+   {
+      RawPcmData::Ptr reference = EffectTrianglizer::apply( *channels[ iChannel ] );
+      for ( size_t i = 0; i < numSamples; ++i )
+      {
+         if ( fabs( result[ i * channels.size() + iChannel ] - (*reference)[ i ] ) > 1e-12 )
+         {
+            throw ExceptionTestFailed( "testEffectTrianglizerStream", "Streaming output differs from apply." );
+         }
+      }
+      delete channels[ iChannel ];
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// testPartialIntegralTransform
 ////////////////////////////////////////////////////////////////////////////////
@@ -617,6 +706,113 @@ void TestSuite::testSrSpecPeakAlgorithm()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testPitchSalienceAlgorithm
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSuite::testPitchSalienceAlgorithm()
+{
+   Logger msg( "testPitchSalienceAlgorithm" );
+   msg << Msg::Info << "Running testPitchSalienceAlgorithm..." << Msg::EndReq;
+
+   size_t fourierSize = 4096;
+
+   SamplingInfo samplingInfo( 44100 );
+
+   RealVector inputFreqs = realVector( 82.4, 220, 466.2, 1046.5 );
+
+   for ( RealVector::iterator it = inputFreqs.begin(); it != inputFreqs.end(); ++it )
+   {
+      Synthesizer::SawtoothGenerator generator( samplingInfo );
+      generator.setAmplitude( 0.5 );
+      generator.setFrequency( *it );
+
+      RawPcmData::Ptr data = generator.generate( 4 * fourierSize );
+
+      /// Plain and reassigned spectra should both give the true fundamental as most salient candidate.
+      WaveAnalysis::StftAlgorithm stftAlg( samplingInfo, fourierSize, WaveAnalysis::HanningWindowFuncDef(), fourierSize, 2 );
+      WaveAnalysis::StftData::Ptr stftData = stftAlg.execute( *data );
+      WaveAnalysis::SpectralReassignmentTransform srTransform( samplingInfo, fourierSize, fourierSize, 2 );
+      WaveAnalysis::StftData::Ptr srStftData = srTransform.execute( *data );
+
+      std::vector< const WaveAnalysis::StftData* > stftDataSets;
+      stftDataSets.push_back( stftData.get() );
+      stftDataSets.push_back( srStftData.get() );
+      for ( size_t iSet = 0; iSet < stftDataSets.size(); ++iSet )
+      {
+         FeatureAlgorithm::PitchSalienceAlgorithm salienceAlg( stftDataSets[ iSet ]->getConfig() );
+         std::vector< FeatureAlgorithm::PitchSalienceAlgorithm::CandidateList > candidates = salienceAlg.execute( *stftDataSets[ iSet ] );
+
+         /// Skip the first and last hops, which are only partially filled.
+         for ( size_t iHop = 1; iHop + 1 < candidates.size(); ++iHop )
+         {
+            if ( candidates[ iHop ].empty() || fabs( candidates[ iHop ][ 0 ].getFrequency() / *it - 1 ) > 0.01 )
+            {
+               throw ExceptionTestFailed( "testPitchSalienceAlgorithm", "Most salient candidate is not the fundamental frequency." );
+            }
+         }
+         msg << Msg::Info << "Frequency " << *it << ": most salient candidate at " << candidates[ 1 ][ 0 ].getFrequency() << Msg::EndReq;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testGroundToneLikelihood
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSuite::testGroundToneLikelihood()
+{
+   Logger msg( "testGroundToneLikelihood" );
+   msg << Msg::Info << "Running testGroundToneLikelihood..." << Msg::EndReq;
+
+   /// Three clusters of candidates, in random order, far enough apart that the points between them are out of reach.
+   RandomNumberGenerator rng( 1 );
+   RealVector candidates;
+   RealVector uncertainties;
+   RealVector clusterCentres = realVector( 10, 50, 100 );
+   for ( size_t iCand = 0; iCand < 60; ++iCand )
+   {
+      candidates.push_back( clusterCentres[ iCand % clusterCentres.size() ] + rng.uniform( -2, 2 ) );
+      uncertainties.push_back( rng.uniform( 0.1, 1 ) );
+   }
+   FeatureAlgorithm::GroundToneLikelihood lhf( candidates, uncertainties );
+   lhf.setTemperature( 1 );
+   lhf.setChi2Cutoff( 5 );
+
+   /// Sorted points from below the first to above the last candidate, with a repeated point.
+   RealVector sortedX;
+   for ( double x = -20; x < 140; x += 0.25 )
+   {
+      sortedX.push_back( x );
+   }
+   sortedX.insert( sortedX.begin() + sortedX.size() / 2, sortedX[ sortedX.size() / 2 ] );
+
+   /// The sliding window of evaluateMany should visit the same candidates as the binary search of evaluate. Both sum
+   /// the same weights in the same order, so the results should be identical: a candidate dropped at the edge of the
+   /// window only changes the sum by a weight of order exp( -40 ).
+   RealVector lhMany = lhf.evaluateMany( sortedX );
+   if ( lhMany.size() != sortedX.size() )
+   {
+      throw ExceptionTestFailed( "testGroundToneLikelihood", "evaluateMany returned the wrong number of values." );
+   }
+   size_t numOutOfReach = 0;
+   for ( size_t iX = 0; iX < sortedX.size(); ++iX )
+   {
+      double lh = lhf.evaluate( RealVector( 1, sortedX[ iX ] ) );
+      if ( lhMany[ iX ] != lh )
+      {
+         msg << Msg::Error << "At x = " << sortedX[ iX ] << ": evaluateMany gives " << lhMany[ iX ] << ", evaluate gives " << lh << Msg::EndReq;
+         throw ExceptionTestFailed( "testGroundToneLikelihood", "evaluateMany differs from evaluate." );
+      }
+      numOutOfReach += lh == 0 ? 1 : 0;
+   }
+
+   /// Both points within and out of reach of the candidates should have been tested.
+   if ( numOutOfReach == 0 || numOutOfReach == sortedX.size() )
+   {
+      throw ExceptionTestFailed( "testGroundToneLikelihood", "Test points do not cover both sides of the reach window." );
+   }
+   msg << Msg::Info << "evaluateMany agrees with evaluate at " << sortedX.size() << " points, " << numOutOfReach << " out of reach." << Msg::EndReq;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// testIntegration
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -904,6 +1100,32 @@ void TestSuite::testEnvelope()
       v[i] = envelope.getEnvelope( i );
    }
 
+   /// The segment-based block evaluation should agree with getEnvelope for any block boundaries and parameters.
+   std::vector< Synthesizer::AdsrEnvelope > envelopes;
+   envelopes.push_back( envelope );
+   envelopes.push_back( Synthesizer::AdsrEnvelope( 10.5, 0, 20.2, 0.5, 7 ) );
+   envelopes.push_back( Synthesizer::AdsrEnvelope( 0, 33.3, -1, 0.3, 7 ) );
+   envelopes.push_back( Synthesizer::AdsrEnvelope( 40, 40, 0, 0.6, 100 ) );
+   envelopes.back().setSustainLevel( 0.9 );
+   for ( size_t iEnv = 0; iEnv < envelopes.size(); ++iEnv )
+   {
+      for ( size_t blockSize = 1; blockSize < 200; blockSize += 37 )
+      {
+         RealVector block( blockSize );
+         for ( size_t iFirst = 0; iFirst < v.size(); iFirst += blockSize )
+         {
+            envelopes[ iEnv ].fillEnvelope( iFirst, blockSize, &block[ 0 ] );
+            for ( size_t i = 0; i < blockSize; ++i )
+            {
+               if ( fabs( block[ i ] - envelopes[ iEnv ].getEnvelope( iFirst + i ) ) > 1e-12 )
+               {
+                  throw ExceptionTestFailed( "testEnvelope", "Block envelope differs from getEnvelope." );
+               }
+            }
+         }
+      }
+   }
+
    SamplingInfo samplingInfo( 44100 );
    Synthesizer::SquareGenerator square( samplingInfo );
    square.setFrequency( 880 * 4 );
@@ -1035,6 +1257,405 @@ void TestSuite::testSawtoothGenerator()
    // stftGraph.create();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testOscillatorBank
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSuite::testOscillatorBank()
+{
+   Logger msg( "testOscillatorBank" );
+   msg << Msg::Info << "Running testOscillatorBank..." << Msg::EndReq;
+
+   const size_t numOscillators = 40;
+   const size_t numSamples = 10 * 44100;
+   const size_t chunkSize = 1000;
+
+   RealVector phaseSteps( numOscillators );
+   RealVector phases( numOscillators );
+   RealVector amplitudes( numOscillators );
+   Synthesizer::OscillatorBank bank;
+   for ( size_t iOsc = 0; iOsc < numOscillators; ++iOsc )
+   {
+      phaseSteps[ iOsc ] = 0.0123 * ( iOsc + 1 );
+      phases[ iOsc ] = 0.1 * iOsc;
+      amplitudes[ iOsc ] = 1.0 / ( iOsc + 1 );
+      bank.addOscillator( phaseSteps[ iOsc ], phases[ iOsc ], amplitudes[ iOsc ] );
+   }
+
+   /// Render in chunks that are not a multiple of the resync interval, the phase should carry over.
+   RealVector result( numSamples );
+   for ( size_t iFirst = 0; iFirst < numSamples; iFirst += chunkSize )
+   {
+      bank.render( &result[ iFirst ], std::min( chunkSize, numSamples - iFirst ) );
+   }
+
+   double maxDiff = 0;
+   for ( size_t iSample = 0; iSample < numSamples; ++iSample )
+   {
+      double val = 0;
+      for ( size_t iOsc = 0; iOsc < numOscillators; ++iOsc )
+      {
+         val += amplitudes[ iOsc ] * sin( phases[ iOsc ] + ( iSample + 1 ) * phaseSteps[ iOsc ] );
+      }
+      maxDiff = std::max( maxDiff, fabs( result[ iSample ] - val ) );
+   }
+   msg << Msg::Info << "Maximum difference with direct evaluation: " << maxDiff << Msg::EndReq;
+
+   if ( maxDiff > 1e-9 )
+   {
+      throw ExceptionTestFailed( "testOscillatorBank", "Oscillator bank does not reproduce direct evaluation." );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testBandLimitedWavetable
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSuite::testBandLimitedWavetable()
+{
+   Logger msg( "testBandLimitedWavetable" );
+   msg << Msg::Info << "Running testBandLimitedWavetable..." << Msg::EndReq;
+
+   SamplingInfo samplingInfo( 44100 );
+   const size_t numSamples = 4410;
+   const Synthesizer::BandLimitedWavetable& wavetable = Synthesizer::SawtoothGenerator::getWavetable();
+
+   /// At 700 Hz, all 31 harmonics below the Nyquist frequency must be present.
+   const double nyquist = samplingInfo.getNyquistFrequency();
+   if ( wavetable.getNumHarmonics( wavetable.selectLevel( samplingInfo.getPhaseStepPerSample( 700 ) ) ) != 31 )
+   {
+      throw ExceptionTestFailed( "testBandLimitedWavetable", "Wrong number of harmonics at 700 Hz." );
+   }
+
+   std::vector< double > frequencies = { 55, 440, 700, 1000, 7000 };
+   for ( size_t iFreq = 0; iFreq < frequencies.size(); ++iFreq )
+   {
+      const double phaseStep = samplingInfo.getPhaseStepPerSample( frequencies[ iFreq ] );
+      const size_t numHarmonics = wavetable.getNumHarmonics( wavetable.selectLevel( phaseStep ) );
+      /// The next level must alias; it has one more harmonic, or at most a semitone more.
+      const double nextLevelFrequency = numHarmonics < 17 ? ( numHarmonics + 1 ) * frequencies[ iFreq ] : numHarmonics * pow( 2, 1 / 12. ) * frequencies[ iFreq ];
+      if ( numHarmonics * frequencies[ iFreq ] >= nyquist || nextLevelFrequency < nyquist )
+      {
+         throw ExceptionTestFailed( "testBandLimitedWavetable", "Wrong level selected." );
+      }
+
+      Synthesizer::SawtoothGenerator generator( samplingInfo );
+      generator.setFrequency( frequencies[ iFreq ] );
+      generator.setPhase( 1 );
+      RawPcmData::Ptr data = generator.generate( numSamples );
+
+      /// Compare with the sum of the harmonics in the selected table.
+      double maxDiff = 0;
+      for ( size_t iSample = 0; iSample < numSamples; ++iSample )
+      {
+         double val = 0;
+         for ( size_t iHarmonic = 1; iHarmonic <= numHarmonics; ++iHarmonic )
+         {
+            val += 2 / M_PI / iHarmonic * ( ( iHarmonic % 2 == 0 ) ? -1 : 1 ) * sin( iHarmonic * ( 1 + ( iSample + 1 ) * phaseStep ) );
+         }
+         maxDiff = std::max( maxDiff, fabs( (*data)[ iSample ] - val ) );
+      }
+      msg << Msg::Info << frequencies[ iFreq ] << " Hz, " << numHarmonics << " harmonics: maximum difference with direct evaluation " << maxDiff << Msg::EndReq;
+
+      if ( maxDiff > 1e-3 )
+      {
+         throw ExceptionTestFailed( "testBandLimitedWavetable", "Wavetable does not reproduce the band-limited waveform." );
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testGeneratorRender
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSuite::testGeneratorRender()
+{
+   Logger msg( "testGeneratorRender" );
+   msg << Msg::Info << "Running testGeneratorRender..." << Msg::EndReq;
+
+   SamplingInfo samplingInfo( 44100 );
+   const size_t numSamples = 44100;
+
+   /// Pairs of identical generators, the first renders in blocks and the second at once.
+   std::vector< Synthesizer::IGenerator* > generators;
+   for ( size_t iCopy = 0; iCopy < 2; ++iCopy )
+   {
+      generators.push_back( new Synthesizer::SineGenerator( samplingInfo ) );
+      generators.push_back( new Synthesizer::SquareGenerator( samplingInfo ) );
+      generators.push_back( new Synthesizer::TriangleGenerator( samplingInfo ) );
+      generators.push_back( new Synthesizer::SawtoothGenerator( samplingInfo ) );
+      generators.push_back( new Synthesizer::NoiseGenerator( samplingInfo, 1 ) );
+   }
+   for ( size_t iGen = 0; iGen < generators.size(); ++iGen )
+   {
+      generators[ iGen ]->setFrequency( 440 );
+      generators[ iGen ]->setEnvelope( new Synthesizer::AdsrEnvelope( 10000, 5000, 10000, 0.5, 5000 ) );
+   }
+
+   const size_t numTypes = generators.size() / 2;
+   for ( size_t iGen = 0; iGen < numTypes; ++iGen )
+   {
+      /// Render in blocks of varying size, the result should be continuous.
+      RealVector blockData( numSamples );
+      size_t blockSize = 1;
+      for ( size_t iFirst = 0; iFirst < numSamples; iFirst += blockSize, blockSize = blockSize * 3 % 1000 + 1 )
+      {
+         generators[ iGen ]->render( &blockData[ iFirst ], std::min( blockSize, numSamples - iFirst ) );
+      }
+
+      RawPcmData::Ptr data = generators[ iGen + numTypes ]->generate( numSamples );
+
+      for ( size_t iSample = 0; iSample < numSamples; ++iSample )
+      {
+         if ( fabs( blockData[ iSample ] - (*data)[ iSample ] ) > 1e-10 )
+         {
+            throw ExceptionTestFailed( "testGeneratorRender", "Rendering in blocks does not reproduce rendering at once." );
+         }
+      }
+   }
+
+   Utils::cleanupVector( generators );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testPolyphonicSynthesizer
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSuite::testPolyphonicSynthesizer()
+{
+   Logger msg( "testPolyphonicSynthesizer" );
+   msg << Msg::Info << "Running testPolyphonicSynthesizer..." << Msg::EndReq;
+
+   SamplingInfo samplingInfo( 44100 );
+   const size_t numVoices = 6;
+   const double noteFrequencies[] = { 220, 277, 330, 440, 554, 660, 880 };
+   const size_t numNotes = sizeof( noteFrequencies ) / sizeof( noteFrequencies[ 0 ] );
+   const size_t noteLength = 10000;
+   const size_t noteSpacing = 1000;
+
+   /// The same notes with one and with three threads, the second rendered in chunks.
+   std::vector< RawPcmData::Ptr > results;
+   for ( size_t numThreads = 1; numThreads <= 3; numThreads += 2 )
+   {
+      Synthesizer::PolyphonicSynthesizer synth( samplingInfo, numThreads );
+      for ( size_t iVoice = 0; iVoice < numVoices; ++iVoice )
+      {
+         synth.addVoice( new Synthesizer::SineGenerator( samplingInfo ) );
+      }
+      for ( size_t iNote = 0; iNote < numNotes; ++iNote )
+      {
+         synth.addNote( noteFrequencies[ iNote ], 0.1, iNote * noteSpacing, noteLength );
+      }
+      if ( synth.getNumStolenNotes() != numNotes - numVoices )
+      {
+         throw ExceptionTestFailed( "testPolyphonicSynthesizer", "Unexpected number of stolen notes." );
+      }
+
+      RawPcmData* data = new RawPcmData( samplingInfo, synth.getEndSample() );
+      const size_t chunkSize = numThreads == 1 ? data->size() : 3333;
+      for ( size_t iFirst = 0; iFirst < data->size(); iFirst += chunkSize )
+      {
+         synth.render( &(*data)[ iFirst ], std::min( chunkSize, data->size() - iFirst ) );
+      }
+      results.push_back( RawPcmData::Ptr( data ) );
+   }
+
+   /// Reference: each note rendered separately, the first note is cut off by the last one.
+   RealVector reference( results[ 0 ]->size(), 0 );
+   for ( size_t iNote = 0; iNote < numNotes; ++iNote )
+   {
+      Synthesizer::SineGenerator generator( samplingInfo );
+      generator.setFrequency( noteFrequencies[ iNote ] );
+      generator.setAmplitude( 0.1 );
+      size_t numSamples = iNote == 0 ? ( numNotes - 1 ) * noteSpacing : noteLength;
+      generator.renderAdd( &reference[ iNote * noteSpacing ], numSamples );
+   }
+
+   for ( size_t iSample = 0; iSample < reference.size(); ++iSample )
+   {
+      if ( fabs( (*results[ 0 ])[ iSample ] - reference[ iSample ] ) > 1e-12 || fabs( (*results[ 1 ])[ iSample ] - reference[ iSample ] ) > 1e-12 )
+      {
+         throw ExceptionTestFailed( "testPolyphonicSynthesizer", "Polyphonic rendering does not reproduce the separate notes." );
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testRealTimeRenderer
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSuite::testRealTimeRenderer()
+{
+   Logger msg( "testRealTimeRenderer" );
+   msg << Msg::Info << "Running testRealTimeRenderer..." << Msg::EndReq;
+
+   SamplingInfo samplingInfo( 44100 );
+   const size_t blockSize = 256;
+   const size_t numBlocks = 100;
+
+   Synthesizer::SineGenerator generator( samplingInfo );
+   generator.setFrequency( 440 );
+   Synthesizer::WaveFileAudioSink sink( "", samplingInfo );
+   Synthesizer::RealTimeRenderer< Synthesizer::IGenerator > renderer( generator, sink, samplingInfo.getSamplingRate(), blockSize, 3 );
+   Synthesizer::RenderStatistics stats = renderer.run( numBlocks );
+
+   msg << Msg::Info << "Block period " << stats.getBlockPeriod() << " s, median render time " << stats.getRenderTimePercentile( 50 )
+       << " s, 99th percentile " << stats.getRenderTimePercentile( 99 ) << " s, " << stats.getNumDeadlineMisses() << " deadline misses, "
+       << stats.getNumUnderruns() << " underruns, latency " << stats.getLatency() << " s" << Msg::EndReq;
+
+   if ( stats.getNumBlocks() != numBlocks || sink.getData().size() != numBlocks * blockSize )
+   {
+      throw ExceptionTestFailed( "testRealTimeRenderer", "Wrong number of blocks passed to the sink." );
+   }
+
+   /// Without underruns, the sink gets the same samples as offline rendering.
+   if ( stats.getNumUnderruns() == 0 )
+   {
+      Synthesizer::SineGenerator reference( samplingInfo );
+      reference.setFrequency( 440 );
+      RawPcmData::Ptr data = reference.generate( numBlocks * blockSize );
+      for ( size_t iSample = 0; iSample < data->size(); ++iSample )
+      {
+         if ( fabs( (*data)[ iSample ] - sink.getData()[ iSample ] ) > 1e-12 )
+         {
+            throw ExceptionTestFailed( "testRealTimeRenderer", "Real-time rendering does not reproduce offline rendering." );
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testPhaseVocoder
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSuite::testPhaseVocoder()
+{
+   Logger msg( "testPhaseVocoder" );
+   msg << Msg::Info << "Running testPhaseVocoder..." << Msg::EndReq;
+
+   SamplingInfo samplingInfo( 44100 );
+   const size_t numSamples = 20000;
+   RandomNumberGenerator rng( 1 );
+   RealVector input( numSamples );
+   for ( size_t i = 0; i < numSamples; ++i )
+   {
+      input[ i ] = 0.5 * sin( 2 * M_PI * 440 * i / 44100 ) + 0.2 * sin( 2 * M_PI * 1234.5 * i / 44100 ) + 0.05 * rng.uniform( -1, 1 );
+   }
+
+   /// Stretch factor 1 reconstructs the input, since all phase rotations vanish.
+   for ( size_t iStretch = 0; iStretch < 2; ++iStretch )
+   {
+      const double stretchFactor = iStretch == 0 ? 1 : 1.5;
+      Music::PhaseVocoder vocoder( stretchFactor, samplingInfo );
+      if ( fabs( vocoder.getLatency() - 1024 / 44100.0 ) > 1e-12 )
+      {
+         throw ExceptionTestFailed( "testPhaseVocoder", "Unexpected latency." );
+      }
+
+      RealVector output;
+      RealVector block( 1000 );
+      for ( size_t iFirst = 0; iFirst < numSamples; iFirst += 300 )
+      {
+         vocoder.write( &input[ iFirst ], std::min( size_t( 300 ), numSamples - iFirst ) );
+         while ( size_t n = vocoder.read( &block[ 0 ], block.size() ) )
+         {
+            output.insert( output.end(), block.begin(), block.begin() + n );
+         }
+      }
+      vocoder.finish();
+      while ( size_t n = vocoder.read( &block[ 0 ], block.size() ) )
+      {
+         output.insert( output.end(), block.begin(), block.begin() + n );
+      }
+
+      if ( output.size() != static_cast< size_t >( numSamples * stretchFactor + 0.5 ) )
+      {
+         throw ExceptionTestFailed( "testPhaseVocoder", "Output has the wrong length." );
+      }
+
+      if ( stretchFactor == 1 )
+      {
+         for ( size_t i = 0; i < numSamples; ++i )
+         {
+            if ( fabs( output[ i ] - input[ i ] ) > 1e-9 )
+            {
+               throw ExceptionTestFailed( "testPhaseVocoder", "Stretch factor 1 does not reproduce the input." );
+            }
+         }
+      }
+      else
+      {
+         /// The stretched tone keeps its pitch and level: compare the power at 440 Hz in the middle of both signals.
+         const size_t length = 8192;
+         double inputPower = 0;
+         double outputPower = 0;
+         for ( size_t iSignal = 0; iSignal < 2; ++iSignal )
+         {
+            const RealVector& signal = iSignal == 0 ? input : output;
+            const size_t offset = ( signal.size() - length ) / 2;
+            Complex sum = 0;
+            for ( size_t i = 0; i < length; ++i )
+            {
+               sum += signal[ offset + i ] * std::polar( 1.0, -2 * M_PI * 440 * i / 44100 );
+            }
+            ( iSignal == 0 ? inputPower : outputPower ) = std::norm( sum );
+         }
+         msg << Msg::Info << "Power at 440 Hz after stretching relative to before: " << outputPower / inputPower << Msg::EndReq;
+         if ( fabs( outputPower / inputPower - 1 ) > 0.1 )
+         {
+            throw ExceptionTestFailed( "testPhaseVocoder", "Stretched tone lost its pitch or level." );
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testTimeStretcherSynthesis
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSuite::testTimeStretcherSynthesis()
+{
+   Logger msg( "testTimeStretcherSynthesis" );
+   msg << Msg::Info << "Running testTimeStretcherSynthesis..." << Msg::EndReq;
+
+   SamplingInfo samplingInfo( 44100 );
+   WaveAnalysis::FourierConfig fourierConfig( samplingInfo, 2048 );
+   const size_t numSamples = 40000;
+
+   /// Partials from close to zero to close to the Nyquist frequency, starting at different times.
+   std::vector< double > frequencies = { 30, 440, 1234.5, 5000, 21000 };
+   std::vector< Feature::SrSpecPeak* > peaks;
+   std::vector< Feature::SustainedPeak* > sustainedPeaks;
+   for ( size_t iPeak = 0; iPeak < frequencies.size(); ++iPeak )
+   {
+      peaks.push_back( new Feature::SrSpecPeak( frequencies[ iPeak ], 1000 * ( iPeak + 1 ), 0, 1000 + 500 * iPeak, numSamples ) );
+      sustainedPeaks.push_back( new Feature::SustainedPeak( peaks.back() ) );
+      sustainedPeaks.back()->finishBuilding();
+   }
+
+   Music::TimeStretcher sineStretcher( 1, Music::TimeStretcher::SineSynthesis );
+   Music::TimeStretcher fftStretcher( 1, Music::TimeStretcher::InverseFftSynthesis );
+   RawPcmData sineResult = sineStretcher.generateFromSustainedPeaks( sustainedPeaks, fourierConfig, samplingInfo, numSamples );
+   RawPcmData fftResult = fftStretcher.generateFromSustainedPeaks( sustainedPeaks, fourierConfig, samplingInfo, numSamples );
+
+   Utils::cleanupVector( sustainedPeaks );
+   Utils::cleanupVector( peaks );
+
+   if ( sineResult.size() != fftResult.size() )
+   {
+      throw ExceptionTestFailed( "testTimeStretcherSynthesis", "Synthesis modes give different lengths." );
+   }
+
+   /// Compare in the steady state, away from the starts and ends, which are smoothed differently.
+   double maxDiff = 0;
+   double maxAmplitude = 0;
+   for ( size_t iSample = 5000; iSample < numSamples - 2000; ++iSample )
+   {
+      maxDiff = std::max( maxDiff, fabs( sineResult[ iSample ] - fftResult[ iSample ] ) );
+      maxAmplitude = std::max( maxAmplitude, fabs( sineResult[ iSample ] ) );
+   }
+   msg << Msg::Info << "Maximum difference " << maxDiff / maxAmplitude << " relative to the maximum amplitude." << Msg::EndReq;
+
+   /// -80 dB.
+   if ( maxDiff > 1e-4 * maxAmplitude )
+   {
+      throw ExceptionTestFailed( "testTimeStretcherSynthesis", "Inverse FFT synthesis does not reproduce sine synthesis." );
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// testSpectralReassignment
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1288,6 +1909,66 @@ void TestSuite::testMlpGradients()
 
    msg << Msg::Info << "Correct = " << grad << Msg::EndReq;
    msg << Msg::Info << "Test    = " << gradient << Msg::EndReq;
+   for ( size_t i = 0; i < diff.size(); ++i )
+   {
+      if ( fabs( diff[ i ] ) > 1e-5 )
+      {
+         throw ExceptionTestFailed( "testMlpGradients", "Backpropagation gradient differs from numerical gradient." );
+      }
+   }
+
+   /// The batch gradient is the sum of the sample gradients, also for batches larger than the internal chunk size.
+   {
+      std::vector< RealVector > inputs;
+      std::vector< RealVector > targets;
+      std::vector< size_t > batch;
+      for ( size_t i = 0; i < 150; ++i )
+      {
+         inputs.push_back( realVector( sin( 0.1 * i ), cos( 0.3 * i ) ) );
+         targets.push_back( realVector( sin( 0.2 * i ) ) );
+         batch.push_back( ( 7 * i ) % 150 );
+      }
+      RealVector sumGradient( mlp2.getNumWeights(), 0 );
+      double sumError = 0;
+      for ( size_t i = 0; i < batch.size(); ++i )
+      {
+         sumGradient = sumGradient + mlp2.calcErrorAndGradient( inputs[ batch[ i ] ], targets[ batch[ i ] ], error );
+         sumError += error;
+      }
+      RealVector batchErrors;
+      const RealVector& batchGradient = mlp2.calcBatchErrorAndGradient( inputs, targets, batch, batchErrors );
+      double batchError = sumElements( batchErrors );
+      for ( size_t i = 0; i < sumGradient.size(); ++i )
+      {
+         if ( fabs( batchGradient[ i ] - sumGradient[ i ] ) > 1e-10 || fabs( batchError - sumError ) > 1e-10 )
+         {
+            throw ExceptionTestFailed( "testMlpGradients", "Batch gradient differs from sum of sample gradients." );
+         }
+      }
+
+      /// Data-parallel training is reproducible and agrees with single-threaded training up to rounding.
+      std::vector< RealVector > trainedWeights;
+      const size_t numThreads[] = { 1, 3, 3 };
+      for ( size_t iRun = 0; iRun < 3; ++iRun )
+      {
+         Mva::MultiLayerPerceptron mlp( mlp2 );
+         Mva::StochasticGradDescMlpTrainer trainer( mlp );
+         trainer.setInputData( inputs, targets );
+         trainer.setEta( 0.01 );
+         trainer.setBatchSize( 40, 5 );
+         trainer.setNumIterations( 4 );
+         trainer.setNumThreads( numThreads[ iRun ] );
+         trainer.train();
+         trainedWeights.push_back( mlp.getWeights() );
+      }
+      for ( size_t i = 0; i < trainedWeights[ 0 ].size(); ++i )
+      {
+         if ( trainedWeights[ 1 ][ i ] != trainedWeights[ 2 ][ i ] || fabs( trainedWeights[ 1 ][ i ] - trainedWeights[ 0 ][ i ] ) > 1e-10 )
+         {
+            throw ExceptionTestFailed( "testMlpGradients", "Multi-threaded training differs from single-threaded training." );
+         }
+      }
+   }
 
    std::vector< RealVector > inputData;
    std::vector< RealVector > outputData;
@@ -1316,6 +1997,59 @@ void TestSuite::testMlpGradients()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// testFrozenMlp
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TestSuite::testFrozenMlp()
+{
+   Logger msg( "testFrozenMlp" );
+   msg << Msg::Info << "In testFrozenMlp..." << Msg::EndReq;
+
+   std::vector< size_t > hiddenLayers;
+   hiddenLayers.push_back( 7 );
+   hiddenLayers.push_back( 5 );
+
+   for ( size_t iBias = 0; iBias < 2; ++iBias )
+   {
+      Mva::MultiLayerPerceptron mlp( 3, 2, hiddenLayers, iBias == 1 );
+      mlp.randomiseWeights( Interval( -1, 1 ), 5 );
+      const Mva::FrozenMlp< double > frozen( mlp );
+      const Mva::FrozenMlp< float > frozenFloat( mlp );
+
+      /// Batch of 40 samples, more than one block.
+      const size_t numSamples = 40;
+      RealVector inputs;
+      for ( size_t i = 0; i < numSamples; ++i )
+      {
+         inputs.push_back( sin( 0.3 * i ) );
+         inputs.push_back( cos( 0.7 * i ) );
+         inputs.push_back( 0.05 * i );
+      }
+      RealVector outputs( 2 * numSamples );
+      RealVector outputsFloat( 2 * numSamples );
+      frozen.evaluateBatch( inputs.data(), numSamples, outputs.data() );
+      frozenFloat.evaluateBatch( inputs.data(), numSamples, outputsFloat.data() );
+
+      for ( size_t i = 0; i < numSamples; ++i )
+      {
+         const RealVector input( inputs.begin() + 3 * i, inputs.begin() + 3 * i + 3 );
+         const RealVector expected = mlp.evaluate( input );
+         const RealVector single = frozen.evaluate( input );
+         for ( size_t j = 0; j < 2; ++j )
+         {
+            if ( fabs( outputs[ 2 * i + j ] - expected[ j ] ) > 1e-12 || single[ j ] != outputs[ 2 * i + j ] )
+            {
+               throw ExceptionTestFailed( "testFrozenMlp", "Frozen MLP response differs from MLP response." );
+            }
+            if ( fabs( outputsFloat[ 2 * i + j ] - expected[ j ] ) > 1e-5 )
+            {
+               throw ExceptionTestFailed( "testFrozenMlp", "Single precision frozen MLP response differs from MLP response." );
+            }
+         }
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// testMultiLayerPerceptron
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -40,6 +40,7 @@ class TestSuite
        * Development algorithms (try-out area)
        */
       static void testEffectTrianglizer();
+      static void testEffectTrianglizerStream();
       static void testPartialIntegralTransform();
 
       /**
@@ -50,6 +51,11 @@ class TestSuite
       static void testNoiseGenerator();
       static void testTriangleGenerator();
       static void testSawtoothGenerator();
+      static void testOscillatorBank();
+      static void testBandLimitedWavetable();
+      static void testGeneratorRender();
+      static void testPolyphonicSynthesizer();
+      static void testRealTimeRenderer();
       static void testEnvelope();
       static void testRandomMusic();
 
@@ -60,6 +66,8 @@ class TestSuite
       static void testAdvancedFourier();
       static void testStftAlgorithm();
       static void testSpectralReassignment();
+      static void testPhaseVocoder();
+      static void testTimeStretcherSynthesis();
 
       /**
        * FFTW algorithms
@@ -71,11 +79,14 @@ class TestSuite
        */
       static void testPeakDetection();
       static void testSrSpecPeakAlgorithm();
+      static void testPitchSalienceAlgorithm();
+      static void testGroundToneLikelihood();
 
       /**
        * Multi Variate Analysis algorithms
        */
       static void testMlpGradients();
+      static void testFrozenMlp();
       static void testMultiLayerPerceptron();
 
       /**
@@ -1,22 +1,103 @@
 #include "TimeStretcher.h"
 
+#include "FftwAlgorithm.h"
 #include "IPlotFactory.h"
 #include "Logger.h"
 #include "PeakSustainAlgorithm.h"
+#include "PhaseVocoder.h"
 #include "RebinnedSRGraph.h"
 #include "SpectralReassignmentTransform.h"
 #include "SrSpecPeakAlgorithm.h"
 #include "Utils.h"
 
+#include <algorithm>
+#include <cmath>
+
+/// Anonymous namespace
+namespace
+{
+
+/**
+ * @class WindowKernel
+ * @brief Fourier transform R( delta ) = sum_m w( N/2 + m ) exp( -2 pi i delta m / N ) of a (periodic) 4-term
+ * Blackman-Harris window of N samples around its centre, as function of the offset delta in bins. Tabulated with
+ * @param oversampling points per bin up to the half width of the kernel and linearly interpolated.
+ * The side lobes are below -92 dB, so the kernel can be truncated just outside the main lobe (4 bins). Shifted copies
+ * of the window add up to a constant for hops of N / 4.
+ */
+class WindowKernel
+{
+   public:
+      WindowKernel( size_t fourierSize, size_t halfWidth, size_t oversampling ) :
+         m_oversampling( oversampling ),
+         m_table( ( halfWidth + 1 ) * oversampling + 1 ),
+         m_windowSum( 0 )
+      {
+         const int halfSize = fourierSize / 2;
+         RealVector window( fourierSize );
+         for ( int m = -halfSize; m < halfSize; ++m )
+         {
+            const double arg = 2 * M_PI * m / fourierSize;
+            window[ m + halfSize ] = 0.35875 + 0.48829 * cos( arg ) + 0.14128 * cos( 2 * arg ) + 0.01168 * cos( 3 * arg );
+            m_windowSum += window[ m + halfSize ];
+         }
+         for ( size_t i = 0; i < m_table.size(); ++i )
+         {
+            double delta = static_cast< double >( i ) / oversampling;
+            Complex sum = 0;
+            for ( int m = -halfSize; m < halfSize; ++m )
+            {
+               sum += window[ m + halfSize ] * std::polar( 1.0, -2 * M_PI * delta * m / fourierSize );
+            }
+            m_table[ i ] = sum;
+         }
+      }
+
+      /**
+       * Get the kernel at offset @param delta, which should be within the half width.
+       */
+      Complex operator()( double delta ) const
+      {
+         double pos = fabs( delta ) * m_oversampling;
+         size_t index = static_cast< size_t >( pos );
+         double frac = pos - index;
+         Complex result = m_table[ index ] * ( 1 - frac ) + m_table[ index + 1 ] * frac;
+         return delta < 0 ? std::conj( result ) : result;
+      }
+
+      /**
+       * Get the sum of the window samples.
+       */
+      double getWindowSum() const
+      {
+         return m_windowSum;
+      }
+
+   private:
+      size_t         m_oversampling;
+      ComplexVector  m_table;
+      double         m_windowSum;
+};
+
+} /// anonymous namespace
+
 namespace Music {
 
-TimeStretcher::TimeStretcher( double stretchFactor, const std::string& name, const AlgorithmBase* parent ) :
+TimeStretcher::TimeStretcher( double stretchFactor, SynthesisMode synthesisMode, const std::string& name, const AlgorithmBase* parent ) :
    AlgorithmBase( name, parent ),
-   m_stretchFactor( stretchFactor )
+   m_stretchFactor( stretchFactor ),
+   m_synthesisMode( synthesisMode ),
+   m_synthesisFourierSize( 1024 ),
+   m_kernelHalfWidth( 6 )
 {}
 
 RawPcmData TimeStretcher::execute( const RawPcmData& input )
 {
+   if ( m_synthesisMode == PhaseVocoderSynthesis )
+   {
+      return executePhaseVocoder( input );
+   }
+
    size_t fourierSize = 2048;
    size_t nZeroPad = 3;
    WaveAnalysis::SpectralReassignmentTransform transform( input.getSamplingInfo(), fourierSize, nZeroPad * fourierSize, 1 );
@@ -112,6 +193,12 @@ RawPcmData TimeStretcher::generateFromSustainedPeaks( const std::vector< Feature
    double normFactor = 1 / sqrt( fourierConfig.getWindowSize() );
    normFactor = normFactor * normFactor / windowFunctionIntegral / 2;
 
+   if ( m_synthesisMode == InverseFftSynthesis )
+   {
+      synthesiseInverseFft( sustainedPeaks, normFactor, result );
+      return result;
+   }
+
    size_t decayLength = 256;
 
    for ( size_t iPeak = 0; iPeak < sustainedPeaks.size(); ++iPeak )
@@ -143,7 +230,124 @@ RawPcmData TimeStretcher::generateFromSustainedPeaks( const std::vector< Feature
    return result;
 }
 
+RawPcmData TimeStretcher::executePhaseVocoder( const RawPcmData& input ) const
+{
+   PhaseVocoder vocoder( m_stretchFactor, input.getSamplingInfo() );
+   RealVector output( static_cast< size_t >( floor( input.size() * m_stretchFactor + 0.5 ) ) );
 
+   /// Stream the input through the vocoder in blocks, as a live caller would.
+   const size_t blockSize = 1024;
+   size_t numRead = 0;
+   for ( size_t iFirst = 0; iFirst < input.size(); iFirst += blockSize )
+   {
+      vocoder.write( &input[ iFirst ], std::min( blockSize, input.size() - iFirst ) );
+      numRead += vocoder.read( output.data() + numRead, output.size() - numRead );
+   }
+   vocoder.finish();
+   vocoder.read( output.data() + numRead, output.size() - numRead );
+
+   return RawPcmData( input.getSamplingInfo(), output.data(), output.data() + output.size() );
+}
 
+void TimeStretcher::synthesiseInverseFft( const std::vector< Feature::SustainedPeak* >& sustainedPeaks, double normFactor, RawPcmData& result ) const
+{
+   const size_t fourierSize = m_synthesisFourierSize;
+   const size_t hop = fourierSize / 4;
+   const size_t halfSize = fourierSize / 2;
+   const double halfWidth = m_kernelHalfWidth;
+   const SamplingInfo& samplingInfo = result.getSamplingInfo();
+
+   WindowKernel kernel( fourierSize, m_kernelHalfWidth, 256 );
+   WaveAnalysis::FftwAlgorithm fftw( fourierSize );
+   const size_t spectrumDimension = fftw.getSpectrumDimension();
+
+   /// The shifted windows add up to windowSum / hop, the reverse transform is not normalised.
+   const double scale = hop / kernel.getWindowSum() / fourierSize;
+
+   /// Peak parameters in flat arrays, in order of start sample.
+   const size_t numPeaks = sustainedPeaks.size();
+   std::vector< size_t > startSample( numPeaks );
+   std::vector< size_t > endSample( numPeaks );
+   RealVector phaseStep( numPeaks );
+   RealVector binPosition( numPeaks );
+   RealVector amplitude( numPeaks );
+   RealVector phase( numPeaks );
+   for ( size_t iPeak = 0; iPeak < numPeaks; ++iPeak )
+   {
+      const Feature::SustainedPeak& peak = *sustainedPeaks[ iPeak ];
+      startSample[ iPeak ] = m_stretchFactor * peak.getStartTimeSamples();
+      endSample[ iPeak ] = m_stretchFactor * peak.getEndTimeSamples();
+      phaseStep[ iPeak ] = samplingInfo.getPhaseStepPerSample( peak.getFrequency() );
+      binPosition[ iPeak ] = phaseStep[ iPeak ] * fourierSize / ( 2 * M_PI );
+      amplitude[ iPeak ] = peak.getHeight() * normFactor;
+      phase[ iPeak ] = M_PI * ( iPeak % 2 );
+   }
+   std::vector< size_t > startOrder( Utils::createRange( 0, numPeaks ) );
+   std::sort( startOrder.begin(), startOrder.end(), [ &startSample ]( size_t i1, size_t i2 ){ return startSample[ i1 ] < startSample[ i2 ]; } );
+
+   std::vector< size_t > activePeaks;
+   size_t iNextStart = 0;
+   for ( size_t frameCentre = 0; frameCentre < result.size() + halfSize; frameCentre += hop )
+   {
+      /// Update the peaks that are active at the frame centre.
+      while ( iNextStart < numPeaks && startSample[ startOrder[ iNextStart ] ] <= frameCentre )
+      {
+         activePeaks.push_back( startOrder[ iNextStart ] );
+         ++iNextStart;
+      }
+      for ( size_t iActive = 0; iActive < activePeaks.size(); )
+      {
+         if ( endSample[ activePeaks[ iActive ] ] <= frameCentre )
+         {
+            activePeaks[ iActive ] = activePeaks.back();
+            activePeaks.pop_back();
+         }
+         else
+         {
+            ++iActive;
+         }
+      }
+      if ( activePeaks.empty() )
+      {
+         continue;
+      }
+
+      /// Place the spectral kernel of each peak, a * sin( phi ) = a / 2i * ( exp( i phi ) - exp( -i phi ) ), with the
+      /// phase phi at the frame centre. The factor ( -1 )^k moves the window centre to the middle of the frame.
+      Complex* spectrum = fftw.getFourierDataWorkingArray();
+      std::fill( spectrum, spectrum + spectrumDimension, Complex( 0 ) );
+      for ( size_t iActive = 0; iActive < activePeaks.size(); ++iActive )
+      {
+         const size_t iPeak = activePeaks[ iActive ];
+         const double peakPhase = phase[ iPeak ] + ( frameCentre - startSample[ iPeak ] ) * phaseStep[ iPeak ];
+         const Complex coefficient = 0.5 * amplitude[ iPeak ] * Complex( sin( peakPhase ), -cos( peakPhase ) );
+         const double bin = binPosition[ iPeak ];
+
+         size_t kBegin = static_cast< size_t >( std::max( ceil( bin - halfWidth ), 0.0 ) );
+         size_t kEnd = std::min( static_cast< size_t >( floor( bin + halfWidth ) ) + 1, spectrumDimension );
+         for ( size_t k = kBegin; k < kEnd; ++k )
+         {
+            spectrum[ k ] += ( k % 2 == 0 ? 1.0 : -1.0 ) * coefficient * kernel( k - bin );
+         }
+
+         /// Negative frequency image, only relevant close to zero frequency.
+         kEnd = std::min( static_cast< size_t >( std::max( floor( halfWidth - bin ) + 1, 0.0 ) ), spectrumDimension );
+         for ( size_t k = 0; k < kEnd; ++k )
+         {
+            spectrum[ k ] += ( k % 2 == 0 ? 1.0 : -1.0 ) * std::conj( coefficient ) * kernel( k + bin );
+         }
+      }
+      fftw.reverseTransform();
+
+      /// Overlap-add.
+      const double* frame = fftw.getTimeDataWorkingArray();
+      const size_t iFirst = frameCentre < halfSize ? halfSize - frameCentre : 0;
+      const size_t iLast = std::min( fourierSize, result.size() + halfSize - frameCentre );
+      for ( size_t i = iFirst; i < iLast; ++i )
+      {
+         result[ frameCentre - halfSize + i ] += scale * frame[ i ];
+      }
+   }
+}
 
 } /// namespace Music
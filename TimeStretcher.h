@@ -19,7 +19,25 @@ namespace Music
 class TimeStretcher : public AlgorithmBase
 {
    public:
-      TimeStretcher( double stretchFactor, const std::string& name = "TimeStretcher", const AlgorithmBase* parent = 0 );
+      /**
+       * Synthesis methods for the sustained peaks.
+       *  - SineSynthesis: every sustained peak is rendered sample by sample with a sin call. Cost O( numPeaks x duration ).
+       *  - InverseFftSynthesis: every sustained peak is placed as a windowed spectral kernel in the spectra of
+       *    overlapping synthesis frames, which are transformed back with an inverse FFT and overlap-added.
+       *    Cost O( numFrames x ( Fourier size log Fourier size + numActivePeaks x kernel size ) ). Starts and ends of
+       *    the peaks are smoothed over the synthesis window rather than by the linear release of SineSynthesis.
+       *  - PhaseVocoderSynthesis: no sustained-peak analysis; the input is streamed through a PhaseVocoder with identity
+       *    phase locking, in blocks and without plotting. Cost O( numFrames x Fourier size log Fourier size ).
+       */
+      enum SynthesisMode
+      {
+         SineSynthesis = 0,
+         InverseFftSynthesis,
+         PhaseVocoderSynthesis
+      };
+
+   public:
+      TimeStretcher( double stretchFactor, SynthesisMode synthesisMode = SineSynthesis, const std::string& name = "TimeStretcher", const AlgorithmBase* parent = 0 );
 
       RawPcmData execute( const RawPcmData& input );
 
@@ -29,7 +47,20 @@ class TimeStretcher : public AlgorithmBase
                                              size_t originalLength ) const;
 
    private:
-      double      m_stretchFactor;
+      /**
+       * Stretch @param input with a PhaseVocoder (@see SynthesisMode).
+       */
+      RawPcmData executePhaseVocoder( const RawPcmData& input ) const;
+      /**
+       * Add the sustained peaks to @param result with inverse FFT synthesis (@see SynthesisMode).
+       */
+      void synthesiseInverseFft( const std::vector< Feature::SustainedPeak* >& sustainedPeaks, double normFactor, RawPcmData& result ) const;
+
+   private:
+      double         m_stretchFactor;
+      SynthesisMode  m_synthesisMode;           //! Synthesis method for the sustained peaks.
+      size_t         m_synthesisFourierSize;    //! Fourier size of the synthesis frames for InverseFftSynthesis.
+      size_t         m_kernelHalfWidth;         //! Half width in bins of the spectral kernel for InverseFftSynthesis.
 
 };
 
@@ -2,6 +2,7 @@
 
 #include <math.h>
 
+/// Anonymous namespace
 namespace
 {
 
@@ -10,6 +11,18 @@ double sqr( double x )
    return x * x;
 }
 
+Synthesizer::BandLimitedWavetable createWavetable()
+{
+   RealVector amplitudes( Synthesizer::WavetableSynthesizer::getMaxNumHarmonics(), 0 );
+   double mult = 1;
+   for ( size_t iHarmonic = 1; iHarmonic <= amplitudes.size(); iHarmonic += 2 )
+   {
+      amplitudes[ iHarmonic - 1 ] = 8 / sqr( M_PI ) / sqr( iHarmonic ) * mult;
+      mult *= -1;
+   }
+   return Synthesizer::BandLimitedWavetable( amplitudes );
+}
+
 }
 
 namespace Synthesizer
@@ -19,30 +32,16 @@ namespace Synthesizer
 /// constructor
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TriangleGenerator::TriangleGenerator( const SamplingInfo& samplingInfo ) :
-   AdditiveSynthesizer( samplingInfo )
+   WavetableSynthesizer( samplingInfo, getWavetable() )
 {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/// getHarmonicsInfo
+/// getWavetable
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-std::vector< AdditiveSynthesizer::HarmonicInfo > TriangleGenerator::getHarmonicsInfo() const
+const BandLimitedWavetable& TriangleGenerator::getWavetable()
 {
-   size_t iMaxHarmonic = getSamplingInfo().getNyquistFrequency() / getFrequency();
-
-   std::vector< HarmonicInfo > result;
-   double mult = 1;
-   for ( size_t iHarmonic = 1; iHarmonic < iMaxHarmonic; iHarmonic += 2 )
-   {
-      double phaseStep = getSamplingInfo().getPhaseStepPerSample( getFrequency() * iHarmonic );
-      double phase = getPhase() * iHarmonic;
-      double amplitude = 8 / sqr( M_PI ) / sqr( iHarmonic ) * mult;
-      mult *= -1;
-
-      result.push_back( HarmonicInfo( phaseStep, phase, amplitude ) );
-   }
-
-   return result;
+   static const BandLimitedWavetable wavetable( createWavetable() );
+   return wavetable;
 }
 
-
 } /// namespace Synthesizer
@@ -1,7 +1,7 @@
 #ifndef TRIANGLEGENERATOR_H
 #define TRIANGLEGENERATOR_H
 
-#include "AdditiveSynthesizer.h"
+#include "WavetableSynthesizer.h"
 
 namespace Synthesizer
 {
@@ -10,7 +10,7 @@ namespace Synthesizer
  * @class TriangleGenerator
  * @brief Class that generates triangle waves
  */
-class TriangleGenerator : public AdditiveSynthesizer
+class TriangleGenerator : public WavetableSynthesizer
 {
    public:
       /**
@@ -18,11 +18,10 @@ class TriangleGenerator : public AdditiveSynthesizer
        */
       TriangleGenerator( const SamplingInfo& samplingInfo );
 
-   private:
       /**
-       * getHarmonicsInfo (@see AdditiveSynthesizer).
+       * Get the band-limited wavetable shared by all triangle generators. It is built at the first construction.
        */
-      std::vector< HarmonicInfo > getHarmonicsInfo() const;
+      static const BandLimitedWavetable& getWavetable();
 };
 
 } /// namespace Synthesizer
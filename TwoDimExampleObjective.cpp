@@ -13,6 +13,30 @@ double TwoDimExampleObjective::evaluate( const RealVector& x ) const
    return -r2*r2 + r2 + x[0];
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// evaluateBatch
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+RealVector TwoDimExampleObjective::evaluateBatch( const std::vector< RealVector >& xs ) const
+{
+   /// Gather the coordinates, so that the evaluation is a loop over contiguous arrays that the compiler can vectorise.
+   const size_t numPoints = xs.size();
+   RealVector x0( numPoints );
+   RealVector x1( numPoints );
+   for ( size_t i = 0; i < numPoints; ++i )
+   {
+      x0[ i ] = xs[ i ][ 0 ];
+      x1[ i ] = xs[ i ][ 1 ];
+   }
+
+   RealVector result( numPoints );
+   for ( size_t i = 0; i < numPoints; ++i )
+   {
+      double r2 = x0[ i ]*x0[ i ] + x1[ i ]*x1[ i ];
+      result[ i ] = -r2*r2 + r2 + x0[ i ];
+   }
+   return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// getNumParameters
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
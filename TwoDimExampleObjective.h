@@ -16,6 +16,7 @@ class TwoDimExampleObjective : public IObjectiveFunction
    public:
       size_t getNumParameters() const;
       double evaluate( const RealVector& x ) const;
+      RealVector evaluateBatch( const std::vector< RealVector >& xs ) const;
 };
 
 } /// namespace Math
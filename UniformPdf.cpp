@@ -48,6 +48,10 @@ double UniformPdf::getIntegral( double x ) const
    {
       return 0;
    }
+   if ( x > m_max )
+   {
+      return 1;
+   }
    return ( x - m_min ) * m_density;
 }
 
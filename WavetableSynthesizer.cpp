@@ -0,0 +1,43 @@
+#include "WavetableSynthesizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Synthesizer
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+WavetableSynthesizer::WavetableSynthesizer( const SamplingInfo& samplingInfo, const BandLimitedWavetable& wavetable ) :
+   IGenerator( samplingInfo ),
+   m_wavetable( wavetable )
+{}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// render
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void WavetableSynthesizer::render( double* buffer, size_t numSamples )
+{
+   const double phaseStep = getSamplingInfo().getPhaseStepPerSample( getFrequency() );
+   double phase = fmod( getPhase(), 2 * M_PI );
+   for ( size_t iFirst = 0; iFirst < numSamples; iFirst += s_blockSize )
+   {
+      const size_t blockSize = std::min( s_blockSize, numSamples - iFirst );
+      m_wavetable.render( phase, phaseStep, buffer + iFirst, blockSize );
+      phase = fmod( phase + blockSize * phaseStep, 2 * M_PI );
+   }
+   setPhase( phase );
+
+   applyEnvelope( buffer, numSamples );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getMaxNumHarmonics
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t WavetableSynthesizer::getMaxNumHarmonics()
+{
+   return 2048;
+}
+
+} /// namespace Synthesizer
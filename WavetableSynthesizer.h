@@ -0,0 +1,41 @@
+#ifndef WAVETABLESYNTHESIZER_H
+#define WAVETABLESYNTHESIZER_H
+
+#include "BandLimitedWavetable.h"
+#include "IGenerator.h"
+
+namespace Synthesizer
+{
+
+/**
+ * @class WavetableSynthesizer
+ * @brief Base class for generators of fixed waveforms such as sawtooth, triangle and square oscillators.
+ *
+ * The waveform is read from a band-limited wavetable (@see BandLimitedWavetable) that is shared by all generators of
+ * the same type, so the output has no aliasing and the cost per sample does not depend on the frequency.
+ */
+class WavetableSynthesizer : public IGenerator
+{
+   public:
+      /**
+       * Constructor (@see IGenerator). The @param wavetable should outlive the generator.
+       */
+      WavetableSynthesizer( const SamplingInfo& samplingInfo, const BandLimitedWavetable& wavetable );
+      /**
+       * Render the data (@see IGenerator). Do not override this method.
+       */
+      void render( double* buffer, size_t numSamples ) final;
+
+      /**
+       * Number of harmonics in the wavetables of the derived generators. At 44.1 kHz, this only limits the harmonics
+       * of notes below 11 Hz.
+       */
+      static size_t getMaxNumHarmonics();
+
+   private:
+      const BandLimitedWavetable&   m_wavetable;   //! Wavetable of the waveform.
+};
+
+} /// namespace Synthesizer
+
+#endif // WAVETABLESYNTHESIZER_H
@@ -0,0 +1,114 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// constructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+WorkerPool::WorkerPool( size_t numThreads ) :
+   m_task( 0 ),
+   m_numTasks( 0 ),
+   m_nextTask( 0 ),
+   m_numBusy( 0 ),
+   m_generation( 0 ),
+   m_stop( false )
+{
+   for ( size_t i = 1; i < numThreads; ++i )
+   {
+      m_threads.push_back( std::thread( &WorkerPool::workerLoop, this ) );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// destructor
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+WorkerPool::~WorkerPool()
+{
+   {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_stop = true;
+   }
+   m_wakeCondition.notify_all();
+   for ( size_t i = 0; i < m_threads.size(); ++i )
+   {
+      m_threads[ i ].join();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// getNumThreads
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t WorkerPool::getNumThreads() const
+{
+   return m_threads.size() + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// run
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void WorkerPool::run( size_t numTasks, const std::function< void( size_t ) >& task )
+{
+   if ( m_threads.empty() || numTasks <= 1 )
+   {
+      for ( size_t i = 0; i < numTasks; ++i )
+      {
+         task( i );
+      }
+      return;
+   }
+
+   {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_task = &task;
+      m_numTasks = numTasks;
+      m_nextTask = 0;
+      m_numBusy = m_threads.size();
+      ++m_generation;
+   }
+   m_wakeCondition.notify_all();
+
+   executeTasks();
+
+   std::unique_lock< std::mutex > lock( m_mutex );
+   m_doneCondition.wait( lock, [ this ] { return m_numBusy == 0; } );
+   m_task = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// workerLoop
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void WorkerPool::workerLoop()
+{
+   size_t generation = 0;
+   while ( true )
+   {
+      {
+         std::unique_lock< std::mutex > lock( m_mutex );
+         m_wakeCondition.wait( lock, [ this, generation ] { return m_stop || m_generation != generation; } );
+         if ( m_stop )
+         {
+            return;
+         }
+         generation = m_generation;
+      }
+
+      executeTasks();
+
+      std::lock_guard< std::mutex > lock( m_mutex );
+      if ( --m_numBusy == 0 )
+      {
+         m_doneCondition.notify_one();
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// executeTasks
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void WorkerPool::executeTasks()
+{
+   for ( size_t i = m_nextTask++; i < m_numTasks; i = m_nextTask++ )
+   {
+      ( *m_task )( i );
+   }
+}
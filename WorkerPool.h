@@ -0,0 +1,74 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkerPool
+ * @brief Long-lived worker threads that execute indexed tasks in parallel.
+ *
+ * Unlike an IThread, which is started and joined for a single job, the threads of a WorkerPool wait for the next call
+ * of run, so that many small parallel steps (e.g. one per mini-batch) do not pay for creating threads. The calling
+ * thread also executes tasks, so a pool of one thread runs everything on the caller without synchronisation.
+ *
+ * Tasks are picked up in arbitrary order by arbitrary threads; a task that writes only to memory owned by its index gives
+ * results that do not depend on the scheduling.
+ */
+class WorkerPool
+{
+   public:
+      /**
+       * Create a pool that runs tasks on @param numThreads threads, including the calling thread.
+       */
+      WorkerPool( size_t numThreads );
+      /**
+       * Destructor, stops the worker threads.
+       */
+      ~WorkerPool();
+
+      /**
+       * Get the number of threads, including the calling thread.
+       */
+      size_t getNumThreads() const;
+      /**
+       * Call @param task for every index below @param numTasks and return when all calls have finished.
+       */
+      void run( size_t numTasks, const std::function< void( size_t ) >& task );
+
+   private:
+      /**
+       * Main loop of the worker threads.
+       */
+      void workerLoop();
+      /**
+       * Execute tasks of the current run until none are left.
+       */
+      void executeTasks();
+
+   private:
+      std::vector< std::thread >                   m_threads;        //! The worker threads.
+      std::mutex                                   m_mutex;          //! Protects the run administration.
+      std::condition_variable                      m_wakeCondition;  //! Signals a new run or stop to the workers.
+      std::condition_variable                      m_doneCondition;  //! Signals the end of a run to the caller.
+      const std::function< void( size_t ) >*       m_task;           //! Task of the current run.
+      size_t                                       m_numTasks;       //! Number of tasks of the current run.
+      std::atomic< size_t >                        m_nextTask;       //! Index of the next task to execute.
+      size_t                                       m_numBusy;        //! Number of workers that have not finished the run.
+      size_t                                       m_generation;     //! Run counter, wakes the workers.
+      bool                                         m_stop;           //! Signals the workers to stop.
+
+   /**
+    * Blocked copy-constructor and assignment
+    */
+   private:
+      WorkerPool( const WorkerPool& other );
+      WorkerPool& operator=( const WorkerPool& other );
+};
+
+#endif // WORKERPOOL_H
@@ -39,6 +39,7 @@ SOURCES += main.cpp \
     Peak.cpp \
     Tone.cpp \
     FocalTones.cpp \
+    GroundToneLikelihood.cpp \
     IObjectiveFunction.cpp \
     TestMath.cpp \
     TwoDimExampleObjective.cpp \
@@ -151,7 +152,20 @@ SOURCES += main.cpp \
     PeakSustainAlgorithm.cpp \
     WindowLocation.cpp \
     ApproximateGcdAlgorithm.cpp \
-    TimeStretcher.cpp
+    TimeStretcher.cpp \
+    FftConvolution.cpp \
+    PitchSalienceAlgorithm.cpp \
+    OscillatorBank.cpp \
+    BandLimitedWavetable.cpp \
+    WavetableSynthesizer.cpp \
+    PolyphonicSynthesizer.cpp \
+    SpscRingBuffer.cpp \
+    IAudioSink.cpp \
+    RealTimeRenderer.cpp \
+    PhaseVocoder.cpp \
+    WorkerPool.cpp \
+    FrozenMlp.cpp \
+    LevenbergMarquardtOptimiser.cpp
 
 HEADERS += \
     RawPcmData.h \
@@ -186,6 +200,7 @@ HEADERS += \
     Tone.h \
     Typedefs.h \
     FocalTones.h \
+    GroundToneLikelihood.h \
     IObjectiveFunction.h \
     TestMath.h \
     TwoDimExampleObjective.h \
@@ -301,7 +316,22 @@ HEADERS += \
     IndexPair.h \
     WindowLocation.h \
     ApproximateGcdAlgorithm.h \
-    TimeStretcher.h
+    TimeStretcher.h \
+    FftConvolution.h \
+    PitchSalienceAlgorithm.h \
+    OscillatorBank.h \
+    BandLimitedWavetable.h \
+    WavetableSynthesizer.h \
+    PolyphonicSynthesizer.h \
+    SpscRingBuffer.h \
+    IAudioSink.h \
+    RealTimeRenderer.h \
+    PhaseVocoder.h \
+    WorkerPool.h \
+    FrozenMlp.h \
+    Dual.h \
+    AutoDiffFitFunction.h \
+    LevenbergMarquardtOptimiser.h
 
 OTHER_FILES += \
     Todos.txt
@@ -332,3 +362,9 @@ linux: QMAKE_CXXFLAGS += -g -ffast-math -mfpmath=387 -O3
 
 QMAKE_CXXFLAGS += -std=c++11
 
+### Allocation counting for the DevSuite benchmarks (qmake CONFIG+=count_allocations), replaces the global operator new
+count_allocations {
+    SOURCES += AllocationCounter.cpp
+    HEADERS += AllocationCounter.h
+    DEFINES += COUNT_ALLOCATIONS
+}